@@ -0,0 +1,122 @@
+/**
+ * Batch Search - Benchmark
+ *
+ * Measures queries per second of random lookups in sorted integer arrays
+ * from 1 MB up to --max-bytes (default 1 GB):
+ * - per-query: lowerBoundInt once per key
+ * - batch:     batchLowerBoundInt (group prefetching)
+ * - sort+merge: sortIntWide on a copy of the queries (a radix sort for
+ *              these keys), then batchLowerBoundSortedInt; the sort is
+ *              included in the time
+ *
+ * Build and run:
+ *   cc -O2 -o batch_search_bench batch_search_bench.c
+ *   ./batch_search_bench [--max-bytes N] [--queries N]
+ */
+
+#define _DEFAULT_SOURCE
+
+#define SEARCH_NO_MAIN
+#define SORTING_NO_MAIN
+#include "../batch_search.c"
+#include "../../../sorting/c/adaptive_sort.c"
+
+#include <limits.h>
+#include <time.h>
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * xorshift64* generator, so every run sees the same inputs.
+ */
+static uint64_t benchRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+int main(int argc, char* argv[]) {
+    size_t maxBytes = (size_t)1 << 30;
+    size_t queryCount = 4000000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--max-bytes") == 0 && i + 1 < argc) {
+            maxBytes = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--queries") == 0 && i + 1 < argc) {
+            queryCount = (size_t)strtoull(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [--max-bytes N] [--queries N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    int* queries = (int*)malloc(queryCount * sizeof(int));
+    int* sortedQueries = (int*)malloc(queryCount * sizeof(int));
+    size_t* expected = (size_t*)malloc(queryCount * sizeof(size_t));
+    size_t* results = (size_t*)malloc(queryCount * sizeof(size_t));
+    printf("%12s %12s %16s %16s %16s\n", "bytes", "elements", "per-query/s", "batch/s", "sort+merge/s");
+
+    for (size_t bytes = (size_t)1 << 20; bytes <= maxBytes; bytes *= 4) {
+        size_t n = bytes / sizeof(int);
+        int* arr = (int*)malloc(n * sizeof(int));
+        if (arr == NULL) {
+            printf("%12zu: out of memory\n", bytes);
+            break;
+        }
+
+        // Evenly spread keys over the int range; queries hit about half of them
+        uint64_t step = ((uint64_t)UINT_MAX + 1) / n;
+        step = step > 1 ? step : 1;
+        for (size_t i = 0; i < n; i++) {
+            arr[i] = (int)((int64_t)INT_MIN + (int64_t)((uint64_t)i * step));
+        }
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+        for (size_t q = 0; q < queryCount; q++) {
+            uint64_t i = benchRandom(&state) % n;
+            queries[q] = arr[i] + (int)(benchRandom(&state) & (step > 1));
+        }
+
+        double start = nowSeconds();
+        for (size_t q = 0; q < queryCount; q++) {
+            expected[q] = lowerBoundInt(arr, n, queries[q], false);
+        }
+        double single = nowSeconds() - start;
+
+        start = nowSeconds();
+        batchLowerBoundInt(arr, n, queries, queryCount, results, false);
+        double batch = nowSeconds() - start;
+        if (memcmp(results, expected, queryCount * sizeof(size_t)) != 0) {
+            printf("batch mismatch at %zu bytes\n", bytes);
+            return 1;
+        }
+
+        memcpy(sortedQueries, queries, queryCount * sizeof(int));
+        start = nowSeconds();
+        sortIntWide(sortedQueries, queryCount, false);
+        batchLowerBoundSortedInt(arr, n, sortedQueries, queryCount, results, false);
+        double merge = nowSeconds() - start;
+        for (size_t q = 0; q < queryCount; q += queryCount / 100 + 1) {
+            if (results[q] != lowerBoundInt(arr, n, sortedQueries[q], false)) {
+                printf("merge mismatch at %zu bytes\n", bytes);
+                return 1;
+            }
+        }
+
+        printf("%12zu %12zu %16.0f %16.0f %16.0f\n", bytes, n, queryCount / single, queryCount / batch,
+               queryCount / merge);
+        free(arr);
+    }
+
+    free(queries);
+    free(sortedQueries);
+    free(expected);
+    free(results);
+    return 0;
+}
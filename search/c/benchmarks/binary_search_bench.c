@@ -0,0 +1,135 @@
+/**
+ * Binary Search - Benchmark
+ *
+ * Measures lookups per second of random keys in sorted integer arrays from
+ * 1 KB up to --max-bytes (default 1 GB; 16 GB works given enough memory):
+ * - textbook:   binarySearchInt (branchy)
+ * - branchless: lowerBoundInt (conditional moves and prefetching)
+ * - eytzinger:  eytzingerLowerBoundInt on the BFS layout
+ *
+ * Build and run:
+ *   cc -O2 -o binary_search_bench binary_search_bench.c
+ *   ./binary_search_bench [--max-bytes N] [--queries N]
+ */
+
+#define _DEFAULT_SOURCE
+
+#define SEARCH_NO_MAIN
+#include "../binary_search.c"
+
+#include <limits.h>
+#include <time.h>
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * xorshift64* generator, so every run sees the same inputs.
+ */
+static uint64_t benchRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+int main(int argc, char* argv[]) {
+    size_t maxBytes = (size_t)1 << 30;
+    size_t queryCount = 1000000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--max-bytes") == 0 && i + 1 < argc) {
+            maxBytes = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--queries") == 0 && i + 1 < argc) {
+            queryCount = (size_t)strtoull(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [--max-bytes N] [--queries N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    int* queries = (int*)malloc(queryCount * sizeof(int));
+    size_t* expected = (size_t*)malloc(queryCount * sizeof(size_t));
+    printf("%12s %12s %16s %16s %16s\n", "bytes", "elements", "textbook/s", "branchless/s", "eytzinger/s");
+
+    for (size_t bytes = 1024; bytes <= maxBytes; bytes *= 4) {
+        size_t n = bytes / sizeof(int);
+        int* arr = (int*)malloc(n * sizeof(int));
+        if (arr == NULL) {
+            printf("%12zu: out of memory\n", bytes);
+            break;
+        }
+
+        // Evenly spread keys over the int range; queries hit about half of them
+        uint64_t step = ((uint64_t)UINT_MAX + 1) / n;
+        step = step > 1 ? step : 1;
+        for (size_t i = 0; i < n; i++) {
+            arr[i] = (int)((int64_t)INT_MIN + (int64_t)((uint64_t)i * step));
+        }
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+        for (size_t q = 0; q < queryCount; q++) {
+            uint64_t i = benchRandom(&state) % n;
+            queries[q] = arr[i] + (int)(benchRandom(&state) & (step > 1));
+        }
+
+        EytzingerInt tree = EYTZINGER_INIT;
+        bool haveTree = eytzingerBuildInt(&tree, arr, n, false) == 0;
+
+        // Textbook search; the sum of results keeps the loop from being optimized away
+        double start = nowSeconds();
+        size_t found = 0;
+        for (size_t q = 0; q < queryCount; q++) {
+            found += binarySearchInt(arr, n, queries[q], false) != SEARCH_NOT_FOUND;
+        }
+        double textbook = nowSeconds() - start;
+
+        start = nowSeconds();
+        for (size_t q = 0; q < queryCount; q++) {
+            expected[q] = lowerBoundInt(arr, n, queries[q], false);
+        }
+        double branchless = nowSeconds() - start;
+
+        size_t hits = 0;
+        for (size_t q = 0; q < queryCount; q++) {
+            hits += expected[q] < n && arr[expected[q]] == queries[q];
+        }
+
+        double eytzinger = 0;
+        if (haveTree) {
+            size_t* nodes = (size_t*)malloc(queryCount * sizeof(size_t));
+            start = nowSeconds();
+            for (size_t q = 0; q < queryCount; q++) {
+                nodes[q] = eytzingerLowerBoundInt(&tree, queries[q]);
+            }
+            eytzinger = nowSeconds() - start;
+
+            // Spot-check the layout against the branchless results
+            for (size_t q = 0; q < queryCount; q += queryCount / 100 + 1) {
+                if (eytzingerSortedIndex(&tree, nodes[q]) != expected[q]) {
+                    printf("eytzinger mismatch for query %zu\n", q);
+                    return 1;
+                }
+            }
+            free(nodes);
+            eytzingerFreeInt(&tree);
+        }
+
+        if (found != hits) {
+            printf("textbook found %zu keys, branchless %zu\n", found, hits);
+            return 1;
+        }
+
+        printf("%12zu %12zu %16.0f %16.0f %16.0f\n", bytes, n, queryCount / textbook, queryCount / branchless,
+               haveTree ? queryCount / eytzinger : 0.0);
+        free(arr);
+    }
+
+    free(queries);
+    free(expected);
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * Learned Index - Benchmark
+ *
+ * Builds indexes over sorted int64 keys and measures the lookup latency of
+ * random present keys on three key distributions:
+ * - sequential: auto-increment IDs with occasional gaps
+ * - uniform:    uniform random keys
+ * - lognormal:  skewed keys, dense at the low end
+ * The engines are branchless binary search, interpolationSearchInt64 and
+ * radixSplineLowerBoundInt64; RadixSpline also reports its build time and
+ * index size.
+ *
+ * Build and run:
+ *   cc -O2 -o learned_index_bench learned_index_bench.c -lm
+ *   ./learned_index_bench [--n N] [--queries N] [--error E]
+ */
+
+#define _DEFAULT_SOURCE
+
+#define SEARCH_NO_MAIN
+#include "../learned_index.c"
+
+#include <math.h>
+#include <time.h>
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * xorshift64* generator, so every run sees the same inputs.
+ */
+static uint64_t benchRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+/**
+ * Uniform double in [0, 1).
+ */
+static double benchUniform(uint64_t* state) {
+    return (double)(benchRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static int compareInt64(const void* a, const void* b) {
+    int64_t x = *(const int64_t*)a, y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = 50000000;
+    size_t queryCount = 2000000;
+    size_t maxError = LEARNED_INDEX_DEFAULT_ERROR;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--n") == 0 && i + 1 < argc) {
+            n = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--queries") == 0 && i + 1 < argc) {
+            queryCount = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--error") == 0 && i + 1 < argc) {
+            maxError = (size_t)strtoull(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [--n N] [--queries N] [--error E]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    int64_t* keys = (int64_t*)malloc(n * sizeof(int64_t));
+    int64_t* queries = (int64_t*)malloc(queryCount * sizeof(int64_t));
+    size_t* expected = (size_t*)malloc(queryCount * sizeof(size_t));
+    const char* names[] = {"sequential", "uniform", "lognormal"};
+
+    printf("%zu keys, %zu queries, RadixSpline error %zu\n", n, queryCount, maxError);
+    printf("%12s %12s %12s %12s %10s %10s %12s\n", "keys", "binary ns", "interp ns", "spline ns", "build ms",
+           "points", "index bytes");
+    for (int d = 0; d < 3; d++) {
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+        int64_t id = 1;
+        for (size_t i = 0; i < n; i++) {
+            if (d == 0) {
+                id += benchRandom(&state) % 1000 == 0 ? 1 + benchRandom(&state) % 100 : 1;
+                keys[i] = id;
+            } else if (d == 1) {
+                keys[i] = (int64_t)(benchRandom(&state) >> 1);
+            } else {
+                // exp(N(0, 2)) via Box-Muller, scaled to the int64 range
+                double u = benchUniform(&state) + 1e-300, v = benchUniform(&state);
+                double z = sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+                keys[i] = (int64_t)fmin(exp(2 * z) * 1e12, 9e18);
+            }
+        }
+        if (d > 0) {
+            qsort(keys, n, sizeof(int64_t), compareInt64);
+        }
+        for (size_t q = 0; q < queryCount; q++) {
+            queries[q] = keys[benchRandom(&state) % n];
+        }
+
+        double start = nowSeconds();
+        for (size_t q = 0; q < queryCount; q++) {
+            expected[q] = learnedLowerBoundInt64(keys, n, queries[q]);
+        }
+        double binary = nowSeconds() - start;
+
+        size_t mismatches = 0;
+        start = nowSeconds();
+        for (size_t q = 0; q < queryCount; q++) {
+            mismatches += interpolationSearchInt64(keys, n, queries[q]) != expected[q];
+        }
+        double interpolation = nowSeconds() - start;
+
+        RadixSplineInt64 rs;
+        start = nowSeconds();
+        if (radixSplineBuildInt64(&rs, keys, n, maxError) != 0) {
+            perror("radixSplineBuildInt64");
+            return 1;
+        }
+        double build = nowSeconds() - start;
+        start = nowSeconds();
+        for (size_t q = 0; q < queryCount; q++) {
+            mismatches += radixSplineLowerBoundInt64(&rs, queries[q]) != expected[q];
+        }
+        double spline = nowSeconds() - start;
+
+        if (mismatches != 0) {
+            printf("%s: %zu mismatches\n", names[d], mismatches);
+            return 1;
+        }
+        printf("%12s %12.1f %12.1f %12.1f %10.1f %10zu %12zu\n", names[d], binary / queryCount * 1e9,
+               interpolation / queryCount * 1e9, spline / queryCount * 1e9, build * 1e3, rs.pointCount,
+               radixSplineIndexBytes(&rs));
+        radixSplineFreeInt64(&rs);
+    }
+
+    free(keys);
+    free(queries);
+    free(expected);
+    return 0;
+}
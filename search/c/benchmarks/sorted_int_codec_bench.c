@@ -0,0 +1,269 @@
+/**
+ * Sorted Integer Codec - Benchmark
+ *
+ * Compresses sorted arrays from radixSortWide (32-bit) and generated
+ * timestamps (64-bit) and reports for each:
+ * - bits/value and ratio:  size of the codec (encoded form plus skip index)
+ *                          against the uncompressed array
+ * - encode GB/s:           uncompressed bytes encoded per second
+ * - decode GB/s:           uncompressed bytes decoded per second with the
+ *                          scalar and with the SSE2 decoder
+ * - lookups/s:             lower bounds of random keys on the uncompressed
+ *                          array (branchless binary search) and directly on
+ *                          the compressed blocks
+ *
+ * Data sets:
+ * - dense:      n random keys below 8n, gaps of about 8
+ * - sparse:     n random keys over the whole int range
+ * - clustered:  runs of consecutive ids with a random jump after 1% of them
+ * - timestamps: 64-bit microsecond times, gaps below 2 ms and 0.1% of them
+ *               up to about 17 minutes
+ *
+ * Build and run:
+ *   cc -O2 -o sorted_int_codec_bench sorted_int_codec_bench.c
+ *   ./sorted_int_codec_bench [--n N] [--queries N]
+ */
+
+#define _DEFAULT_SOURCE
+
+#define SEARCH_NO_MAIN
+#define SORTING_NO_MAIN
+#include "../sorted_int_codec.c"
+#include "../../../sorting/c/radix_sort.c"
+
+#include <time.h>
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * xorshift64* generator, so every run sees the same inputs.
+ */
+static uint64_t benchRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+/**
+ * Branchless lower bound over an ascending 64-bit array, the counterpart
+ * of lowerBoundInt.
+ */
+static size_t benchLowerBoundInt64(const int64_t arr[], size_t n, int64_t key) {
+    if (n == 0) {
+        return 0;
+    }
+    const int64_t* base = arr;
+    size_t len = n;
+    while (len > 1) {
+        size_t half = len / 2;
+        __builtin_prefetch(base + half / 2);
+        __builtin_prefetch(base + half + half / 2);
+        base = base[half] < key ? base + half : base;
+        len -= half;
+    }
+    return (size_t)(base - arr) + (*base < key);
+}
+
+/**
+ * Results of one data set.
+ */
+typedef struct {
+    double bitsPerValue;
+    double encode;     // Seconds
+    double decode[2];  // Seconds, scalar and SSE2
+    double rawSearch;  // Seconds for all queries
+    double codecSearch;
+} BenchResult;
+
+/**
+ * Best of three timings of a full decode.
+ */
+#define BENCH_DECODE(seconds, decodeCall)        \
+    do {                                         \
+        seconds = 1e30;                          \
+        for (int rep = 0; rep < 3; rep++) {      \
+            double start = nowSeconds();         \
+            decodeCall;                          \
+            double t = nowSeconds() - start;     \
+            seconds = t < seconds ? t : seconds; \
+        }                                        \
+    } while (0)
+
+static bool benchInt(const int32_t sorted[], size_t n, const int32_t queries[], size_t queryCount,
+                     BenchResult* result) {
+    SortedCodecInt codec;
+    double start = nowSeconds();
+    if (sortedCodecEncodeInt(&codec, sorted, n, SORTED_CODEC_SSE2) != 0) {
+        perror("sortedCodecEncodeInt");
+        return false;
+    }
+    result->encode = nowSeconds() - start;
+    result->bitsPerValue = 8.0 * sortedCodecBytesInt(&codec) / n;
+
+    int32_t* decoded = (int32_t*)malloc(n * sizeof(int32_t));
+    memset(decoded, 0, n * sizeof(int32_t));
+    for (int isa = SORTED_CODEC_SCALAR; isa <= SORTED_CODEC_SSE2; isa++) {
+        codec.blocks.isa = sortedCodecDetect((SortedCodecIsa)isa);
+        BENCH_DECODE(result->decode[isa], sortedCodecDecodeInt(&codec, decoded));
+        if (memcmp(decoded, sorted, n * sizeof(int32_t)) != 0) {
+            printf("%s decode differs from the input\n", sortedCodecIsaName(codec.blocks.isa));
+            return false;
+        }
+    }
+    free(decoded);
+
+    size_t* expected = (size_t*)malloc(queryCount * sizeof(size_t));
+    start = nowSeconds();
+    for (size_t q = 0; q < queryCount; q++) {
+        expected[q] = lowerBoundInt(sorted, n, queries[q], false);
+    }
+    result->rawSearch = nowSeconds() - start;
+    bool same = true;
+    start = nowSeconds();
+    for (size_t q = 0; q < queryCount; q++) {
+        same &= sortedCodecLowerBoundInt(&codec, queries[q]) == expected[q];
+    }
+    result->codecSearch = nowSeconds() - start;
+    free(expected);
+    sortedCodecFreeInt(&codec);
+    if (!same) {
+        printf("compressed lower bound differs\n");
+    }
+    return same;
+}
+
+static bool benchInt64(const int64_t sorted[], size_t n, const int64_t queries[], size_t queryCount,
+                       BenchResult* result) {
+    SortedCodecInt64 codec;
+    double start = nowSeconds();
+    if (sortedCodecEncodeInt64(&codec, sorted, n, SORTED_CODEC_SSE2) != 0) {
+        perror("sortedCodecEncodeInt64");
+        return false;
+    }
+    result->encode = nowSeconds() - start;
+    result->bitsPerValue = 8.0 * sortedCodecBytesInt64(&codec) / n;
+
+    int64_t* decoded = (int64_t*)malloc(n * sizeof(int64_t));
+    memset(decoded, 0, n * sizeof(int64_t));
+    for (int isa = SORTED_CODEC_SCALAR; isa <= SORTED_CODEC_SSE2; isa++) {
+        codec.blocks.isa = sortedCodecDetect((SortedCodecIsa)isa);
+        BENCH_DECODE(result->decode[isa], sortedCodecDecodeInt64(&codec, decoded));
+        if (memcmp(decoded, sorted, n * sizeof(int64_t)) != 0) {
+            printf("%s decode differs from the input\n", sortedCodecIsaName(codec.blocks.isa));
+            return false;
+        }
+    }
+    free(decoded);
+
+    size_t* expected = (size_t*)malloc(queryCount * sizeof(size_t));
+    start = nowSeconds();
+    for (size_t q = 0; q < queryCount; q++) {
+        expected[q] = benchLowerBoundInt64(sorted, n, queries[q]);
+    }
+    result->rawSearch = nowSeconds() - start;
+    bool same = true;
+    start = nowSeconds();
+    for (size_t q = 0; q < queryCount; q++) {
+        same &= sortedCodecLowerBoundInt64(&codec, queries[q]) == expected[q];
+    }
+    result->codecSearch = nowSeconds() - start;
+    free(expected);
+    sortedCodecFreeInt64(&codec);
+    if (!same) {
+        printf("compressed lower bound differs\n");
+    }
+    return same;
+}
+
+static void benchPrint(const char* name, size_t width, size_t n, size_t queryCount, const BenchResult* r) {
+    double bytes = (double)n * width;
+    printf("%12s %10.2f %8.1fx %12.2f %12.2f %12.2f %14.0f %14.0f\n", name, r->bitsPerValue,
+           8.0 * width / r->bitsPerValue, bytes / r->encode / 1e9, bytes / r->decode[0] / 1e9,
+           bytes / r->decode[1] / 1e9, queryCount / r->rawSearch, queryCount / r->codecSearch);
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = 10000000;
+    size_t queryCount = 1000000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--n") == 0 && i + 1 < argc) {
+            n = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--queries") == 0 && i + 1 < argc) {
+            queryCount = (size_t)strtoull(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [--n N] [--queries N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n == 0 || n > INT_MAX / 8) {
+        fprintf(stderr, "n must be between 1 and %d\n", INT_MAX / 8);
+        return 1;
+    }
+
+    int32_t* keys = (int32_t*)malloc(n * sizeof(int32_t));
+    int32_t* queries = (int32_t*)malloc(queryCount * sizeof(int32_t));
+    int64_t* times = (int64_t*)malloc(n * sizeof(int64_t));
+    int64_t* timeQueries = (int64_t*)malloc(queryCount * sizeof(int64_t));
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    BenchResult result;
+
+    printf("%zu values, %zu queries, SSE2 decoder: %s\n", n, queryCount,
+           sortedCodecDetect(SORTED_CODEC_SSE2) == SORTED_CODEC_SSE2 ? "yes" : "no");
+    printf("%12s %10s %9s %12s %12s %12s %14s %14s\n", "data", "bits/value", "ratio", "encode GB/s",
+           "scalar GB/s", "sse2 GB/s", "raw lookups/s", "codec lookups/s");
+
+    const char* names[] = {"dense", "sparse", "clustered"};
+    for (int set = 0; set < 3; set++) {
+        int64_t id = 0;
+        for (size_t i = 0; i < n; i++) {
+            uint64_t r = benchRandom(&state);
+            if (set == 0) {
+                keys[i] = (int32_t)(r % (8 * n));
+            } else if (set == 1) {
+                keys[i] = (int32_t)(uint32_t)r;
+            } else {
+                id += r % 100 == 0 ? 1 + (int64_t)((r >> 8) % 100000) : 1;
+                keys[i] = (int32_t)id;
+            }
+        }
+        // Radix sort output, as the codec sees it in practice
+        radixSortWide(keys, n, false);
+        for (size_t q = 0; q < queryCount; q++) {
+            uint64_t r = benchRandom(&state);
+            queries[q] = keys[r % n] + (int32_t)((r >> 40) & 1);
+        }
+        if (!benchInt(keys, n, queries, queryCount, &result)) {
+            return 1;
+        }
+        benchPrint(names[set], sizeof(int32_t), n, queryCount, &result);
+    }
+
+    int64_t t = 1700000000000000ll;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t r = benchRandom(&state);
+        t += r % 1000 == 0 ? (int64_t)((r >> 10) % 1000000000) : (int64_t)((r >> 10) % 2000);
+        times[i] = t;
+    }
+    for (size_t q = 0; q < queryCount; q++) {
+        uint64_t r = benchRandom(&state);
+        timeQueries[q] = times[r % n] + (int64_t)((r >> 40) & 1);
+    }
+    if (!benchInt64(times, n, timeQueries, queryCount, &result)) {
+        return 1;
+    }
+    benchPrint("timestamps", sizeof(int64_t), n, queryCount, &result);
+
+    free(keys);
+    free(queries);
+    free(times);
+    free(timeQueries);
+    return 0;
+}
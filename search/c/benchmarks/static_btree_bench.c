@@ -0,0 +1,131 @@
+/**
+ * Static B-Tree - Benchmark
+ *
+ * Measures lookups per second of random keys in sorted 32-bit integer
+ * arrays from 1 KB up to --max-bytes (default 1 GB):
+ * - branchless: lowerBoundInt from binary_search.c
+ * - eytzinger:  eytzingerLowerBoundInt on the BFS layout
+ * - s-tree:     staticBTreeLowerBoundInt with the best node search the CPU has
+ * and the memory the S-tree index adds, as a percentage of the array.
+ *
+ * Build and run:
+ *   cc -O2 -o static_btree_bench static_btree_bench.c
+ *   ./static_btree_bench [--max-bytes N] [--queries N]
+ */
+
+#define _DEFAULT_SOURCE
+
+#define SEARCH_NO_MAIN
+#include "../binary_search.c"
+#include "../static_btree.c"
+
+#include <time.h>
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * xorshift64* generator, so every run sees the same inputs.
+ */
+static uint64_t benchRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+int main(int argc, char* argv[]) {
+    size_t maxBytes = (size_t)1 << 30;
+    size_t queryCount = 1000000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--max-bytes") == 0 && i + 1 < argc) {
+            maxBytes = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--queries") == 0 && i + 1 < argc) {
+            queryCount = (size_t)strtoull(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [--max-bytes N] [--queries N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    int* queries = (int*)malloc(queryCount * sizeof(int));
+    size_t* expected = (size_t*)malloc(queryCount * sizeof(size_t));
+    size_t* results = (size_t*)malloc(queryCount * sizeof(size_t));
+    printf("%12s %12s %16s %16s %16s %10s\n", "bytes", "elements", "branchless/s", "eytzinger/s", "s-tree/s",
+           "overhead");
+
+    for (size_t bytes = 1024; bytes <= maxBytes; bytes *= 4) {
+        size_t n = bytes / sizeof(int);
+        int* arr = (int*)malloc(n * sizeof(int));
+        if (arr == NULL) {
+            printf("%12zu: out of memory\n", bytes);
+            break;
+        }
+
+        // Evenly spread keys over the int range; queries hit about half of them
+        uint64_t step = ((uint64_t)UINT_MAX + 1) / n;
+        step = step > 1 ? step : 1;
+        for (size_t i = 0; i < n; i++) {
+            arr[i] = (int)((int64_t)INT_MIN + (int64_t)((uint64_t)i * step));
+        }
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+        for (size_t q = 0; q < queryCount; q++) {
+            uint64_t i = benchRandom(&state) % n;
+            queries[q] = arr[i] + (int)(benchRandom(&state) & (step > 1));
+        }
+
+        double start = nowSeconds();
+        for (size_t q = 0; q < queryCount; q++) {
+            expected[q] = lowerBoundInt(arr, n, queries[q], false);
+        }
+        double branchless = nowSeconds() - start;
+
+        double eytzinger = 0;
+        EytzingerInt layout = EYTZINGER_INIT;
+        if (eytzingerBuildInt(&layout, arr, n, false) == 0) {
+            // The sum of node indexes keeps the loop from being optimized away
+            size_t sum = 0;
+            start = nowSeconds();
+            for (size_t q = 0; q < queryCount; q++) {
+                sum += eytzingerLowerBoundInt(&layout, queries[q]);
+            }
+            eytzinger = nowSeconds() - start;
+            results[0] = sum;
+            eytzingerFreeInt(&layout);
+        }
+
+        StaticBTreeInt tree;
+        if (staticBTreeBuildInt(&tree, arr, n, STATIC_BTREE_AVX512) != 0) {
+            printf("%12zu: out of memory\n", bytes);
+            free(arr);
+            break;
+        }
+        start = nowSeconds();
+        for (size_t q = 0; q < queryCount; q++) {
+            results[q] = staticBTreeLowerBoundInt(&tree, queries[q]);
+        }
+        double stree = nowSeconds() - start;
+
+        if (memcmp(results, expected, queryCount * sizeof(size_t)) != 0) {
+            printf("s-tree mismatch at %zu bytes\n", bytes);
+            return 1;
+        }
+
+        printf("%12zu %12zu %16.0f %16.0f %16.0f %9.2f%%\n", bytes, n, queryCount / branchless,
+               eytzinger > 0 ? queryCount / eytzinger : 0.0, queryCount / stree,
+               100.0 * staticBTreeIndexBytesInt(&tree) / bytes);
+        staticBTreeFreeInt(&tree);
+        free(arr);
+    }
+
+    free(queries);
+    free(expected);
+    free(results);
+    return 0;
+}
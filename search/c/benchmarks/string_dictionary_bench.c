@@ -0,0 +1,139 @@
+/**
+ * String Dictionary - Benchmark
+ *
+ * Builds a front-coded dictionary over sorted URL-like paths and compares
+ * its memory and lookup rate with binary search over the char* array:
+ * - memory:  char* array (pointers plus string bytes, malloc overhead not
+ *            counted) against stringDictBytes
+ * - lookup:  random present keys with lowerBoundString and stringDictFind
+ * - prefix:  stringDictPrefixRange on random path prefixes
+ *
+ * Build and run:
+ *   cc -O2 -o string_dictionary_bench string_dictionary_bench.c
+ *   ./string_dictionary_bench [--n N] [--queries N]
+ */
+
+#define _DEFAULT_SOURCE
+
+#define SEARCH_NO_MAIN
+#define SORTING_NO_MAIN
+#include "../string_dictionary.c"
+#include "../../../sorting/c/adaptive_sort.c"
+
+#include <time.h>
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * xorshift64* generator, so every run sees the same inputs.
+ */
+static uint64_t benchRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = 10000000;
+    size_t queryCount = 1000000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--n") == 0 && i + 1 < argc) {
+            n = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--queries") == 0 && i + 1 < argc) {
+            queryCount = (size_t)strtoull(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [--n N] [--queries N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Paths such as /api/v2/users/4711/orders
+    const char* resources[] = {"users", "orders", "products", "sessions", "invoices", "carts", "reviews", "images"};
+    const char* actions[] = {"", "/details", "/history", "/items", "/settings", "/tags"};
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    char** paths = (char**)malloc(n * sizeof(char*));
+    size_t rawBytes = n * sizeof(char*);
+    for (size_t i = 0; i < n; i++) {
+        char path[96];
+        uint64_t r = benchRandom(&state);
+        int length = snprintf(path, sizeof(path), "/api/v%d/%s/%u%s", (int)(r % 3) + 1, resources[(r >> 8) % 8],
+                              (unsigned)((r >> 16) % 10000000), actions[(r >> 48) % 6]);
+        paths[i] = strdup(path);
+        rawBytes += (size_t)length + 1;
+    }
+    sortStringWide(paths, n, false);
+
+    StringDictionary dict;
+    double start = nowSeconds();
+    if (stringDictBuild(&dict, paths, n) != 0) {
+        perror("stringDictBuild");
+        return 1;
+    }
+    double build = nowSeconds() - start;
+    printf("%zu paths: char* array %zu bytes, dictionary %zu bytes (%.2fx smaller), built in %.0f ms\n", n,
+           rawBytes, stringDictBytes(&dict), (double)rawBytes / stringDictBytes(&dict), build * 1e3);
+
+    size_t* picks = (size_t*)malloc(queryCount * sizeof(size_t));
+    for (size_t q = 0; q < queryCount; q++) {
+        picks[q] = benchRandom(&state) % n;
+    }
+
+    size_t sum = 0;
+    start = nowSeconds();
+    for (size_t q = 0; q < queryCount; q++) {
+        sum += lowerBoundString(paths, n, paths[picks[q]], false);
+    }
+    double binary = nowSeconds() - start;
+
+    size_t dictSum = 0;
+    start = nowSeconds();
+    for (size_t q = 0; q < queryCount; q++) {
+        dictSum += stringDictFind(&dict, paths[picks[q]]);
+    }
+    double lookup = nowSeconds() - start;
+    if (sum != dictSum) {
+        printf("lookup mismatch\n");
+        return 1;
+    }
+
+    // Prefixes such as /api/v2/users/4711 (the first four digits of an id)
+    char** prefixes = (char**)malloc(queryCount * sizeof(char*));
+    for (size_t q = 0; q < queryCount; q++) {
+        const char* path = paths[picks[q]];
+        const char* id = strchr(strchr(path + 5, '/') + 1, '/') + 1;
+        size_t length = (size_t)(id - path) + strspn(id, "0123456789");
+        prefixes[q] = strndup(path, length < (size_t)(id - path) + 4 ? length : (size_t)(id - path) + 4);
+    }
+    size_t matches = 0;
+    start = nowSeconds();
+    for (size_t q = 0; q < queryCount; q++) {
+        SearchRange range = stringDictPrefixRange(&dict, prefixes[q]);
+        matches += range.last - range.first;
+    }
+    double prefix = nowSeconds() - start;
+
+    printf("%-28s %14.0f\n", "binary search lookups/s", queryCount / binary);
+    printf("%-28s %14.0f\n", "dictionary lookups/s", queryCount / lookup);
+    printf("%-28s %14.0f (%.1f matches each)\n", "dictionary prefix ranges/s", queryCount / prefix,
+           (double)matches / queryCount);
+
+    stringDictFree(&dict);
+    for (size_t q = 0; q < queryCount; q++) {
+        free(prefixes[q]);
+    }
+    for (size_t i = 0; i < n; i++) {
+        free(paths[i]);
+    }
+    free(prefixes);
+    free(picks);
+    free(paths);
+    return 0;
+}
@@ -0,0 +1,436 @@
+/**
+ * Binary Search - Search Algorithm
+ *
+ * Time Complexity:
+ * - Best case: O(1) for the textbook search (key in the middle), O(log n) for the rest
+ * - Average case: O(log n)
+ * - Worst case: O(log n)
+ *
+ * Space Complexity: O(1); the Eytzinger layout is a copy of n + 1 elements
+ *
+ * How it works:
+ * Binary Search repeatedly halves the range of a sorted array that can
+ * still contain the key. Three variants are provided:
+ * 1. Textbook: compare with the middle element and branch left, right or
+ *    stop. On random keys every branch is a coin flip for the predictor.
+ * 2. Branchless: the range shrinks by half every step whatever the
+ *    comparison says, and the comparison only selects the new base with a
+ *    conditional move. Both possible next midpoints are prefetched.
+ * 3. Eytzinger: the array is rearranged in BFS order of the implicit binary
+ *    search tree (children of node k at 2k and 2k + 1), so the first levels
+ *    share cache lines and the 16 descendants four levels down sit in one
+ *    cache line that is prefetched while the search walks there.
+ *
+ * lowerBound returns the first position whose element does not come before
+ * the key, upperBound the first position whose element comes after it, and
+ * equalRange both. "Before" follows the sort direction, so arrays sorted in
+ * descending order (reverse = true) are searched the same way.
+ */
+
+#ifndef BINARY_SEARCH_C
+#define BINARY_SEARCH_C
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+
+// Returned by binarySearchInt and binarySearchString when the key is missing
+#define SEARCH_NOT_FOUND SIZE_MAX
+
+/**
+ * Half-open range [first, last) of the elements equal to a key.
+ */
+typedef struct {
+    size_t first;
+    size_t last;
+} SearchRange;
+
+/**
+ * Textbook binary search for an integer.
+ *
+ * @param arr Sorted array
+ * @param n Size of the array
+ * @param key Value to search for
+ * @param reverse If true, the array is sorted in descending order
+ * @return Index of an element equal to key, or SEARCH_NOT_FOUND
+ */
+size_t binarySearchInt(const int arr[], size_t n, int key, bool reverse) {
+    size_t low = 0, high = n;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (arr[mid] == key) {
+            return mid;
+        }
+        if (reverse ? arr[mid] > key : arr[mid] < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return SEARCH_NOT_FOUND;
+}
+
+/**
+ * Branchless lower bound of an integer in an ascending array.
+ */
+static size_t lowerBoundAscendingInt(const int arr[], size_t n, int key) {
+    const int* base = arr;
+    size_t len = n;
+    while (len > 1) {
+        size_t half = len / 2;
+        // Prefetch the midpoints of both halves the next step can choose
+        __builtin_prefetch(base + half / 2);
+        __builtin_prefetch(base + half + half / 2);
+        base = base[half] < key ? base + half : base;
+        len -= half;
+    }
+    return (size_t)(base - arr) + (*base < key);
+}
+
+/**
+ * Branchless lower bound of an integer in a descending array.
+ */
+static size_t lowerBoundDescendingInt(const int arr[], size_t n, int key) {
+    const int* base = arr;
+    size_t len = n;
+    while (len > 1) {
+        size_t half = len / 2;
+        __builtin_prefetch(base + half / 2);
+        __builtin_prefetch(base + half + half / 2);
+        base = base[half] > key ? base + half : base;
+        len -= half;
+    }
+    return (size_t)(base - arr) + (*base > key);
+}
+
+/**
+ * Branchless search for the first element that does not come before key.
+ *
+ * @param arr Sorted array
+ * @param n Size of the array
+ * @param key Value to search for
+ * @param reverse If true, the array is sorted in descending order
+ * @return Index of the first element not before key, or n if there is none
+ */
+size_t lowerBoundInt(const int arr[], size_t n, int key, bool reverse) {
+    if (n == 0) {
+        return 0;
+    }
+    return reverse ? lowerBoundDescendingInt(arr, n, key) : lowerBoundAscendingInt(arr, n, key);
+}
+
+/**
+ * Branchless search for the first element that comes after key.
+ *
+ * @param arr Sorted array
+ * @param n Size of the array
+ * @param key Value to search for
+ * @param reverse If true, the array is sorted in descending order
+ * @return Index of the first element after key, or n if there is none
+ */
+size_t upperBoundInt(const int arr[], size_t n, int key, bool reverse) {
+    if (n == 0) {
+        return 0;
+    }
+    const int* base = arr;
+    size_t len = n;
+    if (!reverse) {
+        while (len > 1) {
+            size_t half = len / 2;
+            __builtin_prefetch(base + half / 2);
+            __builtin_prefetch(base + half + half / 2);
+            base = base[half] <= key ? base + half : base;
+            len -= half;
+        }
+        return (size_t)(base - arr) + (*base <= key);
+    }
+    while (len > 1) {
+        size_t half = len / 2;
+        __builtin_prefetch(base + half / 2);
+        __builtin_prefetch(base + half + half / 2);
+        base = base[half] >= key ? base + half : base;
+        len -= half;
+    }
+    return (size_t)(base - arr) + (*base >= key);
+}
+
+/**
+ * Finds the range of elements equal to key.
+ *
+ * @param arr Sorted array
+ * @param n Size of the array
+ * @param key Value to search for
+ * @param reverse If true, the array is sorted in descending order
+ * @return Range [first, last); empty (first == last) if key is missing
+ */
+SearchRange equalRangeInt(const int arr[], size_t n, int key, bool reverse) {
+    SearchRange range;
+    range.first = lowerBoundInt(arr, n, key, reverse);
+    // The upper bound can only lie at or after the lower bound
+    range.last = range.first + upperBoundInt(arr + range.first, n - range.first, key, reverse);
+    return range;
+}
+
+/**
+ * Textbook binary search for a string.
+ *
+ * @param arr Sorted string array
+ * @param n Size of the array
+ * @param key String to search for
+ * @param reverse If true, the array is sorted in descending order
+ * @return Index of an equal string, or SEARCH_NOT_FOUND
+ */
+size_t binarySearchString(char* const arr[], size_t n, const char* key, bool reverse) {
+    size_t low = 0, high = n;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        int cmp = strcmp(arr[mid], key);
+        if (cmp == 0) {
+            return mid;
+        }
+        if (reverse ? cmp > 0 : cmp < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return SEARCH_NOT_FOUND;
+}
+
+/**
+ * Lower bound of a string. The range halves every step like lowerBoundInt;
+ * strcmp itself still branches on the characters.
+ *
+ * @return Index of the first string not before key, or n if there is none
+ */
+size_t lowerBoundString(char* const arr[], size_t n, const char* key, bool reverse) {
+    if (n == 0) {
+        return 0;
+    }
+    char* const* base = arr;
+    size_t len = n;
+    while (len > 1) {
+        size_t half = len / 2;
+        int cmp = strcmp(base[half], key);
+        base = (reverse ? cmp > 0 : cmp < 0) ? base + half : base;
+        len -= half;
+    }
+    int cmp = strcmp(*base, key);
+    return (size_t)(base - arr) + (reverse ? cmp > 0 : cmp < 0);
+}
+
+/**
+ * Upper bound of a string.
+ *
+ * @return Index of the first string after key, or n if there is none
+ */
+size_t upperBoundString(char* const arr[], size_t n, const char* key, bool reverse) {
+    if (n == 0) {
+        return 0;
+    }
+    char* const* base = arr;
+    size_t len = n;
+    while (len > 1) {
+        size_t half = len / 2;
+        int cmp = strcmp(base[half], key);
+        base = (reverse ? cmp >= 0 : cmp <= 0) ? base + half : base;
+        len -= half;
+    }
+    int cmp = strcmp(*base, key);
+    return (size_t)(base - arr) + (reverse ? cmp >= 0 : cmp <= 0);
+}
+
+/**
+ * Finds the range of strings equal to key.
+ */
+SearchRange equalRangeString(char* const arr[], size_t n, const char* key, bool reverse) {
+    SearchRange range;
+    range.first = lowerBoundString(arr, n, key, reverse);
+    range.last = range.first + upperBoundString(arr + range.first, n - range.first, key, reverse);
+    return range;
+}
+
+/**
+ * A sorted integer array in Eytzinger (BFS) order. data[1] is the root and
+ * node k has children 2k and 2k + 1; data[0] is unused.
+ */
+typedef struct {
+    int* data;
+    size_t n;
+    bool reverse;
+} EytzingerInt;
+
+#define EYTZINGER_INIT {NULL, 0, false}
+
+// Ints per cache line: the descendants of k four levels down are data[16k..16k + 15]
+#define EYTZINGER_BLOCK (64 / sizeof(int))
+
+/**
+ * Fills the subtree rooted at k with sorted[i..] in order.
+ *
+ * @return Index of the next unused element of sorted
+ */
+static size_t eytzingerFillInt(int data[], const int sorted[], size_t n, size_t i, size_t k) {
+    if (k <= n) {
+        i = eytzingerFillInt(data, sorted, n, i, 2 * k);
+        data[k] = sorted[i++];
+        i = eytzingerFillInt(data, sorted, n, i, 2 * k + 1);
+    }
+    return i;
+}
+
+/**
+ * Builds the Eytzinger layout of a sorted array. The layout is cache-line
+ * aligned so every prefetched block of descendants is a single line.
+ *
+ * @param tree Layout to fill; free it with eytzingerFreeInt
+ * @param sorted Sorted array
+ * @param n Size of the array
+ * @param reverse If true, the array is sorted in descending order
+ * @return 0 on success, -1 with errno set to ENOMEM on failure
+ */
+int eytzingerBuildInt(EytzingerInt* tree, const int sorted[], size_t n, bool reverse) {
+    size_t bytes = (n + 1) * sizeof(int);
+    bytes = (bytes + 63) / 64 * 64;
+    tree->data = (int*)aligned_alloc(64, bytes);
+    if (tree->data == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    tree->n = n;
+    tree->reverse = reverse;
+    eytzingerFillInt(tree->data, sorted, n, 0, 1);
+    return 0;
+}
+
+/**
+ * Frees an Eytzinger layout.
+ */
+void eytzingerFreeInt(EytzingerInt* tree) {
+    free(tree->data);
+    tree->data = NULL;
+    tree->n = 0;
+}
+
+/**
+ * Branchless lower bound in an Eytzinger layout, prefetching the cache line
+ * of the node four levels below the current one.
+ *
+ * @param tree Eytzinger layout
+ * @param key Value to search for
+ * @return Eytzinger index (1..n) of the first element not before key, or 0 if there is none
+ */
+size_t eytzingerLowerBoundInt(const EytzingerInt* tree, int key) {
+    const int* data = tree->data;
+    size_t n = tree->n;
+    size_t k = 1;
+    if (!tree->reverse) {
+        while (k <= n) {
+            __builtin_prefetch(data + k * EYTZINGER_BLOCK);
+            k = 2 * k + (data[k] < key);
+        }
+    } else {
+        while (k <= n) {
+            __builtin_prefetch(data + k * EYTZINGER_BLOCK);
+            k = 2 * k + (data[k] > key);
+        }
+    }
+    // Every right turn after the last left turn went past the answer: undo them
+    // and the last left turn; k becomes 0 when the search only turned right
+    return k >> (__builtin_ctzll(~(unsigned long long)k) + 1);
+}
+
+/**
+ * Number of nodes in the subtree rooted at k of an n-node Eytzinger layout.
+ */
+static size_t eytzingerSubtreeSize(size_t k, size_t n) {
+    size_t size = 0;
+    for (size_t low = k, high = k; low <= n; low = 2 * low, high = 2 * high + 1) {
+        size += (high < n ? high : n) - low + 1;
+        if (low > n / 2) {
+            break;
+        }
+    }
+    return size;
+}
+
+/**
+ * Converts an Eytzinger index back to the position in the sorted array, so
+ * results can be used with data stored in sorted order. Costs O(log² n):
+ * meant for the final answer of a search, not for the search loop.
+ *
+ * @param tree Eytzinger layout
+ * @param k Eytzinger index (1..n), or 0
+ * @return Position in the sorted array; n for k == 0
+ */
+size_t eytzingerSortedIndex(const EytzingerInt* tree, size_t k) {
+    size_t n = tree->n;
+    if (k == 0) {
+        return n;
+    }
+    // Everything in the left subtree comes before k
+    size_t rank = 2 * k <= n ? eytzingerSubtreeSize(2 * k, n) : 0;
+    // Every ancestor left behind by a right turn comes before k, with its left subtree
+    for (; k > 1; k /= 2) {
+        if (k & 1) {
+            rank += 1 + eytzingerSubtreeSize(k - 1, n);
+        }
+    }
+    return rank;
+}
+
+#ifndef SEARCH_NO_MAIN
+
+/**
+ * Main function with examples.
+ */
+int main() {
+    int arr[] = {2, 3, 5, 5, 5, 8, 13, 21, 34, 55};
+    size_t n = sizeof(arr) / sizeof(arr[0]);
+
+    printf("Array: [");
+    for (size_t i = 0; i < n; i++) {
+        printf("%d%s", arr[i], i + 1 < n ? ", " : "");
+    }
+    printf("]\n");
+
+    printf("binarySearchInt(21) = %zu\n", binarySearchInt(arr, n, 21, false));
+    printf("lowerBoundInt(5) = %zu\n", lowerBoundInt(arr, n, 5, false));
+    printf("upperBoundInt(5) = %zu\n", upperBoundInt(arr, n, 5, false));
+    SearchRange range = equalRangeInt(arr, n, 5, false);
+    printf("equalRangeInt(5) = [%zu, %zu)\n", range.first, range.last);
+    printf("lowerBoundInt(9) = %zu\n", lowerBoundInt(arr, n, 9, false));
+
+    // The same searches through the Eytzinger layout
+    EytzingerInt tree = EYTZINGER_INIT;
+    if (eytzingerBuildInt(&tree, arr, n, false) == 0) {
+        printf("\nEytzinger layout: [");
+        for (size_t k = 1; k <= n; k++) {
+            printf("%d%s", tree.data[k], k < n ? ", " : "");
+        }
+        printf("]\n");
+
+        int keys[] = {5, 9, 55, 56};
+        for (int i = 0; i < 4; i++) {
+            size_t k = eytzingerLowerBoundInt(&tree, keys[i]);
+            printf("eytzingerLowerBoundInt(%d) = node %zu, sorted index %zu\n", keys[i], k,
+                   eytzingerSortedIndex(&tree, k));
+        }
+        eytzingerFreeInt(&tree);
+    }
+
+    // Example with strings
+    char* words[] = {"apple", "banana", "cherry", "date", "fig"};
+    printf("\nbinarySearchString(\"cherry\") = %zu\n", binarySearchString(words, 5, "cherry", false));
+    printf("lowerBoundString(\"coconut\") = %zu\n", lowerBoundString(words, 5, "coconut", false));
+
+    return 0;
+}
+
+#endif /* SEARCH_NO_MAIN */
+
+#endif /* BINARY_SEARCH_C */
@@ -0,0 +1,438 @@
+/**
+ * Learned Index - Search Algorithm
+ *
+ * Time Complexity:
+ * - Interpolation search: O(log log n) on uniform keys, O(log n) worst case
+ * - RadixSpline build: O(n), one pass over the sorted keys
+ * - RadixSpline lookup: O(log s + log e) for s spline points in a radix
+ *   bucket and error bound e; O(1) bucket lookups on smooth key sets
+ *
+ * Space Complexity: O(1) for interpolation search; O(s) spline points plus a
+ * radix table of at most 2^LEARNED_INDEX_RADIX_BITS entries for RadixSpline
+ *
+ * How it works:
+ * A sorted array is a monotonic function from key to position (the CDF of
+ * the keys). Binary search ignores its shape; on keys that are close to
+ * uniform (auto-increment IDs, timestamps) the position can be computed.
+ * 1. Interpolation search guesses the position by linear interpolation
+ *    between the ends of the remaining range, then probes a guard element
+ *    about sqrt(range) further to cut the range down to the guess. If an
+ *    iteration does not halve the range (skewed keys), a bisection step
+ *    follows, so the search is never more than twice as slow as binary search.
+ * 2. RadixSpline learns the CDF once: a greedy pass over the keys picks
+ *    spline points so that linear interpolation between neighbouring points
+ *    is never more than maxError positions off. A radix table indexed by
+ *    the top bits of the key narrows down the spline points to search. A
+ *    lookup interpolates between two spline points and finishes with a
+ *    binary search of 2 * maxError + 1 positions.
+ *
+ * Both work on int64 arrays sorted in ascending order, duplicates allowed,
+ * and return the same position as a lower bound: the first element not
+ * smaller than the key.
+ */
+
+#ifndef LEARNED_INDEX_C
+#define LEARNED_INDEX_C
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+
+// Ranges this small are finished with a branchless binary search
+#define LEARNED_INDEX_SMALL 32
+// Largest radix table: 2^18 entries, as in the RadixSpline paper
+#define LEARNED_INDEX_RADIX_BITS 18
+// Default error bound for radixSplineBuildInt64
+#define LEARNED_INDEX_DEFAULT_ERROR 32
+
+/**
+ * Branchless lower bound of a 64-bit key in an ascending array.
+ */
+static size_t learnedLowerBoundInt64(const int64_t arr[], size_t n, int64_t key) {
+    if (n == 0) {
+        return 0;
+    }
+    const int64_t* base = arr;
+    size_t len = n;
+    while (len > 1) {
+        size_t half = len / 2;
+        base = base[half] < key ? base + half : base;
+        len -= half;
+    }
+    return (size_t)(base - arr) + (*base < key);
+}
+
+/**
+ * Number of significant bits of x (0 for 0).
+ */
+static inline int learnedBitWidth(uint64_t x) {
+    return x == 0 ? 0 : 64 - __builtin_clzll(x);
+}
+
+/**
+ * Interpolation search for the first element not smaller than key.
+ *
+ * @param arr Array sorted in ascending order
+ * @param n Size of the array
+ * @param key Value to search for
+ * @return Index of the first element >= key, or n if there is none
+ */
+size_t interpolationSearchInt64(const int64_t arr[], size_t n, int64_t key) {
+    if (n == 0 || key <= arr[0]) {
+        return 0;
+    }
+    if (key > arr[n - 1]) {
+        return n;
+    }
+
+    // The answer stays in [low, high], with lowKey = arr[low - 1] < key and
+    // highKey = arr[high] >= key remembered from earlier probes, so every
+    // round loads only the elements it probes
+    size_t low = 1, high = n - 1;
+    int64_t lowKey = arr[0], highKey = arr[n - 1];
+    while (high - low > LEARNED_INDEX_SMALL) {
+        size_t width = high - low;
+
+        // Differences as unsigned so the full int64 range cannot overflow
+        double fraction = (double)((uint64_t)key - (uint64_t)lowKey) / (double)((uint64_t)highKey - (uint64_t)lowKey);
+        size_t probe = low - 1 + (size_t)(fraction * (double)(width + 1));
+        probe = probe < low ? low : probe < high ? probe : high - 1;
+
+        // On uniform keys the guess is about sqrt(width) off
+        size_t guard = (size_t)1 << (learnedBitWidth(width) / 2);
+        if (arr[probe] < key) {
+            low = probe + 1;
+            lowKey = arr[probe];
+            if (probe + guard < high) {
+                if (arr[probe + guard] >= key) {
+                    high = probe + guard;
+                    highKey = arr[high];
+                } else {
+                    low = probe + guard + 1;
+                    lowKey = arr[probe + guard];
+                }
+            }
+        } else {
+            high = probe;
+            highKey = arr[probe];
+            if (probe >= low + guard) {
+                if (arr[probe - guard] < key) {
+                    low = probe - guard + 1;
+                    lowKey = arr[probe - guard];
+                } else {
+                    high = probe - guard;
+                    highKey = arr[high];
+                }
+            }
+        }
+
+        // Skewed keys: fall back to bisection for this round
+        if (high - low > width / 2) {
+            size_t mid = low + (high - low) / 2;
+            if (arr[mid] < key) {
+                low = mid + 1;
+                lowKey = arr[mid];
+            } else {
+                high = mid;
+                highKey = arr[mid];
+            }
+        }
+    }
+    return low + learnedLowerBoundInt64(arr + low, high - low, key);
+}
+
+/**
+ * Knot of the spline: the first position of a key.
+ */
+typedef struct {
+    int64_t key;
+    double pos;
+} SplinePoint;
+
+/**
+ * RadixSpline index over a sorted array of 64-bit integers.
+ * The index borrows the sorted array; it must outlive the index and not change.
+ */
+typedef struct {
+    const int64_t* keys;   // The sorted array
+    size_t n;
+    SplinePoint* points;   // Spline points, ascending by key
+    size_t pointCount;
+    size_t* radixTable;    // radixTable[p] = first point whose key prefix is >= p
+    int radixBits;
+    int shift;             // Prefix of a key: (key - minKey) >> shift
+    int64_t minKey;
+    int64_t maxKey;
+    size_t maxError;
+} RadixSplineInt64;
+
+#define RADIX_SPLINE_INIT {NULL, 0, NULL, 0, NULL, 0, 0, 0, 0, 0}
+
+/**
+ * Orientation of (dx2, dy2) relative to (dx1, dy1): > 0 if it turns
+ * clockwise (lies below), < 0 if counter-clockwise (lies above).
+ */
+static inline double splineOrientation(double dx1, double dy1, double dx2, double dy2) {
+    return dy1 * dx2 - dy2 * dx1;
+}
+
+/**
+ * Appends a spline point, growing the array geometrically.
+ *
+ * @return 0 on success, -1 with errno set to ENOMEM on failure
+ */
+static int splinePush(RadixSplineInt64* rs, size_t* capacity, int64_t key, double pos) {
+    if (rs->pointCount == *capacity) {
+        size_t grown = *capacity * 2;
+        SplinePoint* points = (SplinePoint*)realloc(rs->points, grown * sizeof(SplinePoint));
+        if (points == NULL) {
+            errno = ENOMEM;
+            return -1;
+        }
+        rs->points = points;
+        *capacity = grown;
+    }
+    rs->points[rs->pointCount].key = key;
+    rs->points[rs->pointCount].pos = pos;
+    rs->pointCount++;
+    return 0;
+}
+
+/**
+ * Fits the spline with the greedy corridor algorithm: the last spline
+ * point and the tightest upper and lower error limits seen since span a
+ * cone; the first key outside the cone makes the previous key a new point.
+ */
+static int splineFit(RadixSplineInt64* rs, const int64_t sorted[], size_t n, double error) {
+    size_t capacity = 64;
+    rs->points = (SplinePoint*)malloc(capacity * sizeof(SplinePoint));
+    if (rs->points == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    splinePush(rs, &capacity, sorted[0], 0);
+
+    SplinePoint prev = {sorted[0], 0};
+    SplinePoint upperLimit = prev, lowerLimit = prev;
+    bool haveLimits = false;
+
+    for (size_t i = 1; i < n; i++) {
+        int64_t key = sorted[i];
+        if (key == prev.key) {
+            continue;  // Only the first position of a key is modelled
+        }
+        double pos = (double)i;
+        double upper = pos + error;
+        double lower = pos > error ? pos - error : 0;
+
+        if (!haveLimits) {
+            upperLimit = (SplinePoint){key, upper};
+            lowerLimit = (SplinePoint){key, lower};
+            haveLimits = true;
+        } else {
+            // Everything relative to the last spline point; keys as unsigned
+            // differences so the full int64 range cannot overflow
+            const SplinePoint* last = &rs->points[rs->pointCount - 1];
+            double dx = (double)((uint64_t)key - (uint64_t)last->key);
+            double upperDx = (double)((uint64_t)upperLimit.key - (uint64_t)last->key);
+            double upperDy = upperLimit.pos - last->pos;
+            double lowerDx = (double)((uint64_t)lowerLimit.key - (uint64_t)last->key);
+            double lowerDy = lowerLimit.pos - last->pos;
+
+            if (splineOrientation(upperDx, upperDy, dx, pos - last->pos) <= 0 ||
+                splineOrientation(lowerDx, lowerDy, dx, pos - last->pos) >= 0) {
+                // Outside the corridor: the previous key closes the segment
+                if (splinePush(rs, &capacity, prev.key, prev.pos) != 0) {
+                    return -1;
+                }
+                upperLimit = (SplinePoint){key, upper};
+                lowerLimit = (SplinePoint){key, lower};
+            } else {
+                // Inside: tighten the limits this key narrows
+                if (splineOrientation(upperDx, upperDy, dx, upper - last->pos) > 0) {
+                    upperLimit = (SplinePoint){key, upper};
+                }
+                if (splineOrientation(lowerDx, lowerDy, dx, lower - last->pos) < 0) {
+                    lowerLimit = (SplinePoint){key, lower};
+                }
+            }
+        }
+        prev = (SplinePoint){key, pos};
+    }
+
+    if (rs->points[rs->pointCount - 1].key != prev.key) {
+        return splinePush(rs, &capacity, prev.key, prev.pos);
+    }
+    return 0;
+}
+
+/**
+ * Frees the spline and radix table of an index (not the sorted array).
+ */
+void radixSplineFreeInt64(RadixSplineInt64* rs) {
+    free(rs->points);
+    free(rs->radixTable);
+    rs->points = NULL;
+    rs->radixTable = NULL;
+    rs->pointCount = 0;
+}
+
+/**
+ * Builds a RadixSpline over a sorted array in one pass.
+ *
+ * @param rs Index to fill; free it with radixSplineFreeInt64
+ * @param sorted Array sorted in ascending order; borrowed, not copied
+ * @param n Size of the array
+ * @param maxError Largest distance between a predicted and an actual
+ *                 position (LEARNED_INDEX_DEFAULT_ERROR is a good start)
+ * @return 0 on success, -1 with errno set to ENOMEM on failure
+ */
+int radixSplineBuildInt64(RadixSplineInt64* rs, const int64_t sorted[], size_t n, size_t maxError) {
+    *rs = (RadixSplineInt64)RADIX_SPLINE_INIT;
+    rs->keys = sorted;
+    rs->n = n;
+    rs->maxError = maxError;
+    if (n == 0) {
+        return 0;
+    }
+    rs->minKey = sorted[0];
+    rs->maxKey = sorted[n - 1];
+
+    if (splineFit(rs, sorted, n, (double)maxError) != 0) {
+        radixSplineFreeInt64(rs);
+        return -1;
+    }
+
+    // About two table entries per spline point, capped at 2^LEARNED_INDEX_RADIX_BITS
+    int rangeBits = learnedBitWidth((uint64_t)rs->maxKey - (uint64_t)rs->minKey);
+    int bits = learnedBitWidth(rs->pointCount) + 1;
+    bits = bits < LEARNED_INDEX_RADIX_BITS ? bits : LEARNED_INDEX_RADIX_BITS;
+    bits = bits < rangeBits ? bits : rangeBits;
+    rs->radixBits = bits;
+    rs->shift = rangeBits - bits;
+
+    size_t tableSize = ((size_t)1 << bits) + 1;
+    rs->radixTable = (size_t*)malloc(tableSize * sizeof(size_t));
+    if (rs->radixTable == NULL) {
+        radixSplineFreeInt64(rs);
+        errno = ENOMEM;
+        return -1;
+    }
+    size_t point = 0;
+    for (size_t prefix = 0; prefix < tableSize; prefix++) {
+        while (point < rs->pointCount &&
+               (((uint64_t)rs->points[point].key - (uint64_t)rs->minKey) >> rs->shift) < prefix) {
+            point++;
+        }
+        rs->radixTable[prefix] = point;
+    }
+    return 0;
+}
+
+/**
+ * Returns the number of bytes the index adds on top of the sorted array.
+ */
+size_t radixSplineIndexBytes(const RadixSplineInt64* rs) {
+    size_t bytes = sizeof(RadixSplineInt64) + rs->pointCount * sizeof(SplinePoint);
+    if (rs->radixTable != NULL) {
+        bytes += (((size_t)1 << rs->radixBits) + 1) * sizeof(size_t);
+    }
+    return bytes;
+}
+
+/**
+ * Finds the first element not smaller than key.
+ *
+ * @return Index into the sorted array, or n if every key is smaller
+ */
+size_t radixSplineLowerBoundInt64(const RadixSplineInt64* rs, int64_t key) {
+    if (rs->n == 0 || key <= rs->minKey) {
+        return 0;
+    }
+    if (key > rs->maxKey) {
+        return rs->n;
+    }
+
+    // The radix table brackets the first spline point with a key >= key
+    uint64_t prefix = ((uint64_t)key - (uint64_t)rs->minKey) >> rs->shift;
+    size_t begin = rs->radixTable[prefix];
+    size_t end = rs->radixTable[prefix + 1];
+    end = end < rs->pointCount ? end : rs->pointCount - 1;
+    while (begin < end) {
+        size_t mid = begin + (end - begin) / 2;
+        if (rs->points[mid].key < key) {
+            begin = mid + 1;
+        } else {
+            end = mid;
+        }
+    }
+
+    // Interpolate inside the segment that ends at that point
+    const SplinePoint* right = &rs->points[begin];
+    double predicted = right->pos;
+    if (right->key != key) {
+        const SplinePoint* left = right - 1;
+        double dx = (double)((uint64_t)key - (uint64_t)left->key);
+        double width = (double)((uint64_t)right->key - (uint64_t)left->key);
+        predicted = left->pos + dx * (right->pos - left->pos) / width;
+    }
+
+    double error = (double)rs->maxError;
+    size_t low = predicted > error ? (size_t)(predicted - error) : 0;
+    size_t high = (size_t)(predicted + error) + 2;
+    low = low < rs->n ? low : rs->n;
+    high = high < rs->n ? high : rs->n;
+    size_t pos = low + learnedLowerBoundInt64(rs->keys + low, high - low, key);
+
+    // The bound holds for stored keys; a missing key just past a long run of
+    // duplicates, or rounding, can land outside the window
+    if (pos == low && low > 0 && rs->keys[low - 1] >= key) {
+        return learnedLowerBoundInt64(rs->keys, low, key);
+    }
+    if (pos == high && high < rs->n && rs->keys[high] < key) {
+        return high + learnedLowerBoundInt64(rs->keys + high, rs->n - high, key);
+    }
+    return pos;
+}
+
+#ifndef SEARCH_NO_MAIN
+
+/**
+ * Main function with examples.
+ */
+int main() {
+    // Timestamps one second apart with a gap in the middle
+    int64_t keys[1000];
+    for (int i = 0; i < 1000; i++) {
+        keys[i] = 1700000000 + i + (i >= 500 ? 86400 : 0);
+    }
+
+    int64_t queries[] = {0, 1700000000, 1700000499, 1700000500, 1700086900, 1800000000};
+    for (int i = 0; i < 6; i++) {
+        printf("interpolationSearchInt64(%lld) = %zu\n", (long long)queries[i],
+               interpolationSearchInt64(keys, 1000, queries[i]));
+    }
+
+    RadixSplineInt64 rs;
+    if (radixSplineBuildInt64(&rs, keys, 1000, LEARNED_INDEX_DEFAULT_ERROR) != 0) {
+        perror("radixSplineBuildInt64");
+        return 1;
+    }
+    printf("RadixSpline: %zu spline points, %d radix bits, %zu bytes\n", rs.pointCount, rs.radixBits,
+           radixSplineIndexBytes(&rs));
+    for (int i = 0; i < 6; i++) {
+        printf("radixSplineLowerBoundInt64(%lld) = %zu\n", (long long)queries[i],
+               radixSplineLowerBoundInt64(&rs, queries[i]));
+    }
+
+    radixSplineFreeInt64(&rs);
+    return 0;
+}
+
+#endif /* SEARCH_NO_MAIN */
+
+#endif /* LEARNED_INDEX_C */
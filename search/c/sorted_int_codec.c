@@ -0,0 +1,977 @@
+/**
+ * Sorted Integer Codec - Compressed Search Structure
+ *
+ * Time Complexity:
+ * - Encode: O(n)
+ * - Decode: O(n), one block of 128 values at a time
+ * - Random access: O(1) blocks decoded
+ * - Lower bound / find: O(log(n / 128)) skip index probes plus one block decode
+ *
+ * Space Complexity: for every block of 128 values, 12 (32-bit) or 16 (64-bit)
+ * bytes of skip index plus a few header bytes, 16 bytes per bit of the packing width and about
+ * two bytes per exception. Dense sorted data takes a few bits per value
+ * instead of 32 or 64.
+ *
+ * How it works:
+ * Sorted integers such as radix sort output differ little from their
+ * neighbours, so the codec stores the differences (deltas) in as few bits
+ * as they need, in blocks of SORTED_CODEC_BLOCK values (PFOR):
+ * 1. The first value of every block is stored whole and copied into the
+ *    skip index, so a search picks the block with a binary search over the
+ *    first values and decodes only that block
+ * 2. The other values become deltas to their predecessor, and the smallest
+ *    delta of the block is subtracted from all of them (frame of reference)
+ * 3. A bit width b is chosen per block to minimize its size. The low b bits
+ *    of every delta are bit-packed; deltas that need more bits (exceptions)
+ *    also store their position and their high bits as a varint, so a few
+ *    outliers do not widen the whole block
+ * 4. The packed bits use the 4-lane layout of SIMD-BP128: value i is in lane
+ *    i % 4 of 32-bit words, so SSE2 unpacks four values per shift and mask,
+ *    and a prefix sum of four lanes at a time turns the deltas back into
+ *    values
+ *
+ * The encoded form (SortedCodecBlocks.data) is self-contained and can be
+ * stored or sent as is: sortedCodecLoadInt rebuilds the skip index from it.
+ * It uses the byte order of the machine, little-endian on x86-64 and ARM64.
+ * Only ascending arrays are accepted; duplicates are allowed.
+ */
+
+#ifndef SORTED_INT_CODEC_C
+#define SORTED_INT_CODEC_C
+
+#ifndef SEARCH_NO_MAIN
+#define SEARCH_NO_MAIN
+#define SORTED_INT_CODEC_MAIN
+#endif
+#include "binary_search.c"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SORTED_CODEC_X86 1
+#endif
+
+// Values per block; the SIMD layout packs 32 rows of four lanes
+#define SORTED_CODEC_BLOCK 128
+// Value width byte and count in front of the blocks
+#define SORTED_CODEC_HEADER 9
+// Largest block: first value, width, exception count, minimum delta,
+// 32-bit packing, and every value an exception with a 10-byte varint
+#define SORTED_CODEC_MAX_BLOCK (8 + 2 + 10 + 16 * 32 + SORTED_CODEC_BLOCK * 11)
+
+/**
+ * Bit unpacking and prefix sum implementations.
+ */
+typedef enum {
+    SORTED_CODEC_SCALAR,
+    SORTED_CODEC_SSE2,
+} SortedCodecIsa;
+
+/**
+ * Encoded blocks and their positions, shared by both value widths.
+ */
+typedef struct {
+    unsigned char* data;   // Header and blocks: the form to store or send
+    size_t dataSize;
+    size_t* blockOffsets;  // Start of each block in data
+    size_t blockCount;
+    size_t count;          // Number of values
+    SortedCodecIsa isa;    // Decoder picked at encode or load time
+} SortedCodecBlocks;
+
+/**
+ * Compressed sorted array of 32-bit integers.
+ */
+typedef struct {
+    SortedCodecBlocks blocks;
+    int32_t* blockFirst;   // First value of each block: the skip index
+} SortedCodecInt;
+
+/**
+ * Compressed sorted array of 64-bit integers.
+ */
+typedef struct {
+    SortedCodecBlocks blocks;
+    int64_t* blockFirst;
+} SortedCodecInt64;
+
+/**
+ * Writes x as a LEB128 varint.
+ *
+ * @return Number of bytes written (at most 10)
+ */
+static size_t sortedCodecPutVarint(unsigned char* out, uint64_t x) {
+    size_t bytes = 0;
+    while (x >= 0x80) {
+        out[bytes++] = (unsigned char)(x | 0x80);
+        x >>= 7;
+    }
+    out[bytes++] = (unsigned char)x;
+    return bytes;
+}
+
+/**
+ * Reads a LEB128 varint written by sortedCodecPutVarint and advances *in past it.
+ */
+static inline uint64_t sortedCodecGetVarint(const unsigned char** in) {
+    const unsigned char* p = *in;
+    uint64_t x = *p & 0x7F;
+    for (int shift = 7; *p++ & 0x80; shift += 7) {
+        x |= (uint64_t)(*p & 0x7F) << shift;
+    }
+    *in = p;
+    return x;
+}
+
+/**
+ * Reads a varint from untrusted data.
+ *
+ * @return false if it runs past end or is longer than 10 bytes
+ */
+static bool sortedCodecCheckVarint(const unsigned char** in, const unsigned char* end, uint64_t* x) {
+    const unsigned char* p = *in;
+    *x = 0;
+    for (int shift = 0; shift < 70; shift += 7) {
+        if (p >= end) {
+            return false;
+        }
+        *x |= (uint64_t)(*p & 0x7F) << shift;
+        if (!(*p++ & 0x80)) {
+            *in = p;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Number of bits needed for x (0 for 0).
+ */
+static inline unsigned sortedCodecBits(uint64_t x) {
+    return x == 0 ? 0 : 64 - (unsigned)__builtin_clzll(x);
+}
+
+/**
+ * Packs the low b bits of 128 values into 4 * b 32-bit words, value i in
+ * lane i % 4 at bit (i / 4) * b of that lane.
+ */
+static void sortedCodecPackScalar(const uint32_t in[], unsigned b, uint32_t out[]) {
+    memset(out, 0, 16 * b);
+    if (b == 0) {
+        return;
+    }
+    for (unsigned i = 0; i < SORTED_CODEC_BLOCK; i++) {
+        unsigned lane = i & 3, bit = (i >> 2) * b;
+        unsigned word = bit >> 5, shift = bit & 31;
+        out[4 * word + lane] |= in[i] << shift;
+        if (shift + b > 32) {
+            out[4 * (word + 1) + lane] |= in[i] >> (32 - shift);
+        }
+    }
+}
+
+/**
+ * Unpacks 128 values of b bits packed by sortedCodecPackScalar.
+ */
+static void sortedCodecUnpackScalar(const uint32_t in[], unsigned b, uint32_t out[]) {
+    if (b == 0) {
+        memset(out, 0, SORTED_CODEC_BLOCK * sizeof(uint32_t));
+        return;
+    }
+    uint32_t mask = b == 32 ? UINT32_MAX : (1u << b) - 1;
+    for (unsigned i = 0; i < SORTED_CODEC_BLOCK; i++) {
+        unsigned lane = i & 3, bit = (i >> 2) * b;
+        unsigned word = bit >> 5, shift = bit & 31;
+        uint32_t value = in[4 * word + lane] >> shift;
+        if (shift + b > 32) {
+            value |= in[4 * (word + 1) + lane] << (32 - shift);
+        }
+        out[i] = value & mask;
+    }
+}
+
+/**
+ * Turns 128 deltas into values in place: value i is base plus the sum of
+ * deltas 0..i, each increased by min. Unsigned arithmetic wraps, so base is
+ * the first value minus min and delta 0 is 0.
+ */
+static void sortedCodecPrefixScalar32(uint32_t values[], uint32_t base, uint32_t min) {
+    for (unsigned i = 0; i < SORTED_CODEC_BLOCK; i++) {
+        base += values[i] + min;
+        values[i] = base;
+    }
+}
+
+static void sortedCodecPrefixScalar64(uint64_t values[], uint64_t base, uint64_t min) {
+    for (unsigned i = 0; i < SORTED_CODEC_BLOCK; i++) {
+        base += values[i] + min;
+        values[i] = base;
+    }
+}
+
+#ifdef SORTED_CODEC_X86
+
+/**
+ * SSE2 packing: each row of four values is shifted into the current word of
+ * all four lanes at once. Expanded once per width, so the compiler can
+ * unroll the rows with constant shifts.
+ */
+__attribute__((target("sse2"), always_inline)) static inline void sortedCodecPackSse2Width(const uint32_t in[],
+                                                                                          unsigned b,
+                                                                                          __m128i* out) {
+    __m128i acc = _mm_setzero_si128();
+    unsigned word = 0;
+    for (unsigned row = 0; row < 32; row++) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + 4 * row));
+        unsigned shift = (row * b) & 31;
+        acc = _mm_or_si128(acc, _mm_sll_epi32(v, _mm_cvtsi32_si128((int)shift)));
+        if (shift + b >= 32) {
+            _mm_storeu_si128(out + word++, acc);
+            acc = shift + b > 32 ? _mm_srl_epi32(v, _mm_cvtsi32_si128((int)(32 - shift))) : _mm_setzero_si128();
+        }
+    }
+}
+
+/**
+ * SSE2 unpacking: each row of four values is one or two shifts and a mask.
+ */
+__attribute__((target("sse2"), always_inline)) static inline void sortedCodecUnpackSse2Width(const __m128i* in,
+                                                                                            unsigned b,
+                                                                                            uint32_t out[]) {
+    __m128i mask = _mm_set1_epi32(b == 32 ? -1 : (int)((1u << b) - 1));
+    for (unsigned row = 0; row < 32; row++) {
+        unsigned bit = row * b, word = bit >> 5, shift = bit & 31;
+        __m128i v = _mm_srl_epi32(_mm_loadu_si128(in + word), _mm_cvtsi32_si128((int)shift));
+        if (shift + b > 32) {
+            __m128i next = _mm_loadu_si128(in + word + 1);
+            v = _mm_or_si128(v, _mm_sll_epi32(next, _mm_cvtsi32_si128((int)(32 - shift))));
+        }
+        _mm_storeu_si128((__m128i*)(out + 4 * row), _mm_and_si128(v, mask));
+    }
+}
+
+// One case per bit width, so every width gets its own unrolled loop
+#define SORTED_CODEC_WIDTH_CASES(call)                                                                  \
+    case 1: call(1); break;   case 2: call(2); break;   case 3: call(3); break;   case 4: call(4); break;   \
+    case 5: call(5); break;   case 6: call(6); break;   case 7: call(7); break;   case 8: call(8); break;   \
+    case 9: call(9); break;   case 10: call(10); break; case 11: call(11); break; case 12: call(12); break; \
+    case 13: call(13); break; case 14: call(14); break; case 15: call(15); break; case 16: call(16); break; \
+    case 17: call(17); break; case 18: call(18); break; case 19: call(19); break; case 20: call(20); break; \
+    case 21: call(21); break; case 22: call(22); break; case 23: call(23); break; case 24: call(24); break; \
+    case 25: call(25); break; case 26: call(26); break; case 27: call(27); break; case 28: call(28); break; \
+    case 29: call(29); break; case 30: call(30); break; case 31: call(31); break; case 32: call(32); break
+
+__attribute__((target("sse2"))) static void sortedCodecPackSse2(const uint32_t in[], unsigned b, uint32_t out[]) {
+#define SORTED_CODEC_PACK(width) sortedCodecPackSse2Width(in, width, (__m128i*)out)
+    switch (b) {
+        SORTED_CODEC_WIDTH_CASES(SORTED_CODEC_PACK);
+        default:
+            break;
+    }
+#undef SORTED_CODEC_PACK
+}
+
+__attribute__((target("sse2"))) static void sortedCodecUnpackSse2(const uint32_t in[], unsigned b, uint32_t out[]) {
+#define SORTED_CODEC_UNPACK(width) sortedCodecUnpackSse2Width((const __m128i*)in, width, out)
+    switch (b) {
+        SORTED_CODEC_WIDTH_CASES(SORTED_CODEC_UNPACK);
+        default:
+            memset(out, 0, SORTED_CODEC_BLOCK * sizeof(uint32_t));
+            break;
+    }
+#undef SORTED_CODEC_UNPACK
+}
+
+/**
+ * SSE2 prefix sum of four 32-bit deltas at a time: two shifted adds sum
+ * within the vector, and the last lane carries into the next one.
+ */
+__attribute__((target("sse2"))) static void sortedCodecPrefixSse2x32(uint32_t values[], uint32_t base, uint32_t min) {
+    __m128i carry = _mm_set1_epi32((int)base);
+    __m128i offset = _mm_set1_epi32((int)min);
+    for (unsigned i = 0; i < SORTED_CODEC_BLOCK; i += 4) {
+        __m128i x = _mm_add_epi32(_mm_loadu_si128((const __m128i*)(values + i)), offset);
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+        x = _mm_add_epi32(x, carry);
+        _mm_storeu_si128((__m128i*)(values + i), x);
+        carry = _mm_shuffle_epi32(x, 0xFF);
+    }
+}
+
+/**
+ * SSE2 prefix sum of two 64-bit deltas at a time.
+ */
+__attribute__((target("sse2"))) static void sortedCodecPrefixSse2x64(uint64_t values[], uint64_t base, uint64_t min) {
+    __m128i carry = _mm_set1_epi64x((long long)base);
+    __m128i offset = _mm_set1_epi64x((long long)min);
+    for (unsigned i = 0; i < SORTED_CODEC_BLOCK; i += 2) {
+        __m128i x = _mm_add_epi64(_mm_loadu_si128((const __m128i*)(values + i)), offset);
+        x = _mm_add_epi64(x, _mm_slli_si128(x, 8));
+        x = _mm_add_epi64(x, carry);
+        _mm_storeu_si128((__m128i*)(values + i), x);
+        carry = _mm_unpackhi_epi64(x, x);
+    }
+}
+
+#endif /* SORTED_CODEC_X86 */
+
+/**
+ * Returns the best implementation the CPU supports, capped at limit.
+ */
+static SortedCodecIsa sortedCodecDetect(SortedCodecIsa limit) {
+    SortedCodecIsa isa = SORTED_CODEC_SCALAR;
+#ifdef SORTED_CODEC_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        isa = SORTED_CODEC_SSE2;
+    }
+#endif
+    return isa < limit ? isa : limit;
+}
+
+/**
+ * Returns a printable name of an implementation choice.
+ */
+const char* sortedCodecIsaName(SortedCodecIsa isa) {
+    return isa == SORTED_CODEC_SSE2 ? "sse2" : "scalar";
+}
+
+static inline void sortedCodecPack(const uint32_t in[], unsigned b, uint32_t out[], SortedCodecIsa isa) {
+#ifdef SORTED_CODEC_X86
+    if (isa == SORTED_CODEC_SSE2) {
+        sortedCodecPackSse2(in, b, out);
+        return;
+    }
+#endif
+    (void)isa;
+    sortedCodecPackScalar(in, b, out);
+}
+
+static inline void sortedCodecUnpack(const uint32_t in[], unsigned b, uint32_t out[], SortedCodecIsa isa) {
+#ifdef SORTED_CODEC_X86
+    if (isa == SORTED_CODEC_SSE2) {
+        sortedCodecUnpackSse2(in, b, out);
+        return;
+    }
+#endif
+    (void)isa;
+    // The packed words of a block need not be aligned
+    uint32_t words[4 * 32];
+    memcpy(words, in, 16 * b);
+    sortedCodecUnpackScalar(words, b, out);
+}
+
+/**
+ * Encodes one block: its first value, then the header, the packed low bits
+ * and the exceptions.
+ *
+ * @param deltas 128 deltas with the minimum already subtracted; padding is 0
+ * @return Number of bytes written, at most SORTED_CODEC_MAX_BLOCK
+ */
+static size_t sortedCodecEncodeBlock(uint64_t first, size_t width, const uint64_t deltas[], uint64_t min,
+                                     unsigned char* out, SortedCodecIsa isa) {
+    // Size of every width from the histogram of bit lengths: 16 bytes per
+    // packed bit, and per exception a position and the high bits as a
+    // varint, counted at the length of the widest delta
+    unsigned lengths[65] = {0};
+    unsigned maxBits = 0;
+    for (unsigned i = 0; i < SORTED_CODEC_BLOCK; i++) {
+        unsigned bits = sortedCodecBits(deltas[i]);
+        lengths[bits]++;
+        maxBits = bits > maxBits ? bits : maxBits;
+    }
+    unsigned widest = maxBits < 32 ? maxBits : 32;
+    unsigned best = widest;
+    size_t bestSize = SIZE_MAX;
+    size_t exceptions = 0;
+    for (unsigned bits = maxBits; bits > widest; bits--) {
+        exceptions += lengths[bits];
+    }
+    for (unsigned b = widest + 1; b-- > 0;) {
+        size_t size = 16 * (size_t)b + exceptions * (1 + (maxBits - b + 6) / 7);
+        if (size < bestSize) {
+            bestSize = size;
+            best = b;
+        }
+        exceptions += lengths[b];
+    }
+
+    unsigned char* p = out;
+    if (width == 4) {
+        int32_t first32 = (int32_t)first;
+        memcpy(p, &first32, 4);
+    } else {
+        memcpy(p, &first, 8);
+    }
+    p += width;
+    unsigned char* header = p;
+    p += 2;
+    p += sortedCodecPutVarint(p, min);
+
+    uint32_t low[SORTED_CODEC_BLOCK];
+    uint32_t mask = best == 32 ? UINT32_MAX : (1u << best) - 1;
+    for (unsigned i = 0; i < SORTED_CODEC_BLOCK; i++) {
+        low[i] = (uint32_t)deltas[i] & mask;
+    }
+    uint32_t packed[4 * 32];
+    sortedCodecPack(low, best, packed, isa);
+    memcpy(p, packed, 16 * best);
+    p += 16 * best;
+
+    exceptions = 0;
+    for (unsigned i = 0; i < SORTED_CODEC_BLOCK; i++) {
+        p[exceptions] = (unsigned char)i;
+        exceptions += (deltas[i] >> best) != 0;
+    }
+    const unsigned char* positions = p;
+    p += exceptions;
+    for (unsigned e = 0; e < exceptions; e++) {
+        p += sortedCodecPutVarint(p, deltas[positions[e]] >> best);
+    }
+    header[0] = (unsigned char)best;
+    header[1] = (unsigned char)exceptions;
+    return (size_t)(p - out);
+}
+
+/**
+ * Reads value i of a sorted array of width bytes, sign-extended.
+ */
+static inline int64_t sortedCodecValue(const void* sorted, size_t width, size_t i) {
+    return width == 4 ? ((const int32_t*)sorted)[i] : ((const int64_t*)sorted)[i];
+}
+
+/**
+ * Frees the blocks and the skip index.
+ */
+static void sortedCodecFreeBlocks(SortedCodecBlocks* blocks, void** blockFirst) {
+    free(blocks->data);
+    free(blocks->blockOffsets);
+    free(*blockFirst);
+    memset(blocks, 0, sizeof(*blocks));
+    *blockFirst = NULL;
+}
+
+/**
+ * Shared encoder of both widths.
+ *
+ * @return 0 on success, -1 with errno set to EINVAL if the array is not
+ *         sorted or ENOMEM if memory runs out
+ */
+static int sortedCodecEncode(SortedCodecBlocks* blocks, void** blockFirst, const void* sorted, size_t n,
+                             size_t width, SortedCodecIsa isa) {
+    memset(blocks, 0, sizeof(*blocks));
+    blocks->count = n;
+    blocks->blockCount = (n + SORTED_CODEC_BLOCK - 1) / SORTED_CODEC_BLOCK;
+    blocks->isa = sortedCodecDetect(isa);
+    blocks->blockOffsets = (size_t*)malloc((blocks->blockCount + 1) * sizeof(size_t));
+    *blockFirst = malloc(blocks->blockCount * width + 1);
+    size_t capacity = SORTED_CODEC_HEADER + SORTED_CODEC_MAX_BLOCK + n / 2;
+    blocks->data = (unsigned char*)malloc(capacity);
+    if (blocks->blockOffsets == NULL || *blockFirst == NULL || blocks->data == NULL) {
+        sortedCodecFreeBlocks(blocks, blockFirst);
+        errno = ENOMEM;
+        return -1;
+    }
+
+    blocks->data[0] = (unsigned char)width;
+    uint64_t count = n;
+    memcpy(blocks->data + 1, &count, 8);
+    size_t size = SORTED_CODEC_HEADER;
+    uint64_t deltas[SORTED_CODEC_BLOCK];
+    for (size_t block = 0; block < blocks->blockCount; block++) {
+        size_t start = block * SORTED_CODEC_BLOCK;
+        size_t length = n - start < SORTED_CODEC_BLOCK ? n - start : SORTED_CODEC_BLOCK;
+        int64_t first;
+        bool ordered = true;
+        deltas[0] = 0;
+        // Differences of sign-extended values wrap to the true distance
+        if (width == 4) {
+            const int32_t* values = (const int32_t*)sorted + start;
+            first = values[0];
+            ((int32_t*)*blockFirst)[block] = values[0];
+            for (size_t i = 1; i < length; i++) {
+                ordered &= values[i - 1] <= values[i];
+                deltas[i] = (uint64_t)(uint32_t)((uint32_t)values[i] - (uint32_t)values[i - 1]);
+            }
+        } else {
+            const int64_t* values = (const int64_t*)sorted + start;
+            first = values[0];
+            ((int64_t*)*blockFirst)[block] = values[0];
+            for (size_t i = 1; i < length; i++) {
+                ordered &= values[i - 1] <= values[i];
+                deltas[i] = (uint64_t)values[i] - (uint64_t)values[i - 1];
+            }
+        }
+        uint64_t min = UINT64_MAX;
+        for (size_t i = 1; i < length; i++) {
+            min = deltas[i] < min ? deltas[i] : min;
+        }
+        if (!ordered || (start > 0 && sortedCodecValue(sorted, width, start - 1) > first)) {
+            sortedCodecFreeBlocks(blocks, blockFirst);
+            errno = EINVAL;
+            return -1;
+        }
+        min = length > 1 ? min : 0;
+        for (size_t i = 1; i < length; i++) {
+            deltas[i] -= min;
+        }
+        for (size_t i = length; i < SORTED_CODEC_BLOCK; i++) {
+            deltas[i] = 0;
+        }
+
+        if (size + SORTED_CODEC_MAX_BLOCK > capacity) {
+            capacity = capacity * 2 > size + SORTED_CODEC_MAX_BLOCK ? capacity * 2 : size + SORTED_CODEC_MAX_BLOCK;
+            unsigned char* grown = (unsigned char*)realloc(blocks->data, capacity);
+            if (grown == NULL) {
+                sortedCodecFreeBlocks(blocks, blockFirst);
+                errno = ENOMEM;
+                return -1;
+            }
+            blocks->data = grown;
+        }
+        blocks->blockOffsets[block] = size;
+        size += sortedCodecEncodeBlock((uint64_t)first, width, deltas, min, blocks->data + size, blocks->isa);
+    }
+
+    // Give back the slack of the estimate
+    unsigned char* shrunk = (unsigned char*)realloc(blocks->data, size);
+    blocks->data = shrunk != NULL ? shrunk : blocks->data;
+    blocks->blockOffsets[blocks->blockCount] = size;
+    blocks->dataSize = size;
+    return 0;
+}
+
+/**
+ * Shared loader of both widths: copies the encoded form, checks that every
+ * block lies within it, and rebuilds the block offsets and the skip index.
+ *
+ * @return 0 on success, -1 with errno set to EINVAL if data is malformed or
+ *         holds the other width, or ENOMEM if memory runs out
+ */
+static int sortedCodecLoad(SortedCodecBlocks* blocks, void** blockFirst, const unsigned char* data, size_t size,
+                           size_t width, SortedCodecIsa isa) {
+    memset(blocks, 0, sizeof(*blocks));
+    *blockFirst = NULL;
+    uint64_t count;
+    if (size < SORTED_CODEC_HEADER || data[0] != width) {
+        errno = EINVAL;
+        return -1;
+    }
+    memcpy(&count, data + 1, 8);
+    // Every block takes more than width bytes, which bounds a forged count
+    if (count / SORTED_CODEC_BLOCK > size / width) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    blocks->count = (size_t)count;
+    blocks->blockCount = (blocks->count + SORTED_CODEC_BLOCK - 1) / SORTED_CODEC_BLOCK;
+    blocks->isa = sortedCodecDetect(isa);
+    blocks->data = (unsigned char*)malloc(size);
+    blocks->blockOffsets = (size_t*)malloc((blocks->blockCount + 1) * sizeof(size_t));
+    *blockFirst = malloc(blocks->blockCount * width + 1);
+    if (blocks->data == NULL || blocks->blockOffsets == NULL || *blockFirst == NULL) {
+        sortedCodecFreeBlocks(blocks, blockFirst);
+        errno = ENOMEM;
+        return -1;
+    }
+    memcpy(blocks->data, data, size);
+    blocks->dataSize = size;
+
+    const unsigned char* end = blocks->data + size;
+    const unsigned char* p = blocks->data + SORTED_CODEC_HEADER;
+    for (size_t block = 0; block < blocks->blockCount; block++) {
+        blocks->blockOffsets[block] = (size_t)(p - blocks->data);
+        uint64_t min, high;
+        if ((size_t)(end - p) < width + 2) {
+            break;
+        }
+        memcpy((unsigned char*)*blockFirst + block * width, p, width);
+        unsigned b = p[width], exceptions = p[width + 1];
+        p += width + 2;
+        if (b > 32 || exceptions > SORTED_CODEC_BLOCK || (width == 4 && b == 32 && exceptions > 0) ||
+            !sortedCodecCheckVarint(&p, end, &min) || (size_t)(end - p) < 16 * b + exceptions) {
+            break;
+        }
+        p += 16 * b;
+        bool valid = true;
+        for (unsigned e = 0; e < exceptions; e++) {
+            valid &= p[e] < SORTED_CODEC_BLOCK;
+        }
+        p += exceptions;
+        for (unsigned e = 0; e < exceptions && valid; e++) {
+            valid = sortedCodecCheckVarint(&p, end, &high);
+        }
+        if (!valid) {
+            break;
+        }
+        blocks->blockOffsets[block + 1] = (size_t)(p - blocks->data);
+        if (block + 1 == blocks->blockCount && p == end) {
+            return 0;
+        }
+    }
+    if (blocks->blockCount == 0 && p == end) {
+        blocks->blockOffsets[0] = SORTED_CODEC_HEADER;
+        return 0;
+    }
+    sortedCodecFreeBlocks(blocks, blockFirst);
+    errno = EINVAL;
+    return -1;
+}
+
+/**
+ * Unpacks the low bits of a block and returns its exceptions.
+ *
+ * @param low Receives the 128 packed deltas
+ * @param b Receives the bit width
+ * @param min Receives the minimum delta
+ * @param positions Receives the exception positions
+ * @return Number of exceptions; their high bits follow the positions
+ */
+static inline unsigned sortedCodecUnpackBlock(const unsigned char* p, size_t width, SortedCodecIsa isa,
+                                              uint32_t low[], unsigned* b, uint64_t* min,
+                                              const unsigned char** positions) {
+    *b = p[width];
+    unsigned exceptions = p[width + 1];
+    p += width + 2;
+    *min = sortedCodecGetVarint(&p);
+    sortedCodecUnpack((const uint32_t*)p, *b, low, isa);
+    *positions = p + 16 * *b;
+    return exceptions;
+}
+
+/**
+ * Decodes block number block into out.
+ *
+ * @param out Room for SORTED_CODEC_BLOCK values, even for the last block
+ * @return Number of values in the block
+ */
+static size_t sortedCodecDecodeBlockInt(const SortedCodecInt* codec, size_t block, int32_t out[]) {
+    const SortedCodecBlocks* blocks = &codec->blocks;
+    const unsigned char* p = blocks->data + blocks->blockOffsets[block];
+    uint32_t* values = (uint32_t*)out;
+    unsigned b;
+    uint64_t min;
+    const unsigned char* positions;
+    unsigned exceptions = sortedCodecUnpackBlock(p, 4, blocks->isa, values, &b, &min, &positions);
+    const unsigned char* high = positions + exceptions;
+    for (unsigned e = 0; e < exceptions; e++) {
+        values[positions[e]] |= (uint32_t)sortedCodecGetVarint(&high) << b;
+    }
+
+    uint32_t base = (uint32_t)codec->blockFirst[block] - (uint32_t)min;
+#ifdef SORTED_CODEC_X86
+    if (blocks->isa == SORTED_CODEC_SSE2) {
+        sortedCodecPrefixSse2x32(values, base, (uint32_t)min);
+    } else
+#endif
+    {
+        sortedCodecPrefixScalar32(values, base, (uint32_t)min);
+    }
+    size_t start = block * SORTED_CODEC_BLOCK;
+    return blocks->count - start < SORTED_CODEC_BLOCK ? blocks->count - start : SORTED_CODEC_BLOCK;
+}
+
+static size_t sortedCodecDecodeBlockInt64(const SortedCodecInt64* codec, size_t block, int64_t out[]) {
+    const SortedCodecBlocks* blocks = &codec->blocks;
+    const unsigned char* p = blocks->data + blocks->blockOffsets[block];
+    uint64_t* values = (uint64_t*)out;
+    uint32_t low[SORTED_CODEC_BLOCK];
+    unsigned b;
+    uint64_t min;
+    const unsigned char* positions;
+    unsigned exceptions = sortedCodecUnpackBlock(p, 8, blocks->isa, low, &b, &min, &positions);
+    for (unsigned i = 0; i < SORTED_CODEC_BLOCK; i++) {
+        values[i] = low[i];
+    }
+    const unsigned char* high = positions + exceptions;
+    for (unsigned e = 0; e < exceptions; e++) {
+        values[positions[e]] |= sortedCodecGetVarint(&high) << b;
+    }
+
+    uint64_t base = (uint64_t)codec->blockFirst[block] - min;
+#ifdef SORTED_CODEC_X86
+    if (blocks->isa == SORTED_CODEC_SSE2) {
+        sortedCodecPrefixSse2x64(values, base, min);
+    } else
+#endif
+    {
+        sortedCodecPrefixScalar64(values, base, min);
+    }
+    size_t start = block * SORTED_CODEC_BLOCK;
+    return blocks->count - start < SORTED_CODEC_BLOCK ? blocks->count - start : SORTED_CODEC_BLOCK;
+}
+
+/**
+ * Compresses a sorted array of 32-bit integers, such as radixSort output.
+ *
+ * @param codec Codec to fill; free it with sortedCodecFreeInt
+ * @param sorted Array sorted in ascending order; copied, not borrowed
+ * @param n Size of the array
+ * @param isa Fastest implementation allowed (SORTED_CODEC_SSE2 for the best the CPU has)
+ * @return 0 on success, -1 with errno set to EINVAL if the array is not
+ *         sorted or ENOMEM if memory runs out
+ */
+int sortedCodecEncodeInt(SortedCodecInt* codec, const int32_t sorted[], size_t n, SortedCodecIsa isa) {
+    return sortedCodecEncode(&codec->blocks, (void**)&codec->blockFirst, sorted, n, 4, isa);
+}
+
+int sortedCodecEncodeInt64(SortedCodecInt64* codec, const int64_t sorted[], size_t n, SortedCodecIsa isa) {
+    return sortedCodecEncode(&codec->blocks, (void**)&codec->blockFirst, sorted, n, 8, isa);
+}
+
+/**
+ * Rebuilds a codec from the encoded form of another one
+ * (codec.blocks.data and codec.blocks.dataSize), for example after reading
+ * it from a file or the network. The data is copied.
+ *
+ * @param codec Codec to fill; free it with sortedCodecFreeInt
+ * @param data Encoded form
+ * @param size Size of data in bytes
+ * @param isa Fastest implementation allowed
+ * @return 0 on success, -1 with errno set to EINVAL if data is malformed
+ *         or holds 64-bit values, or ENOMEM if memory runs out
+ */
+int sortedCodecLoadInt(SortedCodecInt* codec, const unsigned char* data, size_t size, SortedCodecIsa isa) {
+    return sortedCodecLoad(&codec->blocks, (void**)&codec->blockFirst, data, size, 4, isa);
+}
+
+int sortedCodecLoadInt64(SortedCodecInt64* codec, const unsigned char* data, size_t size, SortedCodecIsa isa) {
+    return sortedCodecLoad(&codec->blocks, (void**)&codec->blockFirst, data, size, 8, isa);
+}
+
+/**
+ * Frees the memory of a codec.
+ */
+void sortedCodecFreeInt(SortedCodecInt* codec) {
+    sortedCodecFreeBlocks(&codec->blocks, (void**)&codec->blockFirst);
+}
+
+void sortedCodecFreeInt64(SortedCodecInt64* codec) {
+    sortedCodecFreeBlocks(&codec->blocks, (void**)&codec->blockFirst);
+}
+
+/**
+ * Returns the number of bytes the codec occupies: the encoded form plus the
+ * block offsets and the skip index.
+ */
+size_t sortedCodecBytesInt(const SortedCodecInt* codec) {
+    return sizeof(SortedCodecInt) + codec->blocks.dataSize + (codec->blocks.blockCount + 1) * sizeof(size_t) +
+           codec->blocks.blockCount * sizeof(int32_t);
+}
+
+size_t sortedCodecBytesInt64(const SortedCodecInt64* codec) {
+    return sizeof(SortedCodecInt64) + codec->blocks.dataSize + (codec->blocks.blockCount + 1) * sizeof(size_t) +
+           codec->blocks.blockCount * sizeof(int64_t);
+}
+
+/**
+ * Decodes one block: values block * SORTED_CODEC_BLOCK onwards.
+ *
+ * @param out Room for SORTED_CODEC_BLOCK values, even for the last block
+ * @return Number of values decoded, 0 if block is out of range
+ */
+size_t sortedCodecBlockInt(const SortedCodecInt* codec, size_t block, int32_t out[]) {
+    return block < codec->blocks.blockCount ? sortedCodecDecodeBlockInt(codec, block, out) : 0;
+}
+
+size_t sortedCodecBlockInt64(const SortedCodecInt64* codec, size_t block, int64_t out[]) {
+    return block < codec->blocks.blockCount ? sortedCodecDecodeBlockInt64(codec, block, out) : 0;
+}
+
+/**
+ * Decodes every value.
+ *
+ * @param out Room for codec->blocks.count values
+ */
+void sortedCodecDecodeInt(const SortedCodecInt* codec, int32_t out[]) {
+    size_t full = codec->blocks.count / SORTED_CODEC_BLOCK;
+    for (size_t block = 0; block < full; block++) {
+        sortedCodecDecodeBlockInt(codec, block, out + block * SORTED_CODEC_BLOCK);
+    }
+    if (full < codec->blocks.blockCount) {
+        // The last block decodes 128 values; only the real ones are copied out
+        int32_t tail[SORTED_CODEC_BLOCK];
+        size_t length = sortedCodecDecodeBlockInt(codec, full, tail);
+        memcpy(out + full * SORTED_CODEC_BLOCK, tail, length * sizeof(int32_t));
+    }
+}
+
+void sortedCodecDecodeInt64(const SortedCodecInt64* codec, int64_t out[]) {
+    size_t full = codec->blocks.count / SORTED_CODEC_BLOCK;
+    for (size_t block = 0; block < full; block++) {
+        sortedCodecDecodeBlockInt64(codec, block, out + block * SORTED_CODEC_BLOCK);
+    }
+    if (full < codec->blocks.blockCount) {
+        int64_t tail[SORTED_CODEC_BLOCK];
+        size_t length = sortedCodecDecodeBlockInt64(codec, full, tail);
+        memcpy(out + full * SORTED_CODEC_BLOCK, tail, length * sizeof(int64_t));
+    }
+}
+
+/**
+ * Returns the value at position index, which must be below codec->blocks.count.
+ */
+int32_t sortedCodecGetInt(const SortedCodecInt* codec, size_t index) {
+    int32_t values[SORTED_CODEC_BLOCK];
+    sortedCodecDecodeBlockInt(codec, index / SORTED_CODEC_BLOCK, values);
+    return values[index % SORTED_CODEC_BLOCK];
+}
+
+int64_t sortedCodecGetInt64(const SortedCodecInt64* codec, size_t index) {
+    int64_t values[SORTED_CODEC_BLOCK];
+    sortedCodecDecodeBlockInt64(codec, index / SORTED_CODEC_BLOCK, values);
+    return values[index % SORTED_CODEC_BLOCK];
+}
+
+/**
+ * Finds the first value not smaller than key: a branchless search for the
+ * last block whose first value is smaller than key, then the same search
+ * within that block once it is decoded.
+ *
+ * @param exact Receives whether the value found equals key
+ */
+static size_t sortedCodecSearchInt(const SortedCodecInt* codec, int32_t key, bool* exact) {
+    size_t blockCount = codec->blocks.blockCount;
+    *exact = false;
+    if (blockCount == 0 || codec->blockFirst[0] >= key) {
+        *exact = blockCount > 0 && codec->blockFirst[0] == key;
+        return 0;
+    }
+    const int32_t* base = codec->blockFirst;
+    size_t len = blockCount;
+    while (len > 1) {
+        size_t half = len / 2;
+        base = base[half] < key ? base + half : base;
+        len -= half;
+    }
+    size_t block = (size_t)(base - codec->blockFirst);
+
+    int32_t values[SORTED_CODEC_BLOCK];
+    size_t length = sortedCodecDecodeBlockInt(codec, block, values);
+    const int32_t* probe = values;
+    for (size_t len = length; len > 1;) {
+        size_t half = len / 2;
+        probe = probe[half] < key ? probe + half : probe;
+        len -= half;
+    }
+    size_t smaller = (size_t)(probe - values) + (*probe < key);
+    size_t pos = block * SORTED_CODEC_BLOCK + smaller;
+    if (smaller < length) {
+        *exact = values[smaller] == key;
+    } else if (block + 1 < blockCount) {
+        *exact = codec->blockFirst[block + 1] == key;
+    }
+    return pos;
+}
+
+static size_t sortedCodecSearchInt64(const SortedCodecInt64* codec, int64_t key, bool* exact) {
+    size_t blockCount = codec->blocks.blockCount;
+    *exact = false;
+    if (blockCount == 0 || codec->blockFirst[0] >= key) {
+        *exact = blockCount > 0 && codec->blockFirst[0] == key;
+        return 0;
+    }
+    const int64_t* base = codec->blockFirst;
+    size_t len = blockCount;
+    while (len > 1) {
+        size_t half = len / 2;
+        base = base[half] < key ? base + half : base;
+        len -= half;
+    }
+    size_t block = (size_t)(base - codec->blockFirst);
+
+    int64_t values[SORTED_CODEC_BLOCK];
+    size_t length = sortedCodecDecodeBlockInt64(codec, block, values);
+    const int64_t* probe = values;
+    for (size_t len = length; len > 1;) {
+        size_t half = len / 2;
+        probe = probe[half] < key ? probe + half : probe;
+        len -= half;
+    }
+    size_t smaller = (size_t)(probe - values) + (*probe < key);
+    size_t pos = block * SORTED_CODEC_BLOCK + smaller;
+    if (smaller < length) {
+        *exact = values[smaller] == key;
+    } else if (block + 1 < blockCount) {
+        *exact = codec->blockFirst[block + 1] == key;
+    }
+    return pos;
+}
+
+/**
+ * Finds the first value not smaller than key, searching the compressed
+ * blocks directly.
+ *
+ * @return Its position, or the number of values if every value is smaller
+ */
+size_t sortedCodecLowerBoundInt(const SortedCodecInt* codec, int32_t key) {
+    bool exact;
+    return sortedCodecSearchInt(codec, key, &exact);
+}
+
+size_t sortedCodecLowerBoundInt64(const SortedCodecInt64* codec, int64_t key) {
+    bool exact;
+    return sortedCodecSearchInt64(codec, key, &exact);
+}
+
+/**
+ * Looks up a value.
+ *
+ * @return Position of the first value equal to key, or SEARCH_NOT_FOUND
+ */
+size_t sortedCodecFindInt(const SortedCodecInt* codec, int32_t key) {
+    bool exact;
+    size_t pos = sortedCodecSearchInt(codec, key, &exact);
+    return exact ? pos : SEARCH_NOT_FOUND;
+}
+
+size_t sortedCodecFindInt64(const SortedCodecInt64* codec, int64_t key) {
+    bool exact;
+    size_t pos = sortedCodecSearchInt64(codec, key, &exact);
+    return exact ? pos : SEARCH_NOT_FOUND;
+}
+
+#ifdef SORTED_INT_CODEC_MAIN
+
+/**
+ * Main function with examples.
+ */
+int main() {
+    // Multiples of 3 with one large jump, which becomes an exception
+    int32_t values[1000];
+    for (int i = 0; i < 1000; i++) {
+        values[i] = 3 * i + (i >= 500 ? 1000000 : 0);
+    }
+
+    SortedCodecInt codec;
+    if (sortedCodecEncodeInt(&codec, values, 1000, SORTED_CODEC_SSE2) != 0) {
+        perror("sortedCodecEncodeInt");
+        return 1;
+    }
+    printf("1000 values in %zu bytes (%zu encoded), decoder: %s\n", sortedCodecBytesInt(&codec),
+           codec.blocks.dataSize, sortedCodecIsaName(codec.blocks.isa));
+
+    printf("sortedCodecGetInt(700) = %d\n", sortedCodecGetInt(&codec, 700));
+    printf("sortedCodecLowerBoundInt(1000) = %zu\n", sortedCodecLowerBoundInt(&codec, 1000));
+    printf("sortedCodecFindInt(1001500) = %zu\n", sortedCodecFindInt(&codec, 1001500));
+    printf("sortedCodecFindInt(4) found: %s\n", sortedCodecFindInt(&codec, 4) != SEARCH_NOT_FOUND ? "yes" : "no");
+
+    // The encoded form is all a receiver needs
+    SortedCodecInt copy;
+    if (sortedCodecLoadInt(&copy, codec.blocks.data, codec.blocks.dataSize, SORTED_CODEC_SSE2) != 0) {
+        perror("sortedCodecLoadInt");
+        return 1;
+    }
+    int32_t decoded[1000];
+    sortedCodecDecodeInt(&copy, decoded);
+    printf("Loaded copy decodes %s\n", memcmp(decoded, values, sizeof(values)) == 0 ? "identically" : "differently");
+
+    sortedCodecFreeInt(&codec);
+    sortedCodecFreeInt(&copy);
+    return 0;
+}
+
+#endif /* SORTED_INT_CODEC_MAIN */
+
+#endif /* SORTED_INT_CODEC_C */
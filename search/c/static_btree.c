@@ -0,0 +1,532 @@
+/**
+ * Static B-Tree (S+ Tree) - Search Algorithm
+ *
+ * Time Complexity:
+ * - Build: O(n / B) on top of the sorted array
+ * - Lower bound: O(log_(B+1) n) node visits, each a constant number of SIMD compares
+ * - Range scan: O(log_(B+1) n + k) for k results
+ *
+ * Space Complexity: about n / (B + 1) keys for the internal nodes (6% for
+ * 32-bit keys); the sorted array itself serves as the leaves and is not copied.
+ *
+ * How it works:
+ * A binary search touches about log2(n) cache lines, and on arrays larger
+ * than the last-level cache each of them is a miss. The static B+ tree
+ * (S+ tree) packs B keys into a node so one cache line answers log2(B + 1)
+ * levels of the binary search:
+ * 1. The sorted array is cut into leaves of B keys
+ * 2. Every internal node has B + 1 children; key c of a node is the smallest
+ *    key of child c + 1, and the layers are stored one after another in BFS
+ *    order, so child c of node j is node j * (B + 1) + c of the layer below
+ * 3. A lookup counts the keys in a node that are smaller than the search
+ *    key with one SIMD comparison and a popcount, and that count is the
+ *    child to descend into; no branch depends on the data
+ *
+ * The node search is compiled for AVX-512, AVX2 and SSE2 and chosen at
+ * run time from the CPU features; other architectures use a scalar loop.
+ * 32-bit keys use nodes of 16 keys and 64-bit keys nodes of 8 keys, one
+ * 64-byte cache line each.
+ */
+
+#ifndef STATIC_BTREE_C
+#define STATIC_BTREE_C
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <errno.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define STATIC_BTREE_X86 1
+#endif
+
+// Keys per node: one 64-byte cache line
+#define STATIC_BTREE_B32 16
+#define STATIC_BTREE_B64 8
+// Enough layers for 17^16 keys
+#define STATIC_BTREE_MAX_LAYERS 16
+
+/**
+ * Node search implementations, from slowest to fastest.
+ */
+typedef enum {
+    STATIC_BTREE_SCALAR,
+    STATIC_BTREE_SSE2,
+    STATIC_BTREE_AVX2,
+    STATIC_BTREE_AVX512,
+} StaticBTreeIsa;
+
+/**
+ * Static B+ tree index over a sorted array of 32-bit integers.
+ * The index borrows the sorted array; it must outlive the index and not change.
+ */
+typedef struct {
+    const int32_t* keys;   // The sorted array (the leaves)
+    size_t n;
+    int32_t* nodes;        // Internal layers, top layer first
+    int32_t tail[STATIC_BTREE_B32];  // Last, partial leaf padded with INT32_MAX
+    int layers;            // Number of internal layers
+    size_t layerOffset[STATIC_BTREE_MAX_LAYERS];  // First key of each layer in nodes, layer 1 = lowest
+    StaticBTreeIsa isa;    // Node search picked at build time
+    size_t (*lowerBound)(const void* tree, int32_t key);
+} StaticBTreeInt;
+
+/**
+ * Static B+ tree index over a sorted array of 64-bit integers.
+ */
+typedef struct {
+    const int64_t* keys;
+    size_t n;
+    int64_t* nodes;
+    int64_t tail[STATIC_BTREE_B64];
+    int layers;
+    size_t layerOffset[STATIC_BTREE_MAX_LAYERS];
+    StaticBTreeIsa isa;
+    size_t (*lowerBound)(const void* tree, int64_t key);
+} StaticBTreeInt64;
+
+/**
+ * Returns the leaf holding leaf index leaf: the caller's array, or the
+ * padded copy of the last leaf if it is partial.
+ */
+static inline const int32_t* staticBTreeLeafInt(const StaticBTreeInt* tree, size_t leaf) {
+    return (leaf + 1) * STATIC_BTREE_B32 <= tree->n ? tree->keys + leaf * STATIC_BTREE_B32 : tree->tail;
+}
+
+static inline const int64_t* staticBTreeLeafInt64(const StaticBTreeInt64* tree, size_t leaf) {
+    return (leaf + 1) * STATIC_BTREE_B64 <= tree->n ? tree->keys + leaf * STATIC_BTREE_B64 : tree->tail;
+}
+
+/**
+ * Scalar node search: number of keys in the node smaller than key.
+ * Compilers turn the loop into SIMD code for the baseline instruction set.
+ */
+static inline unsigned staticBTreeRankScalarInt(const int32_t node[], int32_t key) {
+    unsigned rank = 0;
+    for (int i = 0; i < STATIC_BTREE_B32; i++) {
+        rank += node[i] < key;
+    }
+    return rank;
+}
+
+static inline unsigned staticBTreeRankScalarInt64(const int64_t node[], int64_t key) {
+    unsigned rank = 0;
+    for (int i = 0; i < STATIC_BTREE_B64; i++) {
+        rank += node[i] < key;
+    }
+    return rank;
+}
+
+/**
+ * Descends from the root and returns the lower bound, given the node search
+ * to use. Expanded once per instruction set so the node search is inlined.
+ */
+#define STATIC_BTREE_DESCEND(Tree, B, rankFn, leafFn)                          \
+    const Tree* t = (const Tree*)tree;                                         \
+    size_t k = 0;                                                              \
+    for (int h = t->layers; h >= 1; h--) {                                     \
+        k = k * (B + 1) + rankFn(t->nodes + t->layerOffset[h] + k * (B), key); \
+    }                                                                          \
+    size_t pos = k * (B) + rankFn(leafFn(t, k), key);                          \
+    return pos < t->n ? pos : t->n
+
+static size_t staticBTreeLowerBoundScalarInt(const void* tree, int32_t key) {
+    STATIC_BTREE_DESCEND(StaticBTreeInt, STATIC_BTREE_B32, staticBTreeRankScalarInt, staticBTreeLeafInt);
+}
+
+static size_t staticBTreeLowerBoundScalarInt64(const void* tree, int64_t key) {
+    STATIC_BTREE_DESCEND(StaticBTreeInt64, STATIC_BTREE_B64, staticBTreeRankScalarInt64, staticBTreeLeafInt64);
+}
+
+#ifdef STATIC_BTREE_X86
+
+/**
+ * SSE2 node search: four compares of four keys.
+ */
+__attribute__((target("sse2,popcnt"))) static inline unsigned staticBTreeRankSse2Int(const int32_t node[],
+                                                                                     int32_t key) {
+    __m128i k = _mm_set1_epi32(key);
+    unsigned mask = 0;
+    for (int i = 0; i < 4; i++) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(node + 4 * i));
+        mask |= (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(k, v))) << (4 * i);
+    }
+    return (unsigned)__builtin_popcount(mask);
+}
+
+__attribute__((target("sse2,popcnt"))) static size_t staticBTreeLowerBoundSse2Int(const void* tree, int32_t key) {
+    STATIC_BTREE_DESCEND(StaticBTreeInt, STATIC_BTREE_B32, staticBTreeRankSse2Int, staticBTreeLeafInt);
+}
+
+/**
+ * AVX2 node search: two compares of eight keys.
+ */
+__attribute__((target("avx2,popcnt"))) static inline unsigned staticBTreeRankAvx2Int(const int32_t node[],
+                                                                                     int32_t key) {
+    __m256i k = _mm256_set1_epi32(key);
+    __m256i low = _mm256_cmpgt_epi32(k, _mm256_loadu_si256((const __m256i*)node));
+    __m256i high = _mm256_cmpgt_epi32(k, _mm256_loadu_si256((const __m256i*)(node + 8)));
+    unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(low)) |
+                    (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(high)) << 8;
+    return (unsigned)__builtin_popcount(mask);
+}
+
+__attribute__((target("avx2,popcnt"))) static size_t staticBTreeLowerBoundAvx2Int(const void* tree, int32_t key) {
+    STATIC_BTREE_DESCEND(StaticBTreeInt, STATIC_BTREE_B32, staticBTreeRankAvx2Int, staticBTreeLeafInt);
+}
+
+/**
+ * AVX-512 node search: one compare of all sixteen keys straight into a mask.
+ */
+__attribute__((target("avx512f,popcnt"))) static inline unsigned staticBTreeRankAvx512Int(const int32_t node[],
+                                                                                          int32_t key) {
+    __mmask16 mask = _mm512_cmplt_epi32_mask(_mm512_loadu_si512((const void*)node), _mm512_set1_epi32(key));
+    return (unsigned)__builtin_popcount((unsigned)mask);
+}
+
+__attribute__((target("avx512f,popcnt"))) static size_t staticBTreeLowerBoundAvx512Int(const void* tree,
+                                                                                       int32_t key) {
+    STATIC_BTREE_DESCEND(StaticBTreeInt, STATIC_BTREE_B32, staticBTreeRankAvx512Int, staticBTreeLeafInt);
+}
+
+/**
+ * AVX2 node search for 64-bit keys: two compares of four keys.
+ */
+__attribute__((target("avx2,popcnt"))) static inline unsigned staticBTreeRankAvx2Int64(const int64_t node[],
+                                                                                       int64_t key) {
+    __m256i k = _mm256_set1_epi64x(key);
+    __m256i low = _mm256_cmpgt_epi64(k, _mm256_loadu_si256((const __m256i*)node));
+    __m256i high = _mm256_cmpgt_epi64(k, _mm256_loadu_si256((const __m256i*)(node + 4)));
+    unsigned mask = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(low)) |
+                    (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(high)) << 4;
+    return (unsigned)__builtin_popcount(mask);
+}
+
+__attribute__((target("avx2,popcnt"))) static size_t staticBTreeLowerBoundAvx2Int64(const void* tree,
+                                                                                    int64_t key) {
+    STATIC_BTREE_DESCEND(StaticBTreeInt64, STATIC_BTREE_B64, staticBTreeRankAvx2Int64, staticBTreeLeafInt64);
+}
+
+#endif /* STATIC_BTREE_X86 */
+
+/**
+ * Returns the best node search the CPU supports, capped at limit.
+ */
+static StaticBTreeIsa staticBTreeDetect(StaticBTreeIsa limit) {
+    StaticBTreeIsa isa = STATIC_BTREE_SCALAR;
+#ifdef STATIC_BTREE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("popcnt")) {
+        isa = STATIC_BTREE_SSE2;
+        if (__builtin_cpu_supports("avx2")) {
+            isa = STATIC_BTREE_AVX2;
+        }
+        if (__builtin_cpu_supports("avx512f")) {
+            isa = STATIC_BTREE_AVX512;
+        }
+    }
+#endif
+    return isa < limit ? isa : limit;
+}
+
+/**
+ * Returns a printable name of an instruction set choice.
+ */
+const char* staticBTreeIsaName(StaticBTreeIsa isa) {
+    switch (isa) {
+        case STATIC_BTREE_SSE2:
+            return "sse2";
+        case STATIC_BTREE_AVX2:
+            return "avx2";
+        case STATIC_BTREE_AVX512:
+            return "avx512";
+        default:
+            return "scalar";
+    }
+}
+
+/**
+ * Computes the layer layout for leafCount leaves of B keys.
+ *
+ * @param counts Receives the number of nodes of each internal layer
+ * @return Total number of keys in the internal layers
+ */
+static size_t staticBTreeLayout(size_t leafCount, size_t b, int* layers, size_t layerOffset[], size_t counts[]) {
+    // Count the nodes per layer bottom-up
+    int h = 0;
+    for (size_t nodes = leafCount; nodes > 1 && h + 1 < STATIC_BTREE_MAX_LAYERS;) {
+        nodes = (nodes + b) / (b + 1);
+        counts[++h] = nodes;
+    }
+    *layers = h;
+
+    // Store the top layer first so a lookup walks forward through memory
+    size_t offset = 0;
+    for (int layer = h; layer >= 1; layer--) {
+        layerOffset[layer] = offset;
+        offset += counts[layer] * b;
+    }
+    return offset;
+}
+
+/**
+ * Builds the index over a sorted array of 32-bit integers.
+ *
+ * @param tree Index to fill; free it with staticBTreeFreeInt
+ * @param sorted Array sorted in ascending order; borrowed, not copied
+ * @param n Size of the array
+ * @param isa Fastest node search allowed (STATIC_BTREE_AVX512 for the best the CPU has)
+ * @return 0 on success, -1 with errno set to ENOMEM on failure
+ */
+int staticBTreeBuildInt(StaticBTreeInt* tree, const int32_t sorted[], size_t n, StaticBTreeIsa isa) {
+    const size_t b = STATIC_BTREE_B32;
+    size_t leafCount = n > 0 ? (n + b - 1) / b : 1;
+    size_t counts[STATIC_BTREE_MAX_LAYERS];
+
+    tree->keys = sorted;
+    tree->n = n;
+    tree->nodes = NULL;
+    size_t total = staticBTreeLayout(leafCount, b, &tree->layers, tree->layerOffset, counts);
+    if (total > 0) {
+        tree->nodes = (int32_t*)aligned_alloc(64, (total * sizeof(int32_t) + 63) / 64 * 64);
+        if (tree->nodes == NULL) {
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+
+    // Padded copy of the last leaf, so no node search reads past the array
+    size_t tailStart = (leafCount - 1) * b;
+    for (size_t i = 0; i < b; i++) {
+        tree->tail[i] = tailStart + i < n ? sorted[tailStart + i] : INT32_MAX;
+    }
+
+    // Key c of node j in layer h is the first key of child j * (B + 1) + c + 1,
+    // whose leftmost leaf is that child index times (B + 1)^(h - 1)
+    size_t leavesPerChild = 1;
+    for (int h = 1; h <= tree->layers; h++) {
+        int32_t* layer = tree->nodes + tree->layerOffset[h];
+        for (size_t j = 0; j < counts[h]; j++) {
+            for (size_t c = 0; c < b; c++) {
+                size_t first = (j * (b + 1) + c + 1) * leavesPerChild * b;
+                layer[j * b + c] = first < n ? sorted[first] : INT32_MAX;
+            }
+        }
+        leavesPerChild *= b + 1;
+    }
+
+    tree->isa = staticBTreeDetect(isa);
+    tree->lowerBound = staticBTreeLowerBoundScalarInt;
+#ifdef STATIC_BTREE_X86
+    if (tree->isa == STATIC_BTREE_AVX512) {
+        tree->lowerBound = staticBTreeLowerBoundAvx512Int;
+    } else if (tree->isa == STATIC_BTREE_AVX2) {
+        tree->lowerBound = staticBTreeLowerBoundAvx2Int;
+    } else if (tree->isa == STATIC_BTREE_SSE2) {
+        tree->lowerBound = staticBTreeLowerBoundSse2Int;
+    }
+#endif
+    return 0;
+}
+
+/**
+ * Builds the index over a sorted array of 64-bit integers. Only AVX2 has a
+ * dedicated 64-bit node search; other choices use the scalar one.
+ *
+ * @param tree Index to fill; free it with staticBTreeFreeInt64
+ * @param sorted Array sorted in ascending order; borrowed, not copied
+ * @param n Size of the array
+ * @param isa Fastest node search allowed
+ * @return 0 on success, -1 with errno set to ENOMEM on failure
+ */
+int staticBTreeBuildInt64(StaticBTreeInt64* tree, const int64_t sorted[], size_t n, StaticBTreeIsa isa) {
+    const size_t b = STATIC_BTREE_B64;
+    size_t leafCount = n > 0 ? (n + b - 1) / b : 1;
+    size_t counts[STATIC_BTREE_MAX_LAYERS];
+
+    tree->keys = sorted;
+    tree->n = n;
+    tree->nodes = NULL;
+    size_t total = staticBTreeLayout(leafCount, b, &tree->layers, tree->layerOffset, counts);
+    if (total > 0) {
+        tree->nodes = (int64_t*)aligned_alloc(64, (total * sizeof(int64_t) + 63) / 64 * 64);
+        if (tree->nodes == NULL) {
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+
+    size_t tailStart = (leafCount - 1) * b;
+    for (size_t i = 0; i < b; i++) {
+        tree->tail[i] = tailStart + i < n ? sorted[tailStart + i] : INT64_MAX;
+    }
+
+    size_t leavesPerChild = 1;
+    for (int h = 1; h <= tree->layers; h++) {
+        int64_t* layer = tree->nodes + tree->layerOffset[h];
+        for (size_t j = 0; j < counts[h]; j++) {
+            for (size_t c = 0; c < b; c++) {
+                size_t first = (j * (b + 1) + c + 1) * leavesPerChild * b;
+                layer[j * b + c] = first < n ? sorted[first] : INT64_MAX;
+            }
+        }
+        leavesPerChild *= b + 1;
+    }
+
+    tree->isa = staticBTreeDetect(isa) >= STATIC_BTREE_AVX2 ? STATIC_BTREE_AVX2 : STATIC_BTREE_SCALAR;
+    tree->lowerBound = staticBTreeLowerBoundScalarInt64;
+#ifdef STATIC_BTREE_X86
+    if (tree->isa == STATIC_BTREE_AVX2) {
+        tree->lowerBound = staticBTreeLowerBoundAvx2Int64;
+    }
+#endif
+    return 0;
+}
+
+/**
+ * Frees the internal nodes of an index (not the sorted array).
+ */
+void staticBTreeFreeInt(StaticBTreeInt* tree) {
+    free(tree->nodes);
+    tree->nodes = NULL;
+}
+
+void staticBTreeFreeInt64(StaticBTreeInt64* tree) {
+    free(tree->nodes);
+    tree->nodes = NULL;
+}
+
+/**
+ * Returns the position of the first key not smaller than key.
+ *
+ * @return Index into the sorted array, or n if every key is smaller
+ */
+size_t staticBTreeLowerBoundInt(const StaticBTreeInt* tree, int32_t key) {
+    return tree->lowerBound(tree, key);
+}
+
+size_t staticBTreeLowerBoundInt64(const StaticBTreeInt64* tree, int64_t key) {
+    return tree->lowerBound(tree, key);
+}
+
+/**
+ * Returns the number of bytes the index adds on top of the sorted array.
+ */
+size_t staticBTreeIndexBytesInt(const StaticBTreeInt* tree) {
+    size_t bytes = sizeof(StaticBTreeInt);
+    if (tree->layers > 0) {
+        // The top layer starts at offset 0; everything up to the end of layer 1 is nodes
+        size_t leafCount = tree->n > 0 ? (tree->n + STATIC_BTREE_B32 - 1) / STATIC_BTREE_B32 : 1;
+        size_t layer1Nodes = (leafCount + STATIC_BTREE_B32) / (STATIC_BTREE_B32 + 1);
+        bytes += (tree->layerOffset[1] + layer1Nodes * STATIC_BTREE_B32) * sizeof(int32_t);
+    }
+    return bytes;
+}
+
+/**
+ * Iterator over the keys of a half-open key range [low, high).
+ */
+typedef struct {
+    const int32_t* keys;
+    size_t pos;  // Next position to return
+    size_t end;  // One past the last position
+} StaticBTreeRangeInt;
+
+typedef struct {
+    const int64_t* keys;
+    size_t pos;
+    size_t end;
+} StaticBTreeRangeInt64;
+
+/**
+ * Starts a range scan over all keys k with low <= k < high.
+ */
+StaticBTreeRangeInt staticBTreeRangeInt(const StaticBTreeInt* tree, int32_t low, int32_t high) {
+    StaticBTreeRangeInt range;
+    range.keys = tree->keys;
+    range.pos = staticBTreeLowerBoundInt(tree, low);
+    range.end = low < high ? staticBTreeLowerBoundInt(tree, high) : range.pos;
+    return range;
+}
+
+StaticBTreeRangeInt64 staticBTreeRangeInt64(const StaticBTreeInt64* tree, int64_t low, int64_t high) {
+    StaticBTreeRangeInt64 range;
+    range.keys = tree->keys;
+    range.pos = staticBTreeLowerBoundInt64(tree, low);
+    range.end = low < high ? staticBTreeLowerBoundInt64(tree, high) : range.pos;
+    return range;
+}
+
+/**
+ * Advances a range scan.
+ *
+ * @param range Iterator from staticBTreeRangeInt
+ * @param index Receives the position of the key in the sorted array (may be NULL)
+ * @return true and the next key in *key, or false at the end of the range
+ */
+bool staticBTreeNextInt(StaticBTreeRangeInt* range, int32_t* key, size_t* index) {
+    if (range->pos >= range->end) {
+        return false;
+    }
+    if (index != NULL) {
+        *index = range->pos;
+    }
+    *key = range->keys[range->pos++];
+    return true;
+}
+
+bool staticBTreeNextInt64(StaticBTreeRangeInt64* range, int64_t* key, size_t* index) {
+    if (range->pos >= range->end) {
+        return false;
+    }
+    if (index != NULL) {
+        *index = range->pos;
+    }
+    *key = range->keys[range->pos++];
+    return true;
+}
+
+#ifndef SEARCH_NO_MAIN
+
+/**
+ * Main function with examples.
+ */
+int main() {
+    // Multiples of 3: 0, 3, 6, ..., 297
+    int32_t keys[100];
+    for (int i = 0; i < 100; i++) {
+        keys[i] = 3 * i;
+    }
+
+    StaticBTreeInt tree;
+    if (staticBTreeBuildInt(&tree, keys, 100, STATIC_BTREE_AVX512) != 0) {
+        perror("staticBTreeBuildInt");
+        return 1;
+    }
+    printf("100 keys, %d internal layer(s), node search: %s\n", tree.layers, staticBTreeIsaName(tree.isa));
+
+    int32_t queries[] = {0, 1, 150, 297, 298};
+    for (int i = 0; i < 5; i++) {
+        printf("staticBTreeLowerBoundInt(%d) = %zu\n", queries[i], staticBTreeLowerBoundInt(&tree, queries[i]));
+    }
+
+    printf("Keys in [40, 60): ");
+    StaticBTreeRangeInt range = staticBTreeRangeInt(&tree, 40, 60);
+    int32_t key;
+    while (staticBTreeNextInt(&range, &key, NULL)) {
+        printf("%d ", key);
+    }
+    printf("\n");
+
+    staticBTreeFreeInt(&tree);
+    return 0;
+}
+
+#endif /* SEARCH_NO_MAIN */
+
+#endif /* STATIC_BTREE_C */
@@ -0,0 +1,458 @@
+/**
+ * String Dictionary - Search Algorithm
+ *
+ * Time Complexity:
+ * - Build: O(total length) over an already sorted array
+ * - Lookup / lower bound: O(log(n / B)) block header comparisons plus a
+ *   scan of at most B front-coded strings
+ * - Select by ordinal: O(B) decoding steps
+ * - Prefix range: two lower bounds; iterating it costs O(1) per string plus
+ *   the suffix copy
+ *
+ * Space Complexity: the distinct suffixes of the strings plus a byte or two
+ * per string and one offset per block of B strings
+ *
+ * How it works:
+ * Sorted strings share long prefixes with their neighbours ("/api/v2/users/17",
+ * "/api/v2/users/18"), and a char* array stores every prefix again, plus a
+ * pointer per string. The dictionary packs the strings into blocks of
+ * STRING_DICT_BLOCK strings (front coding):
+ * 1. The first string of a block (the header) is stored whole, so a binary
+ *    search over the block headers finds the block that can hold a key
+ * 2. Every other string is stored as the length of the prefix it shares
+ *    with its predecessor (a varint) followed by the rest of the string
+ * 3. A search inside a block never decodes a string: it tracks how many
+ *    characters the previous string matched of the key, and the shared
+ *    prefix length alone decides most steps; only strings sharing exactly
+ *    that many characters compare their suffix
+ *
+ * Ordinals are positions in the sorted input, so a lower bound is also the
+ * rank of a key and stringDictSelect inverts it.
+ */
+
+#ifndef STRING_DICTIONARY_C
+#define STRING_DICTIONARY_C
+
+#ifndef SEARCH_NO_MAIN
+#define SEARCH_NO_MAIN
+#define STRING_DICTIONARY_MAIN
+#endif
+#include "binary_search.c"
+
+// Strings per front-coded block; larger blocks compress better, smaller
+// ones scan less per lookup
+#define STRING_DICT_BLOCK 16
+
+/**
+ * Read-only dictionary of sorted, front-coded strings.
+ */
+typedef struct {
+    unsigned char* data;   // Blocks, one after another
+    size_t dataSize;
+    size_t* blockOffsets;  // Start of each block in data (the sampled index)
+    size_t blockCount;
+    size_t count;          // Number of strings
+    size_t maxLength;      // Longest string, for decode buffers
+} StringDictionary;
+
+#define STRING_DICTIONARY_INIT {NULL, 0, NULL, 0, 0, 0}
+
+/**
+ * Iterator over a range of ordinals, decoding one string per step.
+ */
+typedef struct {
+    const StringDictionary* dict;
+    const unsigned char* next;  // Encoded form of the next string
+    size_t pos;                 // Ordinal of the next string
+    size_t end;                 // One past the last ordinal
+    char* buffer;               // Decoded current string
+} StringDictIterator;
+
+/**
+ * Writes x as a LEB128 varint.
+ *
+ * @return Number of bytes written (at most 10)
+ */
+static size_t stringDictPutVarint(unsigned char* out, size_t x) {
+    size_t bytes = 0;
+    while (x >= 0x80) {
+        out[bytes++] = (unsigned char)(x | 0x80);
+        x >>= 7;
+    }
+    out[bytes++] = (unsigned char)x;
+    return bytes;
+}
+
+/**
+ * Reads a LEB128 varint and advances *in past it.
+ */
+static inline size_t stringDictGetVarint(const unsigned char** in) {
+    const unsigned char* p = *in;
+    size_t x = *p & 0x7F;
+    for (int shift = 7; *p++ & 0x80; shift += 7) {
+        x |= (size_t)(*p & 0x7F) << shift;
+    }
+    *in = p;
+    return x;
+}
+
+/**
+ * Length of the common prefix of two strings.
+ */
+static size_t stringDictCommonPrefix(const char* a, const char* b) {
+    size_t i = 0;
+    while (a[i] != '\0' && a[i] == b[i]) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * Frees the memory of a dictionary.
+ */
+void stringDictFree(StringDictionary* dict) {
+    free(dict->data);
+    free(dict->blockOffsets);
+    *dict = (StringDictionary)STRING_DICTIONARY_INIT;
+}
+
+/**
+ * Builds a dictionary from a sorted string array. The strings are copied;
+ * the array can be freed afterwards.
+ *
+ * @param dict Dictionary to fill; free it with stringDictFree
+ * @param sorted Strings sorted in ascending strcmp order (duplicates allowed)
+ * @param n Number of strings
+ * @return 0 on success, -1 with errno set to EINVAL if the strings are not
+ *         sorted or ENOMEM if memory runs out
+ */
+int stringDictBuild(StringDictionary* dict, char* const sorted[], size_t n) {
+    *dict = (StringDictionary)STRING_DICTIONARY_INIT;
+    dict->blockCount = (n + STRING_DICT_BLOCK - 1) / STRING_DICT_BLOCK;
+    dict->blockOffsets = (size_t*)malloc((dict->blockCount + 1) * sizeof(size_t));
+    size_t capacity = 4096;
+    dict->data = (unsigned char*)malloc(capacity);
+    if (dict->data == NULL || dict->blockOffsets == NULL) {
+        stringDictFree(dict);
+        errno = ENOMEM;
+        return -1;
+    }
+
+    // One pass, so every string is read once: headers whole, the rest as
+    // (shared length, suffix); the shared prefix also checks the order
+    size_t size = 0;
+    for (size_t i = 0; i < n; i++) {
+        const char* s = sorted[i];
+        if (i + 8 < n) {
+            // Sorted strings are usually scattered over the heap
+            __builtin_prefetch(sorted[i + 8]);
+        }
+        size_t shared = 0;
+        if (i > 0) {
+            shared = stringDictCommonPrefix(sorted[i - 1], s);
+            if ((unsigned char)sorted[i - 1][shared] > (unsigned char)s[shared]) {
+                stringDictFree(dict);
+                errno = EINVAL;
+                return -1;
+            }
+        }
+        size_t suffix = strlen(s + shared) + 1;
+        size_t length = shared + suffix - 1;
+        dict->maxLength = length > dict->maxLength ? length : dict->maxLength;
+
+        // Room for the worst case: a 10-byte varint and the whole string
+        if (size + 10 + length + 1 > capacity) {
+            while (size + 10 + length + 1 > capacity) {
+                capacity *= 2;
+            }
+            unsigned char* grown = (unsigned char*)realloc(dict->data, capacity);
+            if (grown == NULL) {
+                stringDictFree(dict);
+                errno = ENOMEM;
+                return -1;
+            }
+            dict->data = grown;
+        }
+
+        unsigned char* out = dict->data + size;
+        if (i % STRING_DICT_BLOCK == 0) {
+            dict->blockOffsets[i / STRING_DICT_BLOCK] = size;
+            memcpy(out, s, length + 1);
+            size += length + 1;
+        } else {
+            size_t bytes = stringDictPutVarint(out, shared);
+            memcpy(out + bytes, s + shared, suffix);
+            size += bytes + suffix;
+        }
+    }
+
+    // Give back the slack of the last doubling
+    unsigned char* shrunk = (unsigned char*)realloc(dict->data, size > 0 ? size : 1);
+    dict->data = shrunk != NULL ? shrunk : dict->data;
+    dict->blockOffsets[dict->blockCount] = size;
+    dict->dataSize = size;
+    dict->count = n;
+    return 0;
+}
+
+/**
+ * Returns the number of bytes the dictionary occupies.
+ */
+size_t stringDictBytes(const StringDictionary* dict) {
+    return sizeof(StringDictionary) + dict->dataSize + (dict->blockCount + 1) * sizeof(size_t);
+}
+
+/**
+ * Compares a string with key, both starting at the same offset.
+ *
+ * @param common Receives the number of characters they share
+ * @return < 0, 0 or > 0 like strcmp
+ */
+static inline int stringDictCompare(const char* s, const char* key, size_t* common) {
+    size_t i = 0;
+    while (s[i] != '\0' && s[i] == key[i]) {
+        i++;
+    }
+    *common = i;
+    return (unsigned char)s[i] - (unsigned char)key[i];
+}
+
+/**
+ * Finds the first string that is not "before" key. For a lower bound,
+ * before means smaller; with prefixEnd set, it also covers every string
+ * that starts with key, which gives the end of a prefix range.
+ *
+ * @param exact Receives whether the string found equals key
+ */
+static size_t stringDictSearch(const StringDictionary* dict, const char* key, bool prefixEnd, bool* exact) {
+    size_t keyLength = strlen(key);
+    *exact = false;
+
+    // Last block whose header is before the key. The header of block high
+    // is the last one found not before it, so remember whether it was equal.
+    size_t low = 0, high = dict->blockCount;
+    bool highEqual = false;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        size_t common;
+        int cmp = stringDictCompare((const char*)dict->data + dict->blockOffsets[mid], key, &common);
+        if (cmp < 0 || (prefixEnd && common == keyLength)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+            highEqual = cmp == 0;
+        }
+    }
+    if (low == 0) {
+        *exact = highEqual;
+        return 0;
+    }
+
+    size_t block = low - 1;
+    const unsigned char* p = dict->data + dict->blockOffsets[block];
+    size_t match;
+    stringDictCompare((const char*)p, key, &match);
+    p += strlen((const char*)p) + 1;
+
+    // Scan the block. match is how many characters the previous string
+    // shares with key, and that string was before key.
+    size_t first = block * STRING_DICT_BLOCK;
+    size_t last = first + STRING_DICT_BLOCK < dict->count ? first + STRING_DICT_BLOCK : dict->count;
+    for (size_t i = first + 1; i < last; i++) {
+        size_t shared = stringDictGetVarint(&p);
+        if (shared < match) {
+            // Differs from key earlier, where it is larger than its predecessor
+            return i;
+        }
+        if (shared == match) {
+            size_t common;
+            int cmp = stringDictCompare((const char*)p, key + match, &common);
+            match += common;
+            if (!(cmp < 0 || (prefixEnd && match == keyLength))) {
+                *exact = cmp == 0;
+                return i;
+            }
+        }
+        // shared > match: same character as the predecessor where that one
+        // was smaller than key (or a longer string with the whole prefix)
+        p += strlen((const char*)p) + 1;
+    }
+
+    // The answer is the header of the next block
+    *exact = last < dict->count && highEqual;
+    return last;
+}
+
+/**
+ * Finds the first string not smaller than key, which is also the rank of key:
+ * the number of strings smaller than it.
+ *
+ * @return Ordinal of that string, or the number of strings if there is none
+ */
+size_t stringDictLowerBound(const StringDictionary* dict, const char* key) {
+    bool exact;
+    return stringDictSearch(dict, key, false, &exact);
+}
+
+/**
+ * Looks up a string.
+ *
+ * @return Ordinal of the first string equal to key, or SEARCH_NOT_FOUND
+ */
+size_t stringDictFind(const StringDictionary* dict, const char* key) {
+    bool exact;
+    size_t pos = stringDictSearch(dict, key, false, &exact);
+    return exact ? pos : SEARCH_NOT_FOUND;
+}
+
+/**
+ * Finds the ordinals of all strings that start with prefix.
+ *
+ * @return Half-open range [first, last); empty if no string matches
+ */
+SearchRange stringDictPrefixRange(const StringDictionary* dict, const char* prefix) {
+    SearchRange range;
+    bool exact;
+    range.first = stringDictSearch(dict, prefix, false, &exact);
+    range.last = stringDictSearch(dict, prefix, true, &exact);
+    return range;
+}
+
+/**
+ * Decodes the string with a given ordinal.
+ *
+ * @param out Buffer of at least dict->maxLength + 1 bytes
+ * @return Length of the string, or SEARCH_NOT_FOUND if the ordinal is out of range
+ */
+size_t stringDictSelect(const StringDictionary* dict, size_t ordinal, char* out) {
+    if (ordinal >= dict->count) {
+        return SEARCH_NOT_FOUND;
+    }
+    size_t block = ordinal / STRING_DICT_BLOCK;
+    const unsigned char* p = dict->data + dict->blockOffsets[block];
+    size_t length = strlen((const char*)p);
+    memcpy(out, p, length + 1);
+    p += length + 1;
+    for (size_t i = block * STRING_DICT_BLOCK; i < ordinal; i++) {
+        size_t shared = stringDictGetVarint(&p);
+        size_t suffix = strlen((const char*)p);
+        memcpy(out + shared, p, suffix + 1);
+        p += suffix + 1;
+        length = shared + suffix;
+    }
+    return length;
+}
+
+/**
+ * Starts iterating over the strings with ordinals [first, last), for
+ * example a range from stringDictPrefixRange.
+ *
+ * @return 0 on success, -1 with errno set to ENOMEM on failure
+ */
+int stringDictIteratorInit(StringDictIterator* it, const StringDictionary* dict, size_t first, size_t last) {
+    it->dict = dict;
+    it->end = last < dict->count ? last : dict->count;
+    it->pos = first < it->end ? first : it->end;
+    it->buffer = (char*)malloc(dict->maxLength + 1);
+    if (it->buffer == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    it->next = NULL;
+    if (it->pos < it->end && it->pos % STRING_DICT_BLOCK != 0) {
+        // Decode up to the string before the first one, then step from there
+        size_t block = it->pos / STRING_DICT_BLOCK;
+        const unsigned char* p = dict->data + dict->blockOffsets[block];
+        size_t length = strlen((const char*)p);
+        memcpy(it->buffer, p, length + 1);
+        p += length + 1;
+        for (size_t i = block * STRING_DICT_BLOCK + 1; i < it->pos; i++) {
+            size_t shared = stringDictGetVarint(&p);
+            size_t suffix = strlen((const char*)p);
+            memcpy(it->buffer + shared, p, suffix + 1);
+            p += suffix + 1;
+        }
+        it->next = p;
+    }
+    return 0;
+}
+
+/**
+ * Advances an iterator.
+ *
+ * @param s Receives the next string; it stays valid until the next call
+ * @return true, or false at the end of the range
+ */
+bool stringDictNext(StringDictIterator* it, const char** s) {
+    if (it->pos >= it->end) {
+        return false;
+    }
+    const unsigned char* p;
+    if (it->pos % STRING_DICT_BLOCK == 0) {
+        p = it->dict->data + it->dict->blockOffsets[it->pos / STRING_DICT_BLOCK];
+        size_t length = strlen((const char*)p);
+        memcpy(it->buffer, p, length + 1);
+        p += length + 1;
+    } else {
+        p = it->next;
+        size_t shared = stringDictGetVarint(&p);
+        size_t suffix = strlen((const char*)p);
+        memcpy(it->buffer + shared, p, suffix + 1);
+        p += suffix + 1;
+    }
+    it->next = p;
+    it->pos++;
+    *s = it->buffer;
+    return true;
+}
+
+/**
+ * Frees the decode buffer of an iterator.
+ */
+void stringDictIteratorFree(StringDictIterator* it) {
+    free(it->buffer);
+    it->buffer = NULL;
+}
+
+#ifdef STRING_DICTIONARY_MAIN
+
+/**
+ * Main function with examples.
+ */
+int main() {
+    char* paths[] = {"/api/v1/users", "/api/v2/orders", "/api/v2/orders/17", "/api/v2/users",
+                     "/api/v2/users/17", "/api/v2/users/18", "/api/v3/users", "/health"};
+    size_t n = sizeof(paths) / sizeof(paths[0]);
+
+    StringDictionary dict;
+    if (stringDictBuild(&dict, paths, n) != 0) {
+        perror("stringDictBuild");
+        return 1;
+    }
+    printf("%zu strings in %zu bytes\n", dict.count, stringDictBytes(&dict));
+
+    printf("stringDictFind(\"/api/v2/users\") = %zu\n", stringDictFind(&dict, "/api/v2/users"));
+    printf("stringDictLowerBound(\"/api/v2/p\") = %zu\n", stringDictLowerBound(&dict, "/api/v2/p"));
+
+    char buffer[64];
+    stringDictSelect(&dict, 4, buffer);
+    printf("stringDictSelect(4) = %s\n", buffer);
+
+    SearchRange range = stringDictPrefixRange(&dict, "/api/v2/");
+    printf("Strings starting with /api/v2/ (%zu-%zu):\n", range.first, range.last);
+    StringDictIterator it;
+    if (stringDictIteratorInit(&it, &dict, range.first, range.last) == 0) {
+        const char* s;
+        while (stringDictNext(&it, &s)) {
+            printf("  %s\n", s);
+        }
+        stringDictIteratorFree(&it);
+    }
+
+    stringDictFree(&dict);
+    return 0;
+}
+
+#endif /* STRING_DICTIONARY_MAIN */
+
+#endif /* STRING_DICTIONARY_C */
@@ -0,0 +1,561 @@
+/**
+ * Adaptive Sort - Sorting Algorithm Dispatcher
+ *
+ * Time Complexity:
+ * - Best case: O(n) for presorted input or a narrow key range
+ * - Average case: O(n log n)
+ * - Worst case: O(n log n)
+ *
+ * Space Complexity: O(n) for run merging, radix sort and string merge sort; O(log n) otherwise
+ *
+ * How it works:
+ * sortInt and sortString are a single front door over the other algorithms.
+ * They take a few cheap measurements of the input and pick the engine that
+ * fits it best:
+ * 1. Size, value range (integers) and number of natural runs, in one linear scan
+ * 2. Distinct-key ratio, estimated from a sample of at most 256 elements
+ * 3. Dispatch:
+ *    - tiny inputs: insertion sort
+ *    - few natural runs (presorted, reversed, organ pipe): reverse descending
+ *      runs and merge them with a k-way merge
+ *    - narrow or wide integer ranges on large inputs: radix sort on key - min
+ *    - heavy duplicates: three-way quicksort
+ *    - everything else: three-way quicksort (integers) or merge sort (strings)
+ * The decision and the measurements behind it are kept per thread and can
+ * be read with sortLastDecision.
+ */
+
+#ifndef ADAPTIVE_SORT_C
+#define ADAPTIVE_SORT_C
+
+#ifndef SORTING_NO_MAIN
+#define SORTING_NO_MAIN
+#define ADAPTIVE_SORT_MAIN
+#endif
+
+#include "insertion_sort.c"
+#include "merge_sort.c"
+#include "quicksort.c"
+#include "radix_sort.c"
+
+// Inputs up to this size go straight to insertion sort
+#define ADAPTIVE_SMALL 32
+// Run merging is used when there are at most n / ADAPTIVE_RUN_DIVISOR natural runs
+#define ADAPTIVE_RUN_DIVISOR 256
+// Number of elements sampled to estimate the distinct-key ratio
+#define ADAPTIVE_SAMPLE 256
+// A distinct ratio below this counts as heavy duplicates
+#define ADAPTIVE_DUPLICATE_RATIO 0.1
+// Key ranges below this many values are always radix sorted (at most 4 digit passes)
+#define ADAPTIVE_NARROW_RANGE 10000u
+// Wide key ranges are radix sorted from this size on
+#define ADAPTIVE_RADIX_MIN_N 2048
+// String runs are k-way merged up to this many runs
+#define ADAPTIVE_STRING_KWAY_RUNS 8
+
+/**
+ * Engines the dispatcher can choose.
+ */
+typedef enum {
+    SORT_ENGINE_NONE,       // No sort has run yet
+    SORT_ENGINE_INSERTION,
+    SORT_ENGINE_RUN_MERGE,  // Reverse descending runs, then k-way merge
+    SORT_ENGINE_RADIX,
+    SORT_ENGINE_QUICK3,     // Three-way partitioning quicksort
+    SORT_ENGINE_MERGE,
+} SortEngine;
+
+/**
+ * The engine chosen by the last sortInt or sortString call and the input
+ * statistics it was chosen from.
+ */
+typedef struct {
+    SortEngine engine;
+    size_t n;
+    int min;               // Smallest key (integers only)
+    int max;               // Largest key (integers only)
+    int runs;              // Natural runs in the requested direction
+    double distinctRatio;  // Estimated distinct keys / sampled keys
+} SortDecision;
+
+/**
+ * Returns the decision record of the calling thread.
+ */
+static SortDecision* sortDecisionCurrent(void) {
+    static _Thread_local SortDecision decision;
+    return &decision;
+}
+
+/**
+ * Returns the decision made by the last sortInt or sortString call on this thread.
+ */
+SortDecision sortLastDecision(void) {
+    return *sortDecisionCurrent();
+}
+
+/**
+ * Returns a printable name for an engine.
+ */
+const char* sortEngineName(SortEngine engine) {
+    switch (engine) {
+        case SORT_ENGINE_INSERTION:
+            return "insertion";
+        case SORT_ENGINE_RUN_MERGE:
+            return "run-merge";
+        case SORT_ENGINE_RADIX:
+            return "radix";
+        case SORT_ENGINE_QUICK3:
+            return "quick3";
+        case SORT_ENGINE_MERGE:
+            return "merge";
+        default:
+            return "none";
+    }
+}
+
+/**
+ * Counts the natural runs of arr in the requested direction. A run is either
+ * in order (equal neighbours allowed) or strictly against it, so that
+ * reversing it keeps the sort valid. Counting stops once limit is exceeded.
+ *
+ * @return Number of runs, or limit + 1 if there are more than limit runs
+ */
+static int adaptiveCountRunsInt(const int arr[], int n, bool reverse, int limit) {
+    int runs = 0;
+    int i = 0;
+    while (i < n && runs <= limit) {
+        runs++;
+        int j = i + 1;
+        if (j < n && (reverse ? arr[j] > arr[i] : arr[j] < arr[i])) {
+            while (j < n && (reverse ? arr[j] > arr[j - 1] : arr[j] < arr[j - 1])) {
+                j++;
+            }
+        } else {
+            while (j < n && (reverse ? arr[j] <= arr[j - 1] : arr[j] >= arr[j - 1])) {
+                j++;
+            }
+        }
+        i = j;
+    }
+    return runs;
+}
+
+/**
+ * Reverses descending runs in place and merges all runs with kWayMergeInt.
+ * Expects the number of runs to have been counted by adaptiveCountRunsInt;
+ * a single descending run is only reversed.
+ */
+static void adaptiveMergeRunsInt(int arr[], int n, bool reverse, int runCount) {
+    int** runs = (int**)malloc((size_t)runCount * sizeof(int*));
+    int* runSizes = (int*)malloc((size_t)runCount * sizeof(int));
+    if (runs == NULL || runSizes == NULL) {
+        free(runs);
+        free(runSizes);
+        quicksort3WayInt(arr, n, reverse);
+        return;
+    }
+
+    int k = 0;
+    int i = 0;
+    while (i < n) {
+        int j = i + 1;
+        if (j < n && (reverse ? arr[j] > arr[i] : arr[j] < arr[i])) {
+            while (j < n && (reverse ? arr[j] > arr[j - 1] : arr[j] < arr[j - 1])) {
+                j++;
+            }
+            // Strictly against the order: reversing cannot reorder equal keys
+            for (int lo = i, hi = j - 1; lo < hi; lo++, hi--) {
+                int temp = arr[lo];
+                arr[lo] = arr[hi];
+                arr[hi] = temp;
+                SORT_STAT_SWAP();
+            }
+        } else {
+            while (j < n && (reverse ? arr[j] <= arr[j - 1] : arr[j] >= arr[j - 1])) {
+                j++;
+            }
+        }
+        runs[k] = arr + i;
+        runSizes[k] = j - i;
+        k++;
+        i = j;
+    }
+
+    if (k > 1) {
+        int* merged = kWayMergeInt(runs, runSizes, k, reverse);
+        if (merged != NULL) {
+            memcpy(arr, merged, (size_t)n * sizeof(int));
+            SORT_STAT_MOVE(n);
+            free(merged);
+        } else {
+            quicksort3WayInt(arr, n, reverse);
+        }
+    }
+    free(runs);
+    free(runSizes);
+}
+
+/**
+ * Estimates the ratio of distinct keys by sorting an evenly strided sample.
+ */
+static double adaptiveDistinctRatioInt(const int arr[], int n) {
+    int sample[ADAPTIVE_SAMPLE];
+    int count = n < ADAPTIVE_SAMPLE ? n : ADAPTIVE_SAMPLE;
+    for (int i = 0; i < count; i++) {
+        sample[i] = arr[(long long)i * n / count];
+    }
+    quicksort3WayInt(sample, count, false);
+
+    int distinct = count > 0 ? 1 : 0;
+    for (int i = 1; i < count; i++) {
+        distinct += sample[i] != sample[i - 1];
+    }
+    return count > 0 ? (double)distinct / count : 1.0;
+}
+
+/**
+ * Sorts integers with the engine that best fits the input.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void sortInt(int arr[], int n, bool reverse) {
+    SortDecision* decision = sortDecisionCurrent();
+    memset(decision, 0, sizeof(SortDecision));
+    decision->n = n;
+    decision->distinctRatio = 1.0;
+
+    if (n <= ADAPTIVE_SMALL) {
+        decision->engine = SORT_ENGINE_INSERTION;
+        insertionSortInt(arr, n, reverse);
+        return;
+    }
+
+    // Value range
+    int min = arr[0], max = arr[0];
+    for (int i = 1; i < n; i++) {
+        min = arr[i] < min ? arr[i] : min;
+        max = arr[i] > max ? arr[i] : max;
+    }
+    decision->min = min;
+    decision->max = max;
+
+    // Presortedness
+    int runLimit = n / ADAPTIVE_RUN_DIVISOR > 0 ? n / ADAPTIVE_RUN_DIVISOR : 1;
+    decision->runs = adaptiveCountRunsInt(arr, n, reverse, runLimit);
+    if (decision->runs <= runLimit) {
+        decision->engine = SORT_ENGINE_RUN_MERGE;
+        adaptiveMergeRunsInt(arr, n, reverse, decision->runs);
+        return;
+    }
+
+    // A narrow range needs at most four digit passes
+    unsigned range = (unsigned)max - (unsigned)min;
+    if (range < ADAPTIVE_NARROW_RANGE) {
+        decision->engine = SORT_ENGINE_RADIX;
+        radixSortWideWorkspace(arr, n, reverse, NULL);
+        return;
+    }
+
+    decision->distinctRatio = adaptiveDistinctRatioInt(arr, n);
+    if (decision->distinctRatio < ADAPTIVE_DUPLICATE_RATIO) {
+        decision->engine = SORT_ENGINE_QUICK3;
+        quicksort3WayInt(arr, n, reverse);
+        return;
+    }
+
+    if (n >= ADAPTIVE_RADIX_MIN_N) {
+        decision->engine = SORT_ENGINE_RADIX;
+        radixSortWideWorkspace(arr, n, reverse, NULL);
+        return;
+    }
+
+    decision->engine = SORT_ENGINE_QUICK3;
+    quicksort3WayInt(arr, n, reverse);
+}
+
+/**
+ * String version of adaptiveCountRunsInt.
+ */
+static int adaptiveCountRunsString(char* arr[], int n, bool reverse, int limit) {
+    int runs = 0;
+    int i = 0;
+    while (i < n && runs <= limit) {
+        runs++;
+        int j = i + 1;
+        if (j < n && (reverse ? strcmp(arr[j], arr[i]) > 0 : strcmp(arr[j], arr[i]) < 0)) {
+            while (j < n && (reverse ? strcmp(arr[j], arr[j - 1]) > 0 : strcmp(arr[j], arr[j - 1]) < 0)) {
+                j++;
+            }
+        } else {
+            while (j < n && (reverse ? strcmp(arr[j], arr[j - 1]) <= 0 : strcmp(arr[j], arr[j - 1]) >= 0)) {
+                j++;
+            }
+        }
+        i = j;
+    }
+    return runs;
+}
+
+/**
+ * String version of adaptiveMergeRunsInt. With more than
+ * ADAPTIVE_STRING_KWAY_RUNS runs the reversed runs are finished by merge sort.
+ */
+static void adaptiveMergeRunsString(char* arr[], int n, bool reverse, int runCount) {
+    char*** runs = (char***)malloc((size_t)runCount * sizeof(char**));
+    int* runSizes = (int*)malloc((size_t)runCount * sizeof(int));
+    if (runs == NULL || runSizes == NULL) {
+        free(runs);
+        free(runSizes);
+        mergeSortStringWorkspace(arr, n, reverse, NULL);
+        return;
+    }
+
+    int k = 0;
+    int i = 0;
+    while (i < n) {
+        int j = i + 1;
+        if (j < n && (reverse ? strcmp(arr[j], arr[i]) > 0 : strcmp(arr[j], arr[i]) < 0)) {
+            while (j < n && (reverse ? strcmp(arr[j], arr[j - 1]) > 0 : strcmp(arr[j], arr[j - 1]) < 0)) {
+                j++;
+            }
+            for (int lo = i, hi = j - 1; lo < hi; lo++, hi--) {
+                char* temp = arr[lo];
+                arr[lo] = arr[hi];
+                arr[hi] = temp;
+                SORT_STAT_SWAP();
+            }
+        } else {
+            while (j < n && (reverse ? strcmp(arr[j], arr[j - 1]) <= 0 : strcmp(arr[j], arr[j - 1]) >= 0)) {
+                j++;
+            }
+        }
+        runs[k] = arr + i;
+        runSizes[k] = j - i;
+        k++;
+        i = j;
+    }
+
+    if (k > ADAPTIVE_STRING_KWAY_RUNS) {
+        // Merge sort skips merges of halves already in order, which beats
+        // paying log2(k) string comparisons per element in the loser tree
+        mergeSortStringWorkspace(arr, n, reverse, NULL);
+    } else if (k > 1) {
+        char** merged = kWayMergeString(runs, runSizes, k, reverse);
+        if (merged != NULL) {
+            memcpy(arr, merged, (size_t)n * sizeof(char*));
+            SORT_STAT_MOVE(n);
+            free(merged);
+        } else {
+            mergeSortStringWorkspace(arr, n, reverse, NULL);
+        }
+    }
+    free(runs);
+    free(runSizes);
+}
+
+/**
+ * Comparator for sorting the sampled strings with qsort.
+ */
+static int adaptiveCompareStrings(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+/**
+ * String version of adaptiveDistinctRatioInt.
+ */
+static double adaptiveDistinctRatioString(char* arr[], int n) {
+    char* sample[ADAPTIVE_SAMPLE];
+    int count = n < ADAPTIVE_SAMPLE ? n : ADAPTIVE_SAMPLE;
+    for (int i = 0; i < count; i++) {
+        sample[i] = arr[(long long)i * n / count];
+    }
+    qsort(sample, (size_t)count, sizeof(char*), adaptiveCompareStrings);
+
+    int distinct = count > 0 ? 1 : 0;
+    for (int i = 1; i < count; i++) {
+        distinct += strcmp(sample[i], sample[i - 1]) != 0;
+    }
+    return count > 0 ? (double)distinct / count : 1.0;
+}
+
+/**
+ * Sorts strings with the engine that best fits the input.
+ *
+ * @param arr String array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void sortString(char* arr[], int n, bool reverse) {
+    SortDecision* decision = sortDecisionCurrent();
+    memset(decision, 0, sizeof(SortDecision));
+    decision->n = n;
+    decision->distinctRatio = 1.0;
+
+    if (n <= ADAPTIVE_SMALL) {
+        decision->engine = SORT_ENGINE_INSERTION;
+        insertionSortString(arr, n, reverse);
+        return;
+    }
+
+    int runLimit = n / ADAPTIVE_RUN_DIVISOR > 0 ? n / ADAPTIVE_RUN_DIVISOR : 1;
+    decision->runs = adaptiveCountRunsString(arr, n, reverse, runLimit);
+    if (decision->runs <= runLimit) {
+        decision->engine = SORT_ENGINE_RUN_MERGE;
+        adaptiveMergeRunsString(arr, n, reverse, decision->runs);
+        return;
+    }
+
+    decision->distinctRatio = adaptiveDistinctRatioString(arr, n);
+    if (decision->distinctRatio < ADAPTIVE_DUPLICATE_RATIO) {
+        decision->engine = SORT_ENGINE_QUICK3;
+        quicksort3WayString(arr, n, reverse);
+        return;
+    }
+
+    decision->engine = SORT_ENGINE_MERGE;
+    mergeSortStringWorkspace(arr, n, reverse, NULL);
+}
+
+/**
+ * sortInt with a size_t element count. Arrays that fit in an int index go
+ * through sortInt; larger ones are radix sorted, whatever their key range.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void sortIntWide(int arr[], size_t n, bool reverse) {
+    if (sortFitsInt(n)) {
+        sortInt(arr, (int)n, reverse);
+        return;
+    }
+
+    SortDecision* decision = sortDecisionCurrent();
+    memset(decision, 0, sizeof(SortDecision));
+    decision->n = n;
+    decision->distinctRatio = 1.0;
+
+    int min = arr[0], max = arr[0];
+    for (size_t i = 1; i < n; i++) {
+        min = arr[i] < min ? arr[i] : min;
+        max = arr[i] > max ? arr[i] : max;
+    }
+    decision->min = min;
+    decision->max = max;
+
+    decision->engine = SORT_ENGINE_RADIX;
+    radixSortWideWorkspace(arr, n, reverse, NULL);
+}
+
+/**
+ * sortString with a size_t element count. Arrays that fit in an int index go
+ * through sortString; larger ones are merge sorted.
+ *
+ * @param arr String array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void sortStringWide(char* arr[], size_t n, bool reverse) {
+    if (sortFitsInt(n)) {
+        sortString(arr, (int)n, reverse);
+        return;
+    }
+
+    SortDecision* decision = sortDecisionCurrent();
+    memset(decision, 0, sizeof(SortDecision));
+    decision->n = n;
+    decision->distinctRatio = 1.0;
+    decision->engine = SORT_ENGINE_MERGE;
+    mergeSortStringWide(arr, n, reverse);
+}
+
+#ifdef ADAPTIVE_SORT_MAIN
+
+/**
+ * Function to print an integer array.
+ */
+void printIntArray(int arr[], int n) {
+    printf("[");
+    for (int i = 0; i < n; i++) {
+        printf("%d", arr[i]);
+        if (i < n - 1) {
+            printf(", ");
+        }
+    }
+    printf("]\n");
+}
+
+/**
+ * Function to print a string array.
+ */
+void printStringArray(char* arr[], int n) {
+    printf("[");
+    for (int i = 0; i < n; i++) {
+        printf("\"%s\"", arr[i]);
+        if (i < n - 1) {
+            printf(", ");
+        }
+    }
+    printf("]\n");
+}
+
+/**
+ * Prints the decision of the last sort.
+ */
+void printDecision(void) {
+    SortDecision decision = sortLastDecision();
+    printf("  engine: %s (n = %zu, runs = %d, distinct ratio = %.2f)\n", sortEngineName(decision.engine),
+           decision.n, decision.runs, decision.distinctRatio);
+}
+
+/**
+ * Main function with examples.
+ */
+int main() {
+    // Example with integers
+    int intArr[] = {64, 34, 25, 12, 22, 11, 90};
+    int intN = sizeof(intArr) / sizeof(intArr[0]);
+
+    printf("Original array: ");
+    printIntArray(intArr, intN);
+
+    sortInt(intArr, intN, false);
+    printf("Ascending order: ");
+    printIntArray(intArr, intN);
+    printDecision();
+
+    // The engine depends on the input: presorted, duplicate-heavy and random data
+    int n = 100000;
+    int* large = (int*)malloc(n * sizeof(int));
+    const char* names[] = {"presorted", "few unique", "random"};
+    srand(42);
+    for (int kind = 0; kind < 3; kind++) {
+        for (int i = 0; i < n; i++) {
+            large[i] = kind == 0 ? (i < n / 2 ? i : n - i) : kind == 1 ? rand() % 8 * 1000003 : rand();
+        }
+        sortInt(large, n, true);
+        printf("%d %s integers, descending:\n", n, names[kind]);
+        printDecision();
+    }
+    free(large);
+
+    // Example with strings
+    char* strArr[] = {"banana", "apple", "cherry", "date", "elderberry", "fig"};
+    int strN = sizeof(strArr) / sizeof(strArr[0]);
+
+    printf("\nOriginal string array: ");
+    printStringArray(strArr, strN);
+
+    sortString(strArr, strN, false);
+    printf("Ascending order: ");
+    printStringArray(strArr, strN);
+    printDecision();
+
+    return 0;
+}
+
+#endif /* ADAPTIVE_SORT_MAIN */
+
+#endif /* ADAPTIVE_SORT_C */
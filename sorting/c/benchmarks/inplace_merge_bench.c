@@ -0,0 +1,101 @@
+/**
+ * In-Place Merge Sort - Benchmark
+ *
+ * The speed and memory curve of mergeSortInPlaceIntWide: n uniform random
+ * integers sorted with caller buffers of 0, 64, 1024, sqrt(n), n / 64,
+ * n / 8 and n / 2 elements, next to mergeSortIntWide, which always takes
+ * a scratch array of n / 2 elements. For every row it reports seconds,
+ * ns/element, the extra memory in KB (buffer or scratch) and the time
+ * relative to mergeSortIntWide. Every result is checked against the
+ * output of mergeSortIntWide.
+ *
+ * Build and run:
+ *   cc -O2 -o inplace_merge_bench inplace_merge_bench.c
+ *   ./inplace_merge_bench [n]
+ */
+
+#define SORTING_NO_MAIN
+#include "../merge_sort.c"
+
+#include <time.h>
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * xorshift64* generator, so every run sees the same inputs.
+ */
+static uint64_t benchRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 10000000;
+    if (n < 2) {
+        fprintf(stderr, "n must be at least 2\n");
+        return 1;
+    }
+    int* input = (int*)malloc(n * sizeof(int));
+    int* expected = (int*)malloc(n * sizeof(int));
+    int* arr = (int*)malloc(n * sizeof(int));
+    int* buffer = (int*)malloc(n / 2 * sizeof(int));
+    if (input == NULL || expected == NULL || arr == NULL || buffer == NULL) {
+        fprintf(stderr, "out of memory for %zu integers\n", n);
+        return 1;
+    }
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < n; i++) {
+        input[i] = (int)(benchRandom(&state) >> 33);
+    }
+    // Fault the buffer pages in first, so no row pays for them
+    memset(buffer, 0, n / 2 * sizeof(int));
+
+    memcpy(expected, input, n * sizeof(int));
+    double start = nowSeconds();
+    mergeSortIntWide(expected, n, false);
+    double mergeTime = nowSeconds() - start;
+
+    size_t root = 0;
+    while ((root + 1) * (root + 1) <= n) {
+        root++;
+    }
+    struct {
+        const char* name;
+        size_t size;
+    } buffers[] = {
+        {"none", 0}, {"64", 64}, {"1024", 1024}, {"sqrt(n)", root}, {"n/64", n / 64}, {"n/8", n / 8}, {"n/2", n / 2},
+    };
+
+    printf("%zu uniform random integers\n", n);
+    printf("%14s %10s %10s %12s %10s\n", "buffer", "seconds", "ns/elem", "extra KB", "vs merge");
+    printf("%14s %10.3f %10.2f %12.1f %9.2fx\n", "mergeSortInt", mergeTime, mergeTime / n * 1e9,
+           n / 2 * sizeof(int) / 1024.0, 1.0);
+    for (size_t b = 0; b < sizeof(buffers) / sizeof(buffers[0]); b++) {
+        size_t size = buffers[b].size < n / 2 ? buffers[b].size : n / 2;
+        memcpy(arr, input, n * sizeof(int));
+        start = nowSeconds();
+        mergeSortInPlaceIntWide(arr, n, false, size > 0 ? buffer : NULL, size);
+        double seconds = nowSeconds() - start;
+        if (memcmp(arr, expected, n * sizeof(int)) != 0) {
+            printf("%s: order differs from mergeSortIntWide\n", buffers[b].name);
+            return 1;
+        }
+        printf("%14s %10.3f %10.2f %12.1f %9.2fx\n", buffers[b].name, seconds, seconds / n * 1e9,
+               size * sizeof(int) / 1024.0, seconds / mergeTime);
+    }
+
+    free(input);
+    free(expected);
+    free(arr);
+    free(buffer);
+    return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * K-Way Merge - Benchmark
+ *
+ * Compares the single-pass loser tree merge (kWayMergeInt) against merging
+ * the same runs pairwise with mergeInt, one round at a time, for k = 4..1024.
+ *
+ * Build and run:
+ *   cc -O2 -o kway_merge_bench kway_merge_bench.c
+ *   ./kway_merge_bench [total elements]
+ */
+
+#define SORTING_NO_MAIN
+#include "../merge_sort.c"
+
+#include <time.h>
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * Merges k runs by repeatedly merging neighbouring pairs with mergeInt.
+ *
+ * @return Merged sorted array (caller must free)
+ */
+static int* pairwiseMergeInt(int* runs[], int runSizes[], int k) {
+    int** current = (int**)malloc(k * sizeof(int*));
+    int* sizes = (int*)malloc(k * sizeof(int));
+    bool* owned = (bool*)calloc(k, sizeof(bool));
+    for (int r = 0; r < k; r++) {
+        current[r] = runs[r];
+        sizes[r] = runSizes[r];
+    }
+
+    while (k > 1) {
+        int next = 0;
+        for (int r = 0; r < k; r += 2) {
+            if (r + 1 == k) {
+                current[next] = current[r];
+                sizes[next] = sizes[r];
+                owned[next++] = owned[r];
+                continue;
+            }
+            int* merged = mergeInt(current[r], sizes[r], current[r + 1], sizes[r + 1], false);
+            if (owned[r]) {
+                free(current[r]);
+            }
+            if (owned[r + 1]) {
+                free(current[r + 1]);
+            }
+            current[next] = merged;
+            sizes[next] = sizes[r] + sizes[r + 1];
+            owned[next++] = true;
+        }
+        k = next;
+    }
+
+    int* result = current[0];
+    free(current);
+    free(sizes);
+    free(owned);
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    int total = argc > 1 ? atoi(argv[1]) : 1 << 22;
+    int* data = (int*)malloc(total * sizeof(int));
+
+    printf("%6s %14s %14s %8s\n", "k", "loser ns/elem", "pairwise ns/el", "speedup");
+    for (int k = 4; k <= 1024; k *= 2) {
+        int* runs[1024];
+        int runSizes[1024];
+
+        // Split the data into k runs, each sorted by construction
+        srand(42);
+        int offset = 0;
+        for (int r = 0; r < k; r++) {
+            runSizes[r] = total / k + (r < total % k ? 1 : 0);
+            runs[r] = data + offset;
+            int value = rand() % 16;
+            for (int i = 0; i < runSizes[r]; i++) {
+                value += rand() % 64;
+                runs[r][i] = value;
+            }
+            offset += runSizes[r];
+        }
+
+        double start = nowSeconds();
+        int* loser = kWayMergeInt(runs, runSizes, k, false);
+        double loserTime = nowSeconds() - start;
+
+        start = nowSeconds();
+        int* pairwise = pairwiseMergeInt(runs, runSizes, k);
+        double pairwiseTime = nowSeconds() - start;
+
+        if (memcmp(loser, pairwise, total * sizeof(int)) != 0) {
+            fprintf(stderr, "mismatch for k = %d\n", k);
+            return 1;
+        }
+
+        printf("%6d %14.2f %14.2f %7.2fx\n", k,
+               loserTime * 1e9 / total, pairwiseTime * 1e9 / total, pairwiseTime / loserTime);
+
+        free(loser);
+        free(pairwise);
+    }
+
+    free(data);
+    return 0;
+}
@@ -0,0 +1,229 @@
+/**
+ * Memory-Mapped In-Place Sort - Benchmark
+ *
+ * Writes a file of random native-endian keys, evicts it from the page
+ * cache, sorts it with mmapSortFile and reports:
+ * - seconds:       wall time of mmapSortFile, write-back and fsync included
+ * - read / write:  bytes the process read from and wrote to storage during
+ *                  the sort (read_bytes and write_bytes of /proc/self/io),
+ *                  as multiples of the file size; the file is read once
+ *                  and written once, 1.0x each
+ * - peak RSS:      largest resident set of the process against the file
+ *                  size; the mapping is the only full-size buffer
+ *
+ * The sorted file is then checked for order and removed. Sizes that do
+ * not fit in RAM turn the random permutation phase into paging and are
+ * not what the sort is meant for. Last, records whose keys share a 1 MiB
+ * prefix are sorted in memory to check that the radix sort does not
+ * recurse once per shared key byte.
+ *
+ * Build and run:
+ *   cc -O2 -o mmap_sort_bench mmap_sort_bench.c
+ *   ./mmap_sort_bench [--mb N] [--type int32|int64] [--path FILE]
+ */
+
+#define SORTING_NO_MAIN
+#include "../mmap_sort.c"
+
+#include <sys/resource.h>
+#include <time.h>
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * xorshift64* generator, so every run sees the same inputs.
+ */
+static uint64_t benchRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+/**
+ * Reads the storage I/O counters of the process.
+ *
+ * @return false if /proc/self/io is not available
+ */
+static bool benchReadIo(unsigned long long* readBytes, unsigned long long* writeBytes) {
+    FILE* file = fopen("/proc/self/io", "r");
+    if (file == NULL) {
+        return false;
+    }
+    char line[128];
+    int found = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        found += sscanf(line, "read_bytes: %llu", readBytes) == 1;
+        found += sscanf(line, "write_bytes: %llu", writeBytes) == 1;
+    }
+    fclose(file);
+    return found == 2;
+}
+
+/**
+ * Writes count random keys of the given width to fd, then flushes them to
+ * storage and drops them from the page cache.
+ *
+ * @return 0 on success, -1 with errno set
+ */
+static int benchWriteKeys(int fd, size_t count, size_t width) {
+    enum { CHUNK = 1 << 20 };
+    unsigned char* chunk = (unsigned char*)malloc(CHUNK);
+    if (chunk == NULL) {
+        return -1;
+    }
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    size_t total = count * width;
+    for (size_t done = 0; done < total;) {
+        size_t size = total - done < CHUNK ? total - done : CHUNK;
+        for (size_t i = 0; i + width <= size; i += width) {
+            uint64_t value = benchRandom(&state);
+            memcpy(chunk + i, &value, width);
+        }
+        ssize_t written = write(fd, chunk, size);
+        if (written < 0) {
+            free(chunk);
+            return -1;
+        }
+        done += (size_t)written;
+    }
+    free(chunk);
+    if (fsync(fd) != 0) {
+        return -1;
+    }
+    return posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0 ? 0 : -1;
+}
+
+/**
+ * Checks that the file holds its keys in ascending order.
+ */
+static bool benchCheckSorted(const char* path, const MmapSortKey* key) {
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        return false;
+    }
+    size_t length = (size_t)st.st_size;
+    const unsigned char* data = (const unsigned char*)mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    madvise((void*)data, length, MADV_SEQUENTIAL);
+    bool sorted = true;
+    for (size_t offset = key->elemSize; sorted && offset < length; offset += key->elemSize) {
+        sorted = mmapCompareFrom(data + offset - key->elemSize, data + offset, key, 0) <= 0;
+    }
+    munmap((void*)data, length);
+    return sorted;
+}
+
+/**
+ * Sorts count records whose keyLength-byte keys differ only in the last
+ * byte and checks the key order and that no record was lost.
+ *
+ * @return false if the records come out wrong
+ */
+static bool benchLongKeys(size_t count, size_t keyLength) {
+    size_t size = keyLength + sizeof(uint64_t);
+    unsigned char* data = (unsigned char*)malloc(count * size);
+    if (data == NULL) {
+        return false;
+    }
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    uint64_t indexSum = 0;
+    for (size_t i = 0; i < count; i++) {
+        unsigned char* record = data + i * size;
+        memset(record, 'a', keyLength - 1);
+        record[keyLength - 1] = (unsigned char)(benchRandom(&state) % 3);
+        uint64_t index = i;
+        memcpy(record + keyLength, &index, sizeof(index));
+        indexSum += i;
+    }
+
+    MmapSortKey key = {MMAP_KEY_RECORD, size, 0, keyLength, false};
+    mmapSortBuffer(data, count, &key);
+    bool valid = true;
+    for (size_t i = 0; i < count; i++) {
+        unsigned char* record = data + i * size;
+        valid = valid && (i == 0 || record[keyLength - 1] >= record[keyLength - 1 - size]);
+        uint64_t index;
+        memcpy(&index, record + keyLength, sizeof(index));
+        indexSum -= index;
+    }
+    free(data);
+    return valid && indexSum == 0;
+}
+
+int main(int argc, char* argv[]) {
+    size_t megabytes = 4096;
+    const char* path = "mmap_sort_bench.bin";
+    MmapSortKey key = {MMAP_KEY_INT32, 4, 0, 4, false};
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--mb") == 0 && i + 1 < argc) {
+            megabytes = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--type") == 0 && i + 1 < argc && strcmp(argv[i + 1], "int32") == 0) {
+            i++;
+        } else if (strcmp(argv[i], "--type") == 0 && i + 1 < argc && strcmp(argv[i + 1], "int64") == 0) {
+            key = (MmapSortKey){MMAP_KEY_INT64, 8, 0, 8, false};
+            i++;
+        } else if (strcmp(argv[i], "--path") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [--mb N] [--type int32|int64] [--path FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    size_t count = megabytes * (1u << 20) / key.elemSize;
+    size_t length = count * key.elemSize;
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || benchWriteKeys(fd, count, key.elemSize) != 0) {
+        perror(path);
+        return 1;
+    }
+    close(fd);
+
+    unsigned long long readBefore = 0, writeBefore = 0, readAfter = 0, writeAfter = 0;
+    bool haveIo = benchReadIo(&readBefore, &writeBefore);
+    double start = nowSeconds();
+    if (mmapSortFile(path, &key) != 0) {
+        perror("mmapSortFile");
+        unlink(path);
+        return 1;
+    }
+    double seconds = nowSeconds() - start;
+    haveIo = haveIo && benchReadIo(&readAfter, &writeAfter);
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    printf("%zu %s keys, %.1f MB file\n", count, key.type == MMAP_KEY_INT32 ? "int32" : "int64", length / 1e6);
+    printf("%10s %10s %10s %10s %14s %10s\n", "seconds", "MB/s", "read", "write", "peak RSS MB", "RSS/file");
+    if (haveIo) {
+        printf("%10.2f %10.1f %9.2fx %9.2fx %14.1f %9.2fx\n", seconds, length / seconds / 1e6,
+               (double)(readAfter - readBefore) / length, (double)(writeAfter - writeBefore) / length,
+               usage.ru_maxrss / 1024.0, usage.ru_maxrss * 1024.0 / length);
+    } else {
+        printf("%10.2f %10.1f %10s %10s %14.1f %9.2fx\n", seconds, length / seconds / 1e6, "n/a", "n/a",
+               usage.ru_maxrss / 1024.0, usage.ru_maxrss * 1024.0 / length);
+    }
+
+    bool sorted = benchCheckSorted(path, &key);
+    unlink(path);
+    if (!sorted) {
+        printf("file is not sorted\n");
+        return 1;
+    }
+    if (!benchLongKeys(64, 1 << 20)) {
+        printf("records with long shared keys are not sorted\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+/**
+ * Radix Sort Key Range - Benchmark
+ *
+ * Measures million keys sorted per second as the key range grows from 16
+ * to 2^24, for keys in [-range / 2, range / 2):
+ * - digits:   the decimal digit passes alone (radixSort before the
+ *             counting fast path)
+ * - radix:    radixSortWide, which counts narrow ranges in one histogram
+ * - quick3:   quicksort3WayIntWide, the comparison sort adaptive sortInt
+ *             uses for duplicate-heavy input
+ *
+ * Build and run:
+ *   cc -O2 -o radix_range_bench radix_range_bench.c
+ *   ./radix_range_bench [n]
+ */
+
+#define SORTING_NO_MAIN
+#include "../radix_sort.c"
+#include "../quicksort.c"
+
+#include <time.h>
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * xorshift64* generator, so every run sees the same inputs.
+ */
+static uint64_t benchRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? (size_t)atol(argv[1]) : 10000000;
+    int* input = (int*)malloc(n * sizeof(int));
+    int* arr = (int*)malloc(n * sizeof(int));
+    int* expected = (int*)malloc(n * sizeof(int));
+    int* scratch = (int*)malloc(n * sizeof(int));
+
+    printf("%zu keys, million keys/s\n", n);
+    printf("%10s %12s %12s %12s %10s\n", "range", "digits", "radix", "quick3", "speedup");
+    for (unsigned range = 16; range <= (1u << 24); range *= 4) {
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+        int low = -(int)(range / 2);
+        for (size_t i = 0; i < n; i++) {
+            input[i] = low + (int)(benchRandom(&state) % range);
+        }
+
+        int min, max;
+        memcpy(arr, input, n * sizeof(int));
+        double start = nowSeconds();
+        radixMinMax(arr, n, &min, &max);
+        radixSortOffsetPasses(arr, scratch, n, false, min, (unsigned)max - (unsigned)min);
+        double digits = nowSeconds() - start;
+        memcpy(expected, arr, n * sizeof(int));
+
+        memcpy(arr, input, n * sizeof(int));
+        start = nowSeconds();
+        radixSortWide(arr, n, false);
+        double radix = nowSeconds() - start;
+        if (memcmp(arr, expected, n * sizeof(int)) != 0) {
+            printf("radix mismatch at range %u\n", range);
+            return 1;
+        }
+
+        memcpy(arr, input, n * sizeof(int));
+        start = nowSeconds();
+        quicksort3WayIntWide(arr, n, false);
+        double quick = nowSeconds() - start;
+
+        printf("%10u %12.1f %12.1f %12.1f %9.1fx\n", range, n / digits / 1e6, n / radix / 1e6, n / quick / 1e6,
+               digits / radix);
+    }
+
+    free(input);
+    free(arr);
+    free(expected);
+    free(scratch);
+    return 0;
+}
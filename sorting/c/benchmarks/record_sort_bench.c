@@ -0,0 +1,198 @@
+/**
+ * Record Sort - Benchmark
+ *
+ * GraySort-style input: 100-byte records with a random 10-byte key followed
+ * by a 90-byte payload that holds the record number. Reports GB of records
+ * sorted per second for:
+ * - to, 1 thread:    recordSortTo into a second buffer on one thread
+ * - to, N threads:   recordSortTo with one thread per online CPU
+ * - in place:        recordSort with one thread per online CPU
+ * - mmap sort:       mmapSortBuffer, the in-place American flag sort that
+ *                    moves whole records on every pass, for comparison
+ *
+ * Before timing, it sorts 40 records whose keys share a 1 MiB prefix and
+ * end in one of three bytes, and checks that they come out in key order
+ * with equal keys in input order; such keys used to recurse once per 8
+ * shared bytes and overflow the stack.
+ *
+ * Build and run:
+ *   cc -O2 -pthread -o record_sort_bench record_sort_bench.c
+ *   ./record_sort_bench [GB]
+ *
+ * The default is 10 GB of records, which needs about 23 GB of memory (two
+ * record buffers plus 32 bytes of sort entries per record); pass a smaller
+ * size on smaller machines.
+ */
+
+#define SORTING_NO_MAIN
+#include "../record_sort.c"
+#include "../mmap_sort.c"
+
+#include <time.h>
+
+#define BENCH_RECORD_SIZE 100
+#define BENCH_KEY_LENGTH 10
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * splitmix64 finalizer, so the key of a record can be recomputed from its
+ * record number when checking the output.
+ */
+static uint64_t benchHash(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Writes record number i: its key, then the number and filler as payload.
+ */
+static void benchMakeRecord(unsigned char* record, uint64_t i) {
+    uint64_t high = benchHash(i), low = benchHash(i ^ 0xFFFFFFFFull);
+    memcpy(record, &high, 8);
+    memcpy(record + 8, &low, 2);
+    memcpy(record + BENCH_KEY_LENGTH, &i, 8);
+    memset(record + BENCH_KEY_LENGTH + 8, 'x', BENCH_RECORD_SIZE - BENCH_KEY_LENGTH - 8);
+}
+
+/**
+ * Checks that records are in key order and hold every record exactly once,
+ * each with its own key.
+ */
+static bool benchCheck(const unsigned char* records, size_t n, unsigned char* seen) {
+    unsigned char expected[BENCH_RECORD_SIZE];
+    memset(seen, 0, (n + 7) / 8);
+    for (size_t r = 0; r < n; r++) {
+        const unsigned char* record = records + r * BENCH_RECORD_SIZE;
+        uint64_t i;
+        memcpy(&i, record + BENCH_KEY_LENGTH, 8);
+        if (i >= n || (seen[i / 8] & (1u << (i % 8)))) {
+            return false;
+        }
+        seen[i / 8] |= (unsigned char)(1u << (i % 8));
+        benchMakeRecord(expected, i);
+        if (memcmp(record, expected, BENCH_RECORD_SIZE) != 0) {
+            return false;
+        }
+        if (r > 0 && memcmp(record - BENCH_RECORD_SIZE, record, BENCH_KEY_LENGTH) > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Sorts count records whose keyLength-byte keys are all 'a' except for the
+ * last byte, one of three values, with recordSortTo and recordSort.
+ * @return true if both put the records in key order, equal keys in input order
+ */
+static bool benchLongKeys(size_t count, size_t keyLength) {
+    size_t size = keyLength + sizeof(uint64_t);
+    unsigned char* src = (unsigned char*)malloc(count * size);
+    unsigned char* dst = (unsigned char*)malloc(count * size);
+    for (uint64_t i = 0; i < count; i++) {
+        unsigned char* record = src + i * size;
+        memset(record, 'a', keyLength - 1);
+        record[keyLength - 1] = (unsigned char)(benchHash(i) % 3);
+        memcpy(record + keyLength, &i, sizeof(i));
+    }
+
+    RecordSortKey key = {size, 0, keyLength, false};
+    bool ok = true;
+    for (int run = 0; ok && run < 2; run++) {
+        if (run == 0) {
+            ok = recordSortTo(src, dst, count, &key, 1, NULL) == 0;
+        } else {
+            memcpy(dst, src, count * size);
+            ok = recordSort(dst, count, &key, 1, NULL) == 0;
+        }
+        for (size_t r = 1; ok && r < count; r++) {
+            const unsigned char* previous = dst + (r - 1) * size;
+            const unsigned char* record = dst + r * size;
+            uint64_t previousIndex, index;
+            memcpy(&previousIndex, previous + keyLength, sizeof(previousIndex));
+            memcpy(&index, record + keyLength, sizeof(index));
+            int cmp = memcmp(previous, record, keyLength);
+            ok = cmp < 0 || (cmp == 0 && previousIndex < index);
+        }
+    }
+    free(src);
+    free(dst);
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    double gigabytes = argc > 1 ? atof(argv[1]) : 10.0;
+    if (!benchLongKeys(40, 1 << 20)) {
+        printf("long keys: wrong order\n");
+        return 1;
+    }
+    size_t n = (size_t)(gigabytes * 1e9 / BENCH_RECORD_SIZE);
+    size_t bytes = n * BENCH_RECORD_SIZE;
+    unsigned char* src = (unsigned char*)malloc(bytes);
+    unsigned char* dst = (unsigned char*)malloc(bytes);
+    unsigned char* seen = (unsigned char*)malloc(n / 8 + 1);
+    // Two arrays of sort entries, and room for the bucket counters of every thread
+    SortWorkspace ws = SORT_WORKSPACE_INIT;
+    size_t workspaceBytes = 2 * n * sizeof(RecordSortEntry) +
+                            (RECORD_SORT_MAX_THREADS + 2) * RECORD_SORT_BUCKETS * sizeof(size_t);
+    if (src == NULL || dst == NULL || seen == NULL || sortWorkspaceReserve(&ws, workspaceBytes) == NULL) {
+        fprintf(stderr, "out of memory for %.1f GB of records\n", gigabytes);
+        return 1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        benchMakeRecord(src + i * BENCH_RECORD_SIZE, i);
+    }
+    // Fault the destination and workspace pages in first, so the first run times only the sort
+    memset(dst, 0, bytes);
+    memset(ws.base, 0, ws.capacity);
+
+    RecordSortKey key = {BENCH_RECORD_SIZE, 0, BENCH_KEY_LENGTH, false};
+    const char* names[] = {"to, 1 thread", "to, N threads", "in place", "mmap sort"};
+    double seconds[4];
+    for (int run = 0; run < 4; run++) {
+        if (run >= 2) {
+            memcpy(dst, src, bytes);
+        }
+        double start = nowSeconds();
+        int status = 0;
+        if (run < 2) {
+            status = recordSortTo(src, dst, n, &key, run == 0 ? 1 : 0, &ws);
+        } else if (run == 2) {
+            status = recordSort(dst, n, &key, 0, &ws);
+        } else {
+            MmapSortKey mmapKey = {MMAP_KEY_RECORD, BENCH_RECORD_SIZE, 0, BENCH_KEY_LENGTH, false};
+            mmapSortBuffer(dst, n, &mmapKey);
+        }
+        seconds[run] = nowSeconds() - start;
+        if (status != 0) {
+            perror(names[run]);
+            return 1;
+        }
+        if (!benchCheck(dst, n, seen)) {
+            printf("%s: wrong output\n", names[run]);
+            return 1;
+        }
+    }
+
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    printf("%zu records of %d bytes (%.2f GB), %ld threads, GB/s\n", n, BENCH_RECORD_SIZE, bytes / 1e9, online);
+    printf("%14s %14s %14s %14s\n", names[0], names[1], names[2], names[3]);
+    printf("%14.3f %14.3f %14.3f %14.3f\n", bytes / seconds[0] / 1e9, bytes / seconds[1] / 1e9,
+           bytes / seconds[2] / 1e9, bytes / seconds[3] / 1e9);
+
+    sortWorkspaceFree(&ws);
+    free(src);
+    free(dst);
+    free(seen);
+    return 0;
+}
@@ -0,0 +1,144 @@
+/**
+ * Segmented Sort - Benchmark
+ *
+ * Sorts many small segments of one flat key array and reports segments per
+ * second for several segment-size distributions. Compared are:
+ * - per-call:   one quicksortInt call per segment on a malloc'd copy, the way
+ *               a caller without a segmented API sorts groups
+ * - loop:       one quicksortInt call per segment, in place
+ * - segmented:  segmentedSortInt on one thread
+ * - parallel:   segmentedSortInt on one thread per online CPU
+ *
+ * Build and run:
+ *   cc -O2 -pthread -o segmented_sort_bench segmented_sort_bench.c
+ *   ./segmented_sort_bench [total elements]
+ */
+
+#define SORTING_NO_MAIN
+#include "../segmented_sort.c"
+
+#include <time.h>
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * xorshift64* generator, so every run sees the same inputs.
+ */
+static uint64_t benchRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+/**
+ * Returns the size of the next segment for distribution dist.
+ */
+static size_t segmentLength(const char* dist, uint64_t* state) {
+    uint64_t r = benchRandom(state);
+    if (strcmp(dist, "pairs") == 0) {
+        return 2;
+    } else if (strcmp(dist, "tiny") == 0) {
+        return 2 + r % 7;
+    } else if (strcmp(dist, "fixed-16") == 0) {
+        return 16;
+    } else if (strcmp(dist, "uniform-2-200") == 0) {
+        return 2 + r % 199;
+    } else {
+        // skewed: mostly small groups, 1% of groups with 1000 to 100000 keys
+        return r % 100 == 0 ? 1000 + (r >> 8) % 99001 : 2 + (r >> 8) % 30;
+    }
+}
+
+static void sortPerCall(int keys[], const size_t offsets[], size_t segmentCount) {
+    for (size_t s = 0; s < segmentCount; s++) {
+        int n = (int)(offsets[s + 1] - offsets[s]);
+        int* copy = (int*)malloc((size_t)n * sizeof(int));
+        memcpy(copy, keys + offsets[s], (size_t)n * sizeof(int));
+        quicksortInt(copy, n, false);
+        memcpy(keys + offsets[s], copy, (size_t)n * sizeof(int));
+        free(copy);
+    }
+}
+
+static void sortLoop(int keys[], const size_t offsets[], size_t segmentCount) {
+    for (size_t s = 0; s < segmentCount; s++) {
+        quicksortInt(keys + offsets[s], (int)(offsets[s + 1] - offsets[s]), false);
+    }
+}
+
+static void sortSegmented(int keys[], const size_t offsets[], size_t segmentCount) {
+    segmentedSortInt(keys, offsets, segmentCount, false, 1);
+}
+
+static void sortParallel(int keys[], const size_t offsets[], size_t segmentCount) {
+    segmentedSortInt(keys, offsets, segmentCount, false, 0);
+}
+
+typedef struct {
+    const char* name;
+    void (*sort)(int keys[], const size_t offsets[], size_t segmentCount);
+} SegmentedEngine;
+
+int main(int argc, char* argv[]) {
+    size_t total = argc > 1 ? (size_t)atol(argv[1]) : 16000000;
+    const char* dists[] = {"pairs", "tiny", "fixed-16", "uniform-2-200", "skewed"};
+    SegmentedEngine engines[] = {
+        {"per-call", sortPerCall},
+        {"loop", sortLoop},
+        {"segmented", sortSegmented},
+        {"parallel", sortParallel},
+    };
+
+    int* input = (int*)malloc(total * sizeof(int));
+    int* keys = (int*)malloc(total * sizeof(int));
+    size_t* offsets = (size_t*)malloc((total + 1) * sizeof(size_t));
+
+    printf("%zu keys, %ld CPUs\n", total, sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%-14s %-10s %10s %14s %10s\n", "distribution", "engine", "segments", "segments/sec", "Melem/s");
+    for (int d = 0; d < 5; d++) {
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+        size_t segmentCount = 0;
+        offsets[0] = 0;
+        while (offsets[segmentCount] < total) {
+            size_t length = segmentLength(dists[d], &state);
+            size_t end = offsets[segmentCount] + length;
+            offsets[++segmentCount] = end < total ? end : total;
+        }
+        for (size_t i = 0; i < total; i++) {
+            input[i] = (int)(benchRandom(&state) >> 32);
+        }
+
+        for (int e = 0; e < 4; e++) {
+            memcpy(keys, input, total * sizeof(int));
+            double start = nowSeconds();
+            engines[e].sort(keys, offsets, segmentCount);
+            double elapsed = nowSeconds() - start;
+
+            // Check every segment
+            for (size_t s = 0; s < segmentCount; s++) {
+                for (size_t i = offsets[s] + 1; i < offsets[s + 1]; i++) {
+                    if (keys[i - 1] > keys[i]) {
+                        printf("%s/%s: segment %zu NOT SORTED\n", dists[d], engines[e].name, s);
+                        return 1;
+                    }
+                }
+            }
+
+            printf("%-14s %-10s %10zu %14.0f %10.1f\n", dists[d], engines[e].name, segmentCount,
+                   segmentCount / elapsed, total / elapsed / 1e6);
+        }
+    }
+
+    free(input);
+    free(keys);
+    free(offsets);
+    return 0;
+}
@@ -0,0 +1,488 @@
+/**
+ * Sorting Algorithms - Benchmark Suite
+ *
+ * Runs every algorithm in sorting/c over a matrix of sizes, input
+ * distributions, key types and directions, and reports ns/element,
+ * throughput and peak resident memory. Each case runs in a forked child,
+ * so the peak RSS belongs to that case alone and a crash (for example the
+ * recursion of quicksort on presorted input) only loses one row.
+ *
+ * Build and run:
+ *   cc -O2 -o sort_bench sort_bench.c
+ *   ./sort_bench [--json] [--max-n N] [--quadratic-max N] [--string-max N]
+ *                [--engine NAME] [--dist NAME] [--direction asc|desc|both]
+ *                [--min-time SECONDS]
+ *
+ * Sizes are the powers of ten from 10 up to --max-n (default 10^6; up to
+ * 10^9 is supported given enough memory). Quadratic algorithms are capped
+ * at --quadratic-max elements (default 10^4) and string keys at
+ * --string-max elements (default 10^7).
+ *
+ * Distributions: uniform, sorted, reversed, organ-pipe, few-unique, zipf,
+ * nearly-sorted, sawtooth. All keys are non-negative so radix sort applies.
+ */
+
+#define _DEFAULT_SOURCE
+
+#define SORTING_NO_MAIN
+#include "../adaptive_sort.c"
+#include "../bubble_sort.c"
+#include "../heap_sort.c"
+#include "../insertion_sort.c"
+#include "../merge_sort.c"
+#include "../quicksort.c"
+#include "../radix_sort.c"
+#include "../selection_sort.c"
+
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+/**
+ * A sorting engine under test. Either entry point may be NULL.
+ */
+typedef struct {
+    const char* name;
+    void (*sortInt)(int arr[], int n, bool reverse);
+    void (*sortString)(char* arr[], int n, bool reverse);
+    bool quadratic;             // O(n^2) on every input
+    bool quadraticUnlessRandom; // O(n^2) (and O(n) deep) unless keys are uniform random
+} BenchEngine;
+
+/**
+ * Largest b with b * b <= n.
+ */
+static int benchIntSqrt(int n) {
+    int b = 0;
+    while ((long)(b + 1) * (b + 1) <= n) {
+        b++;
+    }
+    return b;
+}
+
+static void mergeInPlaceInt(int arr[], int n, bool reverse) {
+    mergeSortInPlaceInt(arr, n, reverse, NULL, 0);
+}
+
+static void mergeInPlaceString(char* arr[], int n, bool reverse) {
+    mergeSortInPlaceString(arr, n, reverse, NULL, 0);
+}
+
+// The in-place merge sort with a sqrt(n)-element buffer, which the peak RSS includes
+static void mergeSqrtInt(int arr[], int n, bool reverse) {
+    int size = benchIntSqrt(n);
+    int* buffer = size > 0 ? (int*)malloc((size_t)size * sizeof(int)) : NULL;
+    mergeSortInPlaceInt(arr, n, reverse, buffer, buffer != NULL ? size : 0);
+    free(buffer);
+}
+
+static void mergeSqrtString(char* arr[], int n, bool reverse) {
+    int size = benchIntSqrt(n);
+    char** buffer = size > 0 ? (char**)malloc((size_t)size * sizeof(char*)) : NULL;
+    mergeSortInPlaceString(arr, n, reverse, buffer, buffer != NULL ? size : 0);
+    free(buffer);
+}
+
+static const BenchEngine engines[] = {
+    {"bubble", bubbleSortInt, bubbleSortString, true, false},
+    {"selection", selectionSortInt, selectionSortString, true, false},
+    {"insertion", insertionSortInt, insertionSortString, true, false},
+    {"heap", heapSortInt, heapSortString, false, false},
+    {"merge", mergeSortInt, mergeSortString, false, false},
+    {"merge-inplace", mergeInPlaceInt, mergeInPlaceString, false, false},
+    {"merge-sqrt", mergeSqrtInt, mergeSqrtString, false, false},
+    {"quick", quicksortInt, quicksortString, false, true},
+    {"radix", radixSort, NULL, false, false},
+    {"quick3", quicksort3WayInt, quicksort3WayString, false, false},
+    {"adaptive", sortInt, sortString, false, false},
+};
+
+static const char* distributions[] = {
+    "uniform", "sorted", "reversed", "organ-pipe", "few-unique", "zipf", "nearly-sorted", "sawtooth",
+};
+
+#define ENGINE_COUNT (int)(sizeof(engines) / sizeof(engines[0]))
+#define DIST_COUNT (int)(sizeof(distributions) / sizeof(distributions[0]))
+
+/**
+ * Options from the command line.
+ */
+typedef struct {
+    bool json;
+    long maxN;
+    long quadraticMax;
+    long stringMax;
+    const char* engine;
+    const char* dist;
+    bool ascending;
+    bool descending;
+    double minTime;
+} BenchOptions;
+
+/**
+ * Result of one case, sent from the child to the parent through a pipe.
+ */
+typedef struct {
+    double nsPerElement;
+    double elementsPerSecond;
+    double bytesPerSecond;
+    long peakRssKb;
+    long repetitions;
+    bool sorted;
+} BenchResult;
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * xorshift64* generator, so every run sees the same inputs.
+ */
+static uint64_t benchRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+/**
+ * Fills keys with n non-negative integers following distribution dist.
+ */
+static void generateKeys(int keys[], long n, const char* dist) {
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+
+    if (strcmp(dist, "uniform") == 0) {
+        for (long i = 0; i < n; i++) {
+            keys[i] = (int)(benchRandom(&state) >> 33);
+        }
+    } else if (strcmp(dist, "sorted") == 0) {
+        for (long i = 0; i < n; i++) {
+            keys[i] = (int)(i % 2147483647);
+        }
+    } else if (strcmp(dist, "reversed") == 0) {
+        for (long i = 0; i < n; i++) {
+            keys[i] = (int)((n - i) % 2147483647);
+        }
+    } else if (strcmp(dist, "organ-pipe") == 0) {
+        for (long i = 0; i < n; i++) {
+            keys[i] = (int)(i < n / 2 ? i : n - i);
+        }
+    } else if (strcmp(dist, "few-unique") == 0) {
+        for (long i = 0; i < n; i++) {
+            keys[i] = (int)(benchRandom(&state) % 16);
+        }
+    } else if (strcmp(dist, "zipf") == 0) {
+        // Inverse CDF over a table of ranks with exponent 1
+        long ranks = n < 100000 ? n : 100000;
+        double* cdf = (double*)malloc(ranks * sizeof(double));
+        double sum = 0;
+        for (long r = 0; r < ranks; r++) {
+            sum += 1.0 / (r + 1);
+            cdf[r] = sum;
+        }
+        for (long i = 0; i < n; i++) {
+            double u = (benchRandom(&state) >> 11) * (1.0 / 9007199254740992.0) * sum;
+            long lo = 0, hi = ranks - 1;
+            while (lo < hi) {
+                long mid = (lo + hi) / 2;
+                if (cdf[mid] < u) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            // Scatter the ranks over the key space so the values are not small integers
+            keys[i] = (int)(((uint64_t)lo * 2654435761u) % 2147483647);
+        }
+        free(cdf);
+    } else if (strcmp(dist, "nearly-sorted") == 0) {
+        for (long i = 0; i < n; i++) {
+            keys[i] = (int)(i % 2147483647);
+        }
+        // Swap 1% of the elements with a random partner
+        for (long s = 0; s < n / 100; s++) {
+            long a = (long)(benchRandom(&state) % n);
+            long b = (long)(benchRandom(&state) % n);
+            int temp = keys[a];
+            keys[a] = keys[b];
+            keys[b] = temp;
+        }
+    } else if (strcmp(dist, "sawtooth") == 0) {
+        long period = n / 32 > 0 ? n / 32 : 1;
+        for (long i = 0; i < n; i++) {
+            keys[i] = (int)(i % period);
+        }
+    }
+}
+
+/**
+ * Checks that the output is ordered in the requested direction.
+ */
+static bool isSortedInt(const int arr[], long n, bool reverse) {
+    for (long i = 1; i < n; i++) {
+        if (reverse ? arr[i - 1] < arr[i] : arr[i - 1] > arr[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool isSortedString(char* const arr[], long n, bool reverse) {
+    for (long i = 1; i < n; i++) {
+        int cmp = strcmp(arr[i - 1], arr[i]);
+        if (reverse ? cmp < 0 : cmp > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Runs one case and fills result. Inputs are restored with memcpy before
+ * every repetition; the cost of that copy is measured on its own and subtracted.
+ */
+static void runCase(const BenchEngine* engine, const char* dist, long n, bool strings, bool reverse,
+                    double minTime, BenchResult* result) {
+    int* keys = (int*)malloc(n * sizeof(int));
+    generateKeys(keys, n, dist);
+
+    size_t elemSize = strings ? sizeof(char*) : sizeof(int);
+    void* input = keys;
+    char* text = NULL;
+    if (strings) {
+        // Zero-padded decimal keys keep string order equal to numeric order
+        text = (char*)malloc(n * 11);
+        char** pointers = (char**)malloc(n * sizeof(char*));
+        for (long i = 0; i < n; i++) {
+            pointers[i] = text + i * 11;
+            snprintf(pointers[i], 11, "%010d", keys[i]);
+        }
+        input = pointers;
+    }
+    void* work = malloc(n * elemSize);
+
+    long repetitions = 0;
+    double sortTime = 0;
+    double start = nowSeconds();
+    do {
+        memcpy(work, input, n * elemSize);
+        double t0 = nowSeconds();
+        if (strings) {
+            engine->sortString((char**)work, (int)n, reverse);
+        } else {
+            engine->sortInt((int*)work, (int)n, reverse);
+        }
+        sortTime += nowSeconds() - t0;
+        repetitions++;
+    } while (nowSeconds() - start < minTime);
+
+    // Check the output of the last timed repetition
+    result->sorted = strings ? isSortedString((char**)work, n, reverse) : isSortedInt((int*)work, n, reverse);
+
+    // For tiny inputs the clock reads dominate: time a batch without per-call reads
+    if (sortTime / repetitions < 1e-5) {
+        double batchStart = nowSeconds();
+        for (long r = 0; r < repetitions; r++) {
+            memcpy(work, input, n * elemSize);
+            if (strings) {
+                engine->sortString((char**)work, (int)n, reverse);
+            } else {
+                engine->sortInt((int*)work, (int)n, reverse);
+            }
+        }
+        double batchTime = nowSeconds() - batchStart;
+        double copyStart = nowSeconds();
+        for (long r = 0; r < repetitions; r++) {
+            memcpy(work, input, n * elemSize);
+            __asm__ volatile("" : : "r"(work) : "memory");
+        }
+        double copyTime = nowSeconds() - copyStart;
+        sortTime = batchTime > copyTime ? batchTime - copyTime : batchTime;
+    }
+
+    double perSort = sortTime / repetitions;
+    result->nsPerElement = perSort * 1e9 / n;
+    result->elementsPerSecond = n / perSort;
+    result->bytesPerSecond = n * elemSize / perSort;
+    result->repetitions = repetitions;
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    result->peakRssKb = usage.ru_maxrss;
+
+    free(work);
+    if (strings) {
+        free(input);
+        free(text);
+    }
+    free(keys);
+}
+
+/**
+ * Forks a child for one case and collects its result.
+ *
+ * @return true if the child finished and reported a result
+ */
+static bool runCaseIsolated(const BenchEngine* engine, const char* dist, long n, bool strings, bool reverse,
+                            double minTime, BenchResult* result) {
+    int fds[2];
+    if (pipe(fds) < 0) {
+        return false;
+    }
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        runCase(engine, dist, n, strings, reverse, minTime, result);
+        ssize_t written = write(fds[1], result, sizeof(*result));
+        _exit(written == (ssize_t)sizeof(*result) ? 0 : 1);
+    }
+    close(fds[1]);
+    if (pid < 0) {
+        close(fds[0]);
+        return false;
+    }
+
+    ssize_t got = read(fds[0], result, sizeof(*result));
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    return got == (ssize_t)sizeof(*result) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**
+ * Prints the command-line usage.
+ */
+static void printUsage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [--json] [--max-n N] [--quadratic-max N] [--string-max N]\n"
+            "          [--engine NAME] [--dist NAME] [--direction asc|desc|both] [--min-time SECONDS]\n",
+            program);
+}
+
+/**
+ * Parses the command line into options.
+ *
+ * @return false on invalid arguments
+ */
+static bool parseOptions(int argc, char* argv[], BenchOptions* options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--json") == 0) {
+            options->json = true;
+            continue;
+        }
+        if (value == NULL) {
+            return false;
+        }
+        i++;
+        if (strcmp(arg, "--max-n") == 0) {
+            options->maxN = (long)atof(value);
+        } else if (strcmp(arg, "--quadratic-max") == 0) {
+            options->quadraticMax = (long)atof(value);
+        } else if (strcmp(arg, "--string-max") == 0) {
+            options->stringMax = (long)atof(value);
+        } else if (strcmp(arg, "--engine") == 0) {
+            options->engine = value;
+        } else if (strcmp(arg, "--dist") == 0) {
+            options->dist = value;
+        } else if (strcmp(arg, "--direction") == 0) {
+            options->ascending = strcmp(value, "desc") != 0;
+            options->descending = strcmp(value, "asc") != 0;
+        } else if (strcmp(arg, "--min-time") == 0) {
+            options->minTime = atof(value);
+        } else {
+            return false;
+        }
+    }
+    return options->maxN <= 2147483647L;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options = {false, 1000000, 10000, 10000000, NULL, NULL, true, true, 0.2};
+    if (!parseOptions(argc, argv, &options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    if (options.json) {
+        printf("[\n");
+    } else {
+        printf("%-13s %-6s %-13s %-4s %11s %10s %14s %12s %12s\n",
+               "engine", "key", "distribution", "dir", "n", "ns/elem", "Melem/s", "MB/s", "peak RSS KB");
+    }
+
+    bool first = true;
+    for (int e = 0; e < ENGINE_COUNT; e++) {
+        const BenchEngine* engine = &engines[e];
+        if (options.engine != NULL && strcmp(options.engine, engine->name) != 0) {
+            continue;
+        }
+        for (int strings = 0; strings <= 1; strings++) {
+            if (strings ? engine->sortString == NULL : engine->sortInt == NULL) {
+                continue;
+            }
+            for (int d = 0; d < DIST_COUNT; d++) {
+                const char* dist = distributions[d];
+                if (options.dist != NULL && strcmp(options.dist, dist) != 0) {
+                    continue;
+                }
+                for (int reverse = 0; reverse <= 1; reverse++) {
+                    if ((reverse && !options.descending) || (!reverse && !options.ascending)) {
+                        continue;
+                    }
+                    for (long n = 10; n <= options.maxN; n *= 10) {
+                        bool quadratic = engine->quadratic ||
+                                         (engine->quadraticUnlessRandom && strcmp(dist, "uniform") != 0);
+                        if ((quadratic && n > options.quadraticMax) || (strings && n > options.stringMax)) {
+                            break;
+                        }
+
+                        BenchResult result;
+                        bool ok = runCaseIsolated(engine, dist, n, strings, reverse, options.minTime, &result);
+                        const char* key = strings ? "string" : "int";
+                        const char* dir = reverse ? "desc" : "asc";
+
+                        if (options.json) {
+                            printf("%s  {\"engine\": \"%s\", \"key\": \"%s\", \"distribution\": \"%s\", "
+                                   "\"direction\": \"%s\", \"n\": %ld, ",
+                                   first ? "" : ",\n", engine->name, key, dist, dir, n);
+                            if (ok) {
+                                printf("\"ns_per_element\": %.3f, \"elements_per_second\": %.0f, "
+                                       "\"bytes_per_second\": %.0f, \"peak_rss_kb\": %ld, "
+                                       "\"repetitions\": %ld, \"sorted\": %s}",
+                                       result.nsPerElement, result.elementsPerSecond, result.bytesPerSecond,
+                                       result.peakRssKb, result.repetitions, result.sorted ? "true" : "false");
+                            } else {
+                                printf("\"error\": \"case did not complete\"}");
+                            }
+                            first = false;
+                        } else if (ok) {
+                            printf("%-13s %-6s %-13s %-4s %11ld %10.2f %14.2f %12.1f %12ld%s\n",
+                                   engine->name, key, dist, dir, n, result.nsPerElement,
+                                   result.elementsPerSecond / 1e6, result.bytesPerSecond / 1e6,
+                                   result.peakRssKb, result.sorted ? "" : "  NOT SORTED");
+                        } else {
+                            printf("%-13s %-6s %-13s %-4s %11ld %10s\n", engine->name, key, dist, dir, n, "failed");
+                        }
+                        fflush(stdout);
+                    }
+                }
+            }
+        }
+    }
+
+    if (options.json) {
+        printf("\n]\n");
+    }
+    return 0;
+}
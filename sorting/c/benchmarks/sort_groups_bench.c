@@ -0,0 +1,124 @@
+/**
+ * Sort Groups - Benchmark
+ *
+ * Measures GROUP BY and DISTINCT on a large integer column for several key
+ * cardinalities:
+ * - group (two pass):    radixSortWide, then one pass over the sorted keys
+ *                        that writes distinct keys, counts and offsets
+ * - group (fused):       radixSortGroups
+ * - distinct (two pass): radixSortWide, then compaction of neighbours
+ * - distinct (fused):    radixSortDistinct
+ *
+ * Build and run:
+ *   cc -O2 -o sort_groups_bench sort_groups_bench.c
+ *   ./sort_groups_bench [rows]
+ */
+
+#define SORTING_NO_MAIN
+#include "../radix_sort.c"
+
+#include <time.h>
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * xorshift64* generator, so every run sees the same inputs.
+ */
+static uint64_t benchRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? (size_t)atol(argv[1]) : 100000000;
+    size_t cardinalities[] = {10, 1000, 1000000, (size_t)INT_MAX};
+    int* column = (int*)malloc(n * sizeof(int));
+    int* arr = (int*)malloc(n * sizeof(int));
+    SortWorkspace ws = SORT_WORKSPACE_INIT;
+
+    printf("%zu rows\n", n);
+    printf("%12s %10s %16s %16s %16s %16s\n", "cardinality", "groups", "group 2-pass s", "group fused s",
+           "distinct 2-pass s", "distinct fused s");
+    for (int c = 0; c < 4; c++) {
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+        for (size_t i = 0; i < n; i++) {
+            column[i] = (int)(benchRandom(&state) % cardinalities[c]);
+        }
+
+        // Sort, then a separate pass over the sorted keys
+        memcpy(arr, column, n * sizeof(int));
+        double start = nowSeconds();
+        radixSortWideWorkspace(arr, n, false, &ws);
+        SortGroups baseline = SORT_GROUPS_INIT;
+        baseline.keys = (int*)malloc(n * sizeof(int));
+        baseline.counts = (size_t*)malloc(n * sizeof(size_t));
+        baseline.offsets = (size_t*)malloc((n + 1) * sizeof(size_t));
+        size_t g = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (i == 0 || arr[i] != arr[i - 1]) {
+                baseline.keys[g] = arr[i];
+                baseline.offsets[g++] = i;
+            }
+        }
+        baseline.offsets[g] = n;
+        for (size_t j = 0; j < g; j++) {
+            baseline.counts[j] = baseline.offsets[j + 1] - baseline.offsets[j];
+        }
+        baseline.groupCount = g;
+        double twoPass = nowSeconds() - start;
+
+        memcpy(arr, column, n * sizeof(int));
+        SortGroups groups;
+        start = nowSeconds();
+        if (radixSortGroupsWorkspace(arr, n, false, &groups, &ws) != 0) {
+            perror("radixSortGroupsWorkspace");
+            return 1;
+        }
+        double fused = nowSeconds() - start;
+        if (groups.groupCount != baseline.groupCount ||
+            memcmp(groups.keys, baseline.keys, g * sizeof(int)) != 0 ||
+            memcmp(groups.counts, baseline.counts, g * sizeof(size_t)) != 0) {
+            printf("group mismatch\n");
+            return 1;
+        }
+        sortGroupsFree(&baseline);
+        sortGroupsFree(&groups);
+
+        memcpy(arr, column, n * sizeof(int));
+        start = nowSeconds();
+        radixSortWideWorkspace(arr, n, false, &ws);
+        size_t k = 1;
+        for (size_t i = 1; i < n; i++) {
+            if (arr[i] != arr[k - 1]) {
+                arr[k++] = arr[i];
+            }
+        }
+        double distinctTwoPass = nowSeconds() - start;
+
+        memcpy(arr, column, n * sizeof(int));
+        start = nowSeconds();
+        size_t distinct = radixSortDistinctWorkspace(arr, n, false, &ws);
+        double distinctFused = nowSeconds() - start;
+        if (distinct != k) {
+            printf("distinct mismatch\n");
+            return 1;
+        }
+
+        printf("%12zu %10zu %16.2f %16.2f %16.2f %16.2f\n", cardinalities[c], g, twoPass, fused, distinctTwoPass,
+               distinctFused);
+    }
+
+    sortWorkspaceFree(&ws);
+    free(column);
+    free(arr);
+    return 0;
+}
@@ -0,0 +1,91 @@
+/**
+ * Sort Statistics - Report
+ *
+ * Builds every algorithm with instrumentation enabled and prints, per
+ * algorithm, the comparisons, moves, swaps, allocations, maximum recursion
+ * depth and per-phase times of one sort. Hardware counters are shown when
+ * perf_event_open is permitted.
+ *
+ * Build and run:
+ *   cc -O2 -o sort_stats_report sort_stats_report.c
+ *   ./sort_stats_report [n] [uniform|sorted|few-unique]
+ */
+
+#define _DEFAULT_SOURCE
+#ifndef SORT_STATS
+#define SORT_STATS
+#endif
+#ifndef SORT_STATS_PERF
+#define SORT_STATS_PERF
+#endif
+
+#define SORTING_NO_MAIN
+#include "../bubble_sort.c"
+#include "../heap_sort.c"
+#include "../insertion_sort.c"
+#include "../merge_sort.c"
+#include "../quicksort.c"
+#include "../radix_sort.c"
+#include "../selection_sort.c"
+
+typedef struct {
+    const char* name;
+    void (*sort)(int arr[], int n, bool reverse);
+} ReportEngine;
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 10000;
+    const char* dist = argc > 2 ? argv[2] : "uniform";
+
+    ReportEngine engines[] = {
+        {"bubble", bubbleSortInt},
+        {"selection", selectionSortInt},
+        {"insertion", insertionSortInt},
+        {"heap", heapSortInt},
+        {"merge", mergeSortInt},
+        {"quick", quicksortInt},
+        {"radix", radixSort},
+    };
+    int engineCount = sizeof(engines) / sizeof(engines[0]);
+
+    int* input = (int*)malloc(n * sizeof(int));
+    int* arr = (int*)malloc(n * sizeof(int));
+    srand(42);
+    for (int i = 0; i < n; i++) {
+        if (strcmp(dist, "sorted") == 0) {
+            input[i] = i;
+        } else if (strcmp(dist, "few-unique") == 0) {
+            input[i] = rand() % 16;
+        } else {
+            input[i] = rand();
+        }
+    }
+
+    printf("n = %d, distribution = %s\n", n, dist);
+    printf("%-10s %12s %12s %12s %7s %12s %6s %10s %10s %10s %10s\n", "engine", "compares", "moves", "swaps",
+           "allocs", "bytes", "depth", "part ms", "merge ms", "copy ms", "distr ms");
+
+    SortStats stats;
+    for (int e = 0; e < engineCount; e++) {
+        memcpy(arr, input, n * sizeof(int));
+        sortStatsReset();
+        engines[e].sort(arr, n, false);
+        stats = sortStatsGet();
+
+        printf("%-10s %12llu %12llu %12llu %7llu %12llu %6d %10.3f %10.3f %10.3f %10.3f\n", engines[e].name,
+               (unsigned long long)stats.comparisons, (unsigned long long)stats.moves,
+               (unsigned long long)stats.swaps, (unsigned long long)stats.allocations,
+               (unsigned long long)stats.bytesAllocated, stats.maxDepth,
+               stats.phaseSeconds[SORT_PHASE_PARTITION] * 1e3, stats.phaseSeconds[SORT_PHASE_MERGE] * 1e3,
+               stats.phaseSeconds[SORT_PHASE_COPY] * 1e3, stats.phaseSeconds[SORT_PHASE_DISTRIBUTE] * 1e3);
+        if (stats.hardwareCounters) {
+            printf("%-10s cycles %llu, branch misses %llu, LLC misses %llu\n", "",
+                   (unsigned long long)stats.cycles, (unsigned long long)stats.branchMisses,
+                   (unsigned long long)stats.cacheMisses);
+        }
+    }
+
+    free(input);
+    free(arr);
+    return 0;
+}
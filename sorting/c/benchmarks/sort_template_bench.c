@@ -0,0 +1,211 @@
+/**
+ * Sort Template - Benchmark
+ *
+ * Measures million elements sorted per second, for n uniform random keys:
+ * - runtime:    the three-way quicksort as it was before sort_template.h,
+ *               testing the reverse flag on every comparison (kept here
+ *               as the baseline)
+ * - template:   quicksort3WayIntWide, which dispatches once to an
+ *               ascending or descending instantiation of sort_template.h
+ * - qsort:      the C library sort with a comparison function
+ *
+ * and for 16-byte records ordered by a 64-bit key through
+ * SORT_TEMPLATE_KEY, the generated introsort and stable merge sort against
+ * qsort.
+ *
+ * Build and run:
+ *   cc -O2 -o sort_template_bench sort_template_bench.c
+ *   ./sort_template_bench [n]
+ */
+
+#define SORTING_NO_MAIN
+#include "../quicksort.c"
+
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * A record sorted by key, carrying a payload.
+ */
+typedef struct {
+    int64_t key;
+    int64_t payload;
+} BenchRecord;
+
+#define SORT_TEMPLATE_NAME benchRecordsByKey
+#define SORT_TEMPLATE_TYPE BenchRecord
+#define SORT_TEMPLATE_KEY(r) ((r).key)
+#include "../sort_template.h"
+
+/**
+ * The three-way quicksort with a runtime direction flag, as it was before
+ * the compile-time specialization.
+ */
+static void runtimeQuicksort3WayInt(int arr[], int low, int high, bool reverse, int depthLimit) {
+    while (high - low >= SORT_TEMPLATE_INSERTION_THRESHOLD) {
+        if (depthLimit-- == 0) {
+            heapSortInt(arr + low, high - low + 1, reverse);
+            return;
+        }
+
+        int a = arr[low], b = arr[low + (high - low) / 2], c = arr[high];
+        int pivot;
+        if ((a < b) == (b < c)) {
+            pivot = b;
+        } else if ((b < a) == (a < c)) {
+            pivot = a;
+        } else {
+            pivot = c;
+        }
+
+        int lt = low, i = low, gt = high;
+        while (i <= gt) {
+            int value = arr[i];
+            if (reverse ? value > pivot : value < pivot) {
+                arr[i++] = arr[lt];
+                arr[lt++] = value;
+            } else if (reverse ? value < pivot : value > pivot) {
+                arr[i] = arr[gt];
+                arr[gt--] = value;
+            } else {
+                i++;
+            }
+        }
+
+        if (lt - low < high - gt) {
+            runtimeQuicksort3WayInt(arr, low, lt - 1, reverse, depthLimit);
+            low = gt + 1;
+        } else {
+            runtimeQuicksort3WayInt(arr, gt + 1, high, reverse, depthLimit);
+            high = lt - 1;
+        }
+    }
+
+    for (int i = low + 1; i <= high; i++) {
+        int key = arr[i];
+        int j = i - 1;
+        while (j >= low && (reverse ? arr[j] < key : arr[j] > key)) {
+            arr[j + 1] = arr[j];
+            j--;
+        }
+        arr[j + 1] = key;
+    }
+}
+
+static int compareIntAscending(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+static int compareIntDescending(const void* a, const void* b) {
+    return compareIntAscending(b, a);
+}
+
+static int compareRecords(const void* a, const void* b) {
+    int64_t x = ((const BenchRecord*)a)->key, y = ((const BenchRecord*)b)->key;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * xorshift64* generator, so every run sees the same inputs.
+ */
+static uint64_t benchRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? (size_t)atol(argv[1]) : 10000000;
+    if (n > INT_MAX) {
+        fprintf(stderr, "n must fit in an int for the runtime-flag baseline\n");
+        return 1;
+    }
+    int* input = (int*)malloc(n * sizeof(int));
+    int* arr = (int*)malloc(n * sizeof(int));
+    int* expected = (int*)malloc(n * sizeof(int));
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < n; i++) {
+        input[i] = (int)benchRandom(&state);
+    }
+
+    printf("%zu int keys, million keys/s\n", n);
+    printf("%12s %12s %12s %12s %10s\n", "direction", "runtime", "template", "qsort", "speedup");
+    for (int reverse = 0; reverse <= 1; reverse++) {
+        memcpy(arr, input, n * sizeof(int));
+        double start = nowSeconds();
+        runtimeQuicksort3WayInt(arr, 0, (int)n - 1, reverse, sortTemplateDepthLimit(n));
+        double runtime = nowSeconds() - start;
+        memcpy(expected, arr, n * sizeof(int));
+
+        memcpy(arr, input, n * sizeof(int));
+        start = nowSeconds();
+        quicksort3WayIntWide(arr, n, reverse);
+        double specialized = nowSeconds() - start;
+        if (memcmp(arr, expected, n * sizeof(int)) != 0) {
+            printf("template mismatch\n");
+            return 1;
+        }
+
+        memcpy(arr, input, n * sizeof(int));
+        start = nowSeconds();
+        qsort(arr, n, sizeof(int), reverse ? compareIntDescending : compareIntAscending);
+        double library = nowSeconds() - start;
+
+        printf("%12s %12.1f %12.1f %12.1f %9.2fx\n", reverse ? "descending" : "ascending", n / runtime / 1e6,
+               n / specialized / 1e6, n / library / 1e6, runtime / specialized);
+    }
+    free(input);
+    free(arr);
+    free(expected);
+
+    BenchRecord* recordInput = (BenchRecord*)malloc(n * sizeof(BenchRecord));
+    BenchRecord* records = (BenchRecord*)malloc(n * sizeof(BenchRecord));
+    BenchRecord* scratch = (BenchRecord*)malloc(n * sizeof(BenchRecord));
+    for (size_t i = 0; i < n; i++) {
+        // Few distinct keys, so the stable sort's order of equal keys is visible
+        recordInput[i].key = (int64_t)(benchRandom(&state) % (n / 4 + 1));
+        recordInput[i].payload = (int64_t)i;
+    }
+
+    memcpy(records, recordInput, n * sizeof(BenchRecord));
+    double start = nowSeconds();
+    benchRecordsByKeySort(records, n);
+    double introsort = nowSeconds() - start;
+
+    memcpy(records, recordInput, n * sizeof(BenchRecord));
+    start = nowSeconds();
+    benchRecordsByKeyStableSort(records, n, scratch);
+    double stable = nowSeconds() - start;
+    for (size_t i = 1; i < n; i++) {
+        if (records[i - 1].key > records[i].key ||
+            (records[i - 1].key == records[i].key && records[i - 1].payload > records[i].payload)) {
+            printf("stable sort out of order at %zu\n", i);
+            return 1;
+        }
+    }
+
+    memcpy(records, recordInput, n * sizeof(BenchRecord));
+    start = nowSeconds();
+    qsort(records, n, sizeof(BenchRecord), compareRecords);
+    double library = nowSeconds() - start;
+
+    printf("\n%zu 16-byte records by key, million records/s\n", n);
+    printf("%12s %12s %12s\n", "introsort", "stable", "qsort");
+    printf("%12.1f %12.1f %12.1f\n", n / introsort / 1e6, n / stable / 1e6, n / library / 1e6);
+
+    free(recordInput);
+    free(records);
+    free(scratch);
+    return 0;
+}
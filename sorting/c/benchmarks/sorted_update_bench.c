@@ -0,0 +1,141 @@
+/**
+ * Sorted Update - Benchmark
+ *
+ * Measures the cost of one update of a large sorted integer array for
+ * several batch sizes:
+ * - re-sort:  append the batch and run mergeSortIntWide over everything
+ * - insert:   sortedInsertInt (sort the batch, gallop-merge it in place)
+ * - delete:   sortedDeleteInt with a delete set of the same size
+ *
+ * Before timing, batches of equal strings stored at distinct addresses
+ * are inserted with sortedInsertString to check that equal keys keep
+ * insertion order.
+ *
+ * Build and run:
+ *   cc -O2 -o sorted_update_bench sorted_update_bench.c
+ *   ./sorted_update_bench [array size]
+ */
+
+#define SORTING_NO_MAIN
+#include "../sorted_update.c"
+
+#include <time.h>
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * xorshift64* generator, so every run sees the same inputs.
+ */
+static uint64_t benchRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+/**
+ * Inserts batches of strings drawn from a few values and checks that equal
+ * strings stay in insertion order, which here is ascending address order.
+ *
+ * @return false if the order is wrong
+ */
+static bool benchStableStrings(bool reverse) {
+    enum { BATCHES = 20, BATCH = 1000 };
+    static char values[BATCHES * BATCH][2];
+    char* batch[BATCH];
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    SortedStringArray arr = SORTED_ARRAY_INIT;
+    for (int b = 0; b < BATCHES; b++) {
+        for (int i = 0; i < BATCH; i++) {
+            char* value = values[b * BATCH + i];
+            value[0] = (char)('a' + benchRandom(&state) % 8);
+            batch[i] = value;
+        }
+        if (sortedInsertString(&arr, batch, BATCH, reverse) != 0) {
+            sortedStringArrayFree(&arr);
+            return false;
+        }
+    }
+    bool stable = arr.count == BATCHES * BATCH;
+    for (size_t i = 1; stable && i < arr.count; i++) {
+        int cmp = strcmp(arr.data[i - 1], arr.data[i]);
+        cmp = reverse ? -cmp : cmp;
+        stable = cmp < 0 || (cmp == 0 && arr.data[i - 1] < arr.data[i]);
+    }
+    sortedStringArrayFree(&arr);
+    return stable;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? (size_t)atol(argv[1]) : 10000000;
+    size_t batchSizes[] = {1, 10, 100, 1000, 10000, 100000};
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+
+    if (!benchStableStrings(false) || !benchStableStrings(true)) {
+        printf("equal strings lost their insertion order\n");
+        return 1;
+    }
+
+    // The sorted base array, with room for the largest batch
+    int* base = (int*)malloc((n + 100000) * sizeof(int));
+    for (size_t i = 0; i < n; i++) {
+        base[i] = (int)(benchRandom(&state) >> 33);
+    }
+    sortIntWide(base, n, false);
+
+    SortedIntArray arr = SORTED_ARRAY_INIT;
+    sortedIntArrayReserve(&arr, n + 100000);
+    int* batch = (int*)malloc(100000 * sizeof(int));
+
+    printf("array of %zu sorted keys\n", n);
+    printf("%8s %14s %14s %14s %10s\n", "batch", "re-sort us", "insert us", "delete us", "speedup");
+    for (int b = 0; b < 6; b++) {
+        size_t m = batchSizes[b];
+        int updates = m <= 100 ? 20 : 5;
+        double resort = 0, insert = 0, erase = 0;
+
+        for (int u = 0; u < updates; u++) {
+            for (size_t i = 0; i < m; i++) {
+                batch[i] = (int)(benchRandom(&state) >> 33);
+            }
+
+            // Today's approach: append and sort everything again
+            memcpy(arr.data, base, n * sizeof(int));
+            memcpy(arr.data + n, batch, m * sizeof(int));
+            double start = nowSeconds();
+            mergeSortIntWide(arr.data, n + m, false);
+            resort += nowSeconds() - start;
+
+            memcpy(arr.data, base, n * sizeof(int));
+            arr.count = n;
+            start = nowSeconds();
+            sortedInsertInt(&arr, batch, m, false);
+            insert += nowSeconds() - start;
+
+            // Delete the same keys again (the batch is sorted by now)
+            start = nowSeconds();
+            size_t removed = sortedDeleteInt(&arr, batch, m, false);
+            erase += nowSeconds() - start;
+
+            if (removed != m || arr.count != n || memcmp(arr.data, base, n * sizeof(int)) != 0) {
+                printf("batch %zu: update mismatch\n", m);
+                return 1;
+            }
+        }
+
+        printf("%8zu %14.1f %14.1f %14.1f %9.0fx\n", m, resort / updates * 1e6, insert / updates * 1e6,
+               erase / updates * 1e6, resort / insert);
+    }
+
+    sortedIntArrayFree(&arr);
+    free(base);
+    free(batch);
+    return 0;
+}
@@ -0,0 +1,217 @@
+/**
+ * String Table Sort - Benchmark
+ *
+ * n strings of 8 to 32 lowercase letters, sharing a few common prefixes,
+ * arrive as one byte buffer with 32-bit offsets. Reports seconds,
+ * million strings per second and the memory used besides the input for:
+ * - char**:   copying every string into its own malloc'd, NUL-terminated
+ *             buffer and sorting the pointers with sortStringWide; memory
+ *             is the pointers, the usable size of every allocation and the
+ *             sort's scratch
+ * - perm:     stringTableSort, returning the row permutation; memory is
+ *             the permutation plus the workspace
+ * - compact:  stringTableSortCompact, writing the strings in sorted order
+ *             into a new buffer; memory is the new table plus the workspace
+ *
+ * and the seconds one scan over all strings in sorted order takes
+ * afterwards (summing their bytes), through the pointers, through the
+ * permutation, and over the compacted buffer.
+ *
+ * Last it sorts 3000 strings that are all prefixes of one another, "a" * k
+ * with or without a trailing "b", in both directions and checks the order;
+ * their MSD recursion used to go one level per shared byte and overflow
+ * the stack.
+ *
+ * Build and run:
+ *   cc -O2 -o string_table_bench string_table_bench.c
+ *   ./string_table_bench [n]
+ */
+
+#define SORTING_NO_MAIN
+#include "../adaptive_sort.c"
+#include "../string_table_sort.c"
+
+#include <malloc.h>
+#include <time.h>
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * xorshift64* generator, so every run sees the same inputs.
+ */
+static uint64_t benchRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+/**
+ * Sorts count strings "a" * k, every other one followed by "b", for a
+ * shuffled k below count and checks their order.
+ * @return true if the order is right
+ */
+static bool benchNestedPrefixes(size_t count, bool reverse) {
+    uint32_t* offsets = (uint32_t*)malloc((count + 1) * sizeof(uint32_t));
+    unsigned char* data = (unsigned char*)malloc(count * (count + 1) + 1);
+    uint32_t* perm = (uint32_t*)malloc(count * sizeof(uint32_t));
+    size_t length = 0;
+    offsets[0] = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t k = (i * 7919) % count;
+        memset(data + length, 'a', k);
+        length += k;
+        if (i % 2 == 1) {
+            data[length++] = 'b';
+        }
+        offsets[i + 1] = (uint32_t)length;
+    }
+    bool ok = stringTableSort(data, offsets, count, reverse, perm, NULL) == 0;
+    for (size_t i = 1; ok && i < count; i++) {
+        size_t a = offsets[perm[i - 1] + 1] - offsets[perm[i - 1]];
+        size_t b = offsets[perm[i] + 1] - offsets[perm[i]];
+        int cmp = memcmp(data + offsets[perm[i - 1]], data + offsets[perm[i]], a < b ? a : b);
+        cmp = cmp != 0 ? cmp : (a > b) - (a < b);
+        ok = reverse ? cmp > 0 : cmp < 0;
+    }
+    free(offsets);
+    free(data);
+    free(perm);
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 10000000;
+    static const char* prefixes[] = {"user_", "order_", "item_", "session_", "", "", "", ""};
+
+    // Build the input table
+    uint32_t* offsets = (uint32_t*)malloc((n + 1) * sizeof(uint32_t));
+    unsigned char* data = (unsigned char*)malloc(n * 41 + 1);
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    size_t length = 0;
+    offsets[0] = 0;
+    for (size_t i = 0; i < n; i++) {
+        const char* prefix = prefixes[benchRandom(&state) % 8];
+        size_t prefixLength = strlen(prefix);
+        memcpy(data + length, prefix, prefixLength);
+        length += prefixLength;
+        size_t letters = 8 + benchRandom(&state) % 25;
+        for (size_t b = 0; b < letters; b++) {
+            data[length++] = (unsigned char)('a' + benchRandom(&state) % 26);
+        }
+        offsets[i + 1] = (uint32_t)length;
+    }
+
+    // char**: one allocation per string, then the pointer sort
+    double start = nowSeconds();
+    char** strings = (char**)malloc(n * sizeof(char*));
+    size_t pointerMemory = n * sizeof(char*);
+    for (size_t i = 0; i < n; i++) {
+        size_t size = offsets[i + 1] - offsets[i];
+        strings[i] = (char*)malloc(size + 1);
+        memcpy(strings[i], data + offsets[i], size);
+        strings[i][size] = '\0';
+        pointerMemory += malloc_usable_size(strings[i]);
+    }
+    double convertTime = nowSeconds() - start;
+    start = nowSeconds();
+    sortStringWide(strings, n, false);
+    double pointerSortTime = nowSeconds() - start;
+    // The merge sort behind sortStringWide takes its scratch from the per-thread workspace
+    pointerMemory += sortWorkspaceThreadLocal()->capacity;
+
+    // perm: the permutation over the table
+    SortWorkspace ws = SORT_WORKSPACE_INIT;
+    uint32_t* perm = (uint32_t*)malloc(n * sizeof(uint32_t));
+    start = nowSeconds();
+    if (stringTableSort(data, offsets, n, false, perm, &ws) != 0) {
+        perror("stringTableSort");
+        return 1;
+    }
+    double permTime = nowSeconds() - start;
+    size_t permMemory = n * sizeof(uint32_t) + ws.capacity;
+
+    // compact: a new table in sorted order
+    unsigned char* sorted = (unsigned char*)malloc(length + 1);
+    uint32_t* sortedOffsets = (uint32_t*)malloc((n + 1) * sizeof(uint32_t));
+    memset(sorted, 0, length + 1);
+    memset(sortedOffsets, 0, (n + 1) * sizeof(uint32_t));
+    start = nowSeconds();
+    if (stringTableSortCompact(data, offsets, n, false, sorted, sortedOffsets, &ws) != 0) {
+        perror("stringTableSortCompact");
+        return 1;
+    }
+    double compactTime = nowSeconds() - start;
+    size_t compactMemory = length + (n + 1) * sizeof(uint32_t) + ws.capacity;
+
+    for (size_t i = 0; i < n; i++) {
+        size_t size = offsets[perm[i] + 1] - offsets[perm[i]];
+        if (strlen(strings[i]) != size || memcmp(strings[i], data + offsets[perm[i]], size) != 0 ||
+            sortedOffsets[i + 1] - sortedOffsets[i] != size ||
+            memcmp(sorted + sortedOffsets[i], strings[i], size) != 0) {
+            printf("order mismatch at %zu\n", i);
+            return 1;
+        }
+    }
+
+    // One scan in sorted order over each result
+    uint64_t sums[3] = {0, 0, 0};
+    start = nowSeconds();
+    for (size_t i = 0; i < n; i++) {
+        for (const char* s = strings[i]; *s != '\0'; s++) {
+            sums[0] += (unsigned char)*s;
+        }
+    }
+    double pointerScan = nowSeconds() - start;
+    start = nowSeconds();
+    for (size_t i = 0; i < n; i++) {
+        for (uint32_t b = offsets[perm[i]]; b < offsets[perm[i] + 1]; b++) {
+            sums[1] += data[b];
+        }
+    }
+    double permScan = nowSeconds() - start;
+    start = nowSeconds();
+    for (size_t i = 0; i < n; i++) {
+        for (uint32_t b = sortedOffsets[i]; b < sortedOffsets[i + 1]; b++) {
+            sums[2] += sorted[b];
+        }
+    }
+    double compactScan = nowSeconds() - start;
+    if (sums[0] != sums[1] || sums[1] != sums[2]) {
+        printf("scan mismatch\n");
+        return 1;
+    }
+
+    printf("%zu strings, %.1f bytes on average\n", n, (double)length / (n > 0 ? n : 1));
+    printf("%10s %10s %10s %10s %12s %10s\n", "path", "prepare s", "sort s", "Mstr/s", "memory MB", "scan s");
+    printf("%10s %10.3f %10.3f %10.2f %12.1f %10.3f\n", "char**", convertTime, pointerSortTime,
+           n / (convertTime + pointerSortTime) / 1e6, pointerMemory / 1e6, pointerScan);
+    printf("%10s %10.3f %10.3f %10.2f %12.1f %10.3f\n", "perm", 0.0, permTime, n / permTime / 1e6,
+           permMemory / 1e6, permScan);
+    printf("%10s %10.3f %10.3f %10.2f %12.1f %10.3f\n", "compact", 0.0, compactTime, n / compactTime / 1e6,
+           compactMemory / 1e6, compactScan);
+    if (!benchNestedPrefixes(3000, false) || !benchNestedPrefixes(3000, true)) {
+        printf("nested prefixes: wrong order\n");
+        return 1;
+    }
+    printf("nested prefixes: ok\n");
+
+    for (size_t i = 0; i < n; i++) {
+        free(strings[i]);
+    }
+    free(strings);
+    sortWorkspaceFree(&ws);
+    free(perm);
+    free(sorted);
+    free(sortedOffsets);
+    free(offsets);
+    free(data);
+    return 0;
+}
@@ -0,0 +1,130 @@
+/**
+ * Sort Workspace - Benchmark
+ *
+ * Measures calls per second of many small sorts (n = 16..4096) and counts
+ * the heap allocations each call performs. In-place algorithms are called
+ * directly; merge sort and radix sort are called through their plain entry
+ * point (one private workspace per call) and through the workspace variant
+ * with a reused workspace, which should report zero allocations per call.
+ *
+ * Build and run:
+ *   cc -O2 -o workspace_bench workspace_bench.c
+ *   ./workspace_bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static size_t allocationCount = 0;
+
+static void* countingMalloc(size_t size) {
+    allocationCount++;
+    return malloc(size);
+}
+
+static void* countingCalloc(size_t count, size_t size) {
+    allocationCount++;
+    return calloc(count, size);
+}
+
+static void* countingAlignedAlloc(size_t alignment, size_t size) {
+    allocationCount++;
+    return aligned_alloc(alignment, size);
+}
+
+// Route every allocation made by the sorting code through the counters
+#define malloc(size) countingMalloc(size)
+#define calloc(count, size) countingCalloc(count, size)
+#define aligned_alloc(alignment, size) countingAlignedAlloc(alignment, size)
+
+#define SORTING_NO_MAIN
+#include "../bubble_sort.c"
+#include "../heap_sort.c"
+#include "../insertion_sort.c"
+#include "../merge_sort.c"
+#include "../quicksort.c"
+#include "../radix_sort.c"
+#include "../selection_sort.c"
+
+#undef malloc
+#undef calloc
+#undef aligned_alloc
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static SortWorkspace sharedWorkspace = SORT_WORKSPACE_INIT;
+
+static void mergeSortShared(int arr[], int n, bool reverse) {
+    mergeSortIntWorkspace(arr, n, reverse, &sharedWorkspace);
+}
+
+static void radixSortShared(int arr[], int n, bool reverse) {
+    radixSortWorkspace(arr, n, reverse, &sharedWorkspace);
+}
+
+typedef struct {
+    const char* name;
+    void (*sort)(int arr[], int n, bool reverse);
+    int maxN;  // Skip sizes where the algorithm is too slow to be interesting
+} Engine;
+
+int main(void) {
+    Engine engines[] = {
+        {"quicksortInt", quicksortInt, 4096},
+        {"heapSortInt", heapSortInt, 4096},
+        {"insertionSortInt", insertionSortInt, 1024},
+        {"bubbleSortInt", bubbleSortInt, 256},
+        {"selectionSortInt", selectionSortInt, 256},
+        {"mergeSortInt", mergeSortInt, 4096},
+        {"mergeSortIntWorkspace", mergeSortShared, 4096},
+        {"radixSort", radixSort, 4096},
+        {"radixSortWorkspace", radixSortShared, 4096},
+    };
+    int engineCount = sizeof(engines) / sizeof(engines[0]);
+    int sizes[] = {16, 64, 256, 1024, 4096};
+
+    // Each call starts from a slightly shifted window of the same random input
+    int* input = (int*)malloc((4096 + 16) * sizeof(int));
+    int* arr = (int*)malloc(4096 * sizeof(int));
+    srand(42);
+    for (int i = 0; i < 4096 + 16; i++) {
+        input[i] = rand() % 1000000;
+    }
+
+    printf("%-24s %6s %14s %12s\n", "engine", "n", "calls/sec", "allocs/call");
+    for (int e = 0; e < engineCount; e++) {
+        for (int s = 0; s < 5; s++) {
+            int n = sizes[s];
+            if (n > engines[e].maxN) {
+                continue;
+            }
+
+            // Aim for roughly the same total work at every size
+            int calls = (int)(4000000 / n) + 1;
+            allocationCount = 0;
+            double start = nowSeconds();
+            for (int c = 0; c < calls; c++) {
+                memcpy(arr, input + c % 16, n * sizeof(int));
+                engines[e].sort(arr, n, false);
+            }
+            double elapsed = nowSeconds() - start;
+
+            printf("%-24s %6d %14.0f %12.2f\n", engines[e].name, n,
+                   calls / elapsed, (double)allocationCount / calls);
+        }
+    }
+
+    sortWorkspaceFree(&sharedWorkspace);
+    free(input);
+    free(arr);
+    return 0;
+}
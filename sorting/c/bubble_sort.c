@@ -13,11 +13,17 @@
  * The algorithm traverses the array multiple times, "bubbling" the largest element to the end in each pass.
  */
 
+#ifndef BUBBLE_SORT_C
+#define BUBBLE_SORT_C
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 
+#include "sort_index.h"
+#include "sort_stats.h"
+
 /**
  * Implementation of the Bubble Sort algorithm for integers.
  * 
@@ -26,12 +32,6 @@
  * @param reverse If true, sorts in descending order; if false, in ascending order
  */
 void bubbleSortInt(int arr[], int n, bool reverse) {
-    // Use a copy of the array to avoid modifying the original
-    int* result = (int*)malloc(n * sizeof(int));
-    for (int i = 0; i < n; i++) {
-        result[i] = arr[i];
-    }
-    
     // Optimization flag: if no swaps are made in a pass, the array is already sorted
     for (int i = 0; i < n; i++) {
         bool swapped = false;
@@ -40,11 +40,13 @@ void bubbleSortInt(int arr[], int n, bool reverse) {
         // Therefore, we don't need to check the last i elements
         for (int j = 0; j < n - i - 1; j++) {
             // Comparison based on sort direction
-            if ((!reverse && result[j] > result[j + 1]) || (reverse && result[j] < result[j + 1])) {
+            SORT_STAT_COMPARE();
+            if ((!reverse && arr[j] > arr[j + 1]) || (reverse && arr[j] < arr[j + 1])) {
                 // Swap elements
-                int temp = result[j];
-                result[j] = result[j + 1];
-                result[j + 1] = temp;
+                int temp = arr[j];
+                arr[j] = arr[j + 1];
+                arr[j + 1] = temp;
+                SORT_STAT_SWAP();
                 swapped = true;
             }
         }
@@ -54,14 +56,6 @@ void bubbleSortInt(int arr[], int n, bool reverse) {
             break;
         }
     }
-    
-    // Copy the result back to the original array
-    for (int i = 0; i < n; i++) {
-        arr[i] = result[i];
-    }
-    
-    // Free allocated memory
-    free(result);
 }
 
 /**
@@ -72,23 +66,19 @@ void bubbleSortInt(int arr[], int n, bool reverse) {
  * @param reverse If true, sorts in descending order; if false, in ascending order
  */
 void bubbleSortString(char* arr[], int n, bool reverse) {
-    // Use a copy of the array to avoid modifying the original
-    char** result = (char**)malloc(n * sizeof(char*));
-    for (int i = 0; i < n; i++) {
-        result[i] = arr[i];
-    }
-    
     for (int i = 0; i < n; i++) {
         bool swapped = false;
         
         for (int j = 0; j < n - i - 1; j++) {
             // Comparison based on sort direction
-            if ((!reverse && strcmp(result[j], result[j + 1]) > 0) || 
-                (reverse && strcmp(result[j], result[j + 1]) < 0)) {
+            SORT_STAT_COMPARE();
+            if ((!reverse && strcmp(arr[j], arr[j + 1]) > 0) || 
+                (reverse && strcmp(arr[j], arr[j + 1]) < 0)) {
                 // Swap elements
-                char* temp = result[j];
-                result[j] = result[j + 1];
-                result[j + 1] = temp;
+                char* temp = arr[j];
+                arr[j] = arr[j + 1];
+                arr[j + 1] = temp;
+                SORT_STAT_SWAP();
                 swapped = true;
             }
         }
@@ -97,16 +87,78 @@ void bubbleSortString(char* arr[], int n, bool reverse) {
             break;
         }
     }
-    
-    // Copy the result back to the original array
-    for (int i = 0; i < n; i++) {
-        arr[i] = result[i];
+}
+
+/**
+ * Bubble Sort for integers with a size_t element count.
+ * Arrays that fit in an int index are sorted by bubbleSortInt.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void bubbleSortIntWide(int arr[], size_t n, bool reverse) {
+    if (sortFitsInt(n)) {
+        bubbleSortInt(arr, (int)n, reverse);
+        return;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        bool swapped = false;
+
+        for (size_t j = 0; j + 1 < n - i; j++) {
+            SORT_STAT_COMPARE();
+            if (reverse ? arr[j] < arr[j + 1] : arr[j] > arr[j + 1]) {
+                int temp = arr[j];
+                arr[j] = arr[j + 1];
+                arr[j + 1] = temp;
+                SORT_STAT_SWAP();
+                swapped = true;
+            }
+        }
+
+        if (!swapped) {
+            break;
+        }
+    }
+}
+
+/**
+ * Bubble Sort for strings with a size_t element count.
+ *
+ * @param arr String array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void bubbleSortStringWide(char* arr[], size_t n, bool reverse) {
+    if (sortFitsInt(n)) {
+        bubbleSortString(arr, (int)n, reverse);
+        return;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        bool swapped = false;
+
+        for (size_t j = 0; j + 1 < n - i; j++) {
+            SORT_STAT_COMPARE();
+            int cmp = strcmp(arr[j], arr[j + 1]);
+            if (reverse ? cmp < 0 : cmp > 0) {
+                char* temp = arr[j];
+                arr[j] = arr[j + 1];
+                arr[j + 1] = temp;
+                SORT_STAT_SWAP();
+                swapped = true;
+            }
+        }
+
+        if (!swapped) {
+            break;
+        }
     }
-    
-    // Free allocated memory
-    free(result);
 }
 
+#ifndef SORTING_NO_MAIN
+
 /**
  * Function to print an integer array.
  */
@@ -187,3 +239,7 @@ int main() {
     
     return 0;
 }
+
+#endif /* SORTING_NO_MAIN */
+
+#endif /* BUBBLE_SORT_C */
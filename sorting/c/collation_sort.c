@@ -0,0 +1,307 @@
+/**
+ * Collation Sort - Sorting Strings by Precomputed Sort Keys
+ *
+ * Time Complexity:
+ * - Key generation: O(total string bytes), one strxfrm or one pass per string
+ * - Sorting: that of stringTableSortWide over the keys, no collation calls
+ *
+ * Space Complexity: O(total key bytes) for the key arena, plus the scratch of
+ * stringTableSortWide and 16 bytes per string
+ *
+ * How it works:
+ * Sorting with strcoll as the comparator redoes the locale's multi-level
+ * collation work on every comparison, for the same strings over and over.
+ * Instead, every string is transformed once into a binary sort key whose
+ * byte-wise order is the requested order; the keys are sorted with the byte
+ * string engine and then dropped:
+ * 1. Append the key of every string to one arena buffer, recording its
+ *    offsets, so there is no allocation per string:
+ *    - COLLATION_LOCALE: the strxfrm transform for the current LC_COLLATE,
+ *      so the order is exactly that of strcoll
+ *    - COLLATION_CASE_INSENSITIVE: the bytes with ASCII letters lowercased
+ *    - COLLATION_NATURAL: runs of digits are compared as numbers, so
+ *      "file2" < "file10". A run becomes a '0' byte, the count of its
+ *      significant digits (one byte, or 0xFF and 8 big-endian bytes), and
+ *      the significant digits: shorter numbers sort first, then digit by
+ *      digit. Leading zeros are ignored, so "a01" and "a1" are equal
+ *    - COLLATION_NATURAL_CASE_INSENSITIVE: both of the above
+ * 2. Sort the keys with stringTableSortWide (MSD radix), which is stable,
+ *    so strings with equal keys keep their input order
+ * 3. Permute the string pointers and free the keys
+ */
+
+#ifndef COLLATION_SORT_C
+#define COLLATION_SORT_C
+
+#ifndef SORTING_NO_MAIN
+#define SORTING_NO_MAIN
+#define COLLATION_SORT_MAIN
+#endif
+
+#include "string_table_sort.c"
+
+#include <locale.h>
+
+/**
+ * How strings are ordered.
+ */
+typedef enum {
+    COLLATION_LOCALE,                    // strcoll order of the current LC_COLLATE
+    COLLATION_CASE_INSENSITIVE,          // Byte order with ASCII letters folded to lowercase
+    COLLATION_NATURAL,                   // Byte order with digit runs compared as numbers
+    COLLATION_NATURAL_CASE_INSENSITIVE   // Both of the above
+} CollationMode;
+
+/**
+ * Sort keys in one arena: the key of string i is data[offsets[i]..offsets[i + 1]).
+ */
+typedef struct {
+    unsigned char* data;
+    uint64_t* offsets;  // count + 1 entries
+    size_t count;
+    size_t capacity;    // Bytes allocated for data
+} CollationKeys;
+
+#define COLLATION_KEYS_INIT {NULL, NULL, 0, 0}
+
+/**
+ * Makes room for extra more bytes after the first used bytes of the arena.
+ *
+ * @return 0 on success, -1 with errno set to ENOMEM
+ */
+static int collationReserve(CollationKeys* keys, size_t used, size_t extra) {
+    if (used + extra <= keys->capacity) {
+        return 0;
+    }
+    size_t capacity = keys->capacity * 2 > used + extra ? keys->capacity * 2 : used + extra;
+    unsigned char* data = (unsigned char*)realloc(keys->data, capacity);
+    if (data == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    keys->data = data;
+    keys->capacity = capacity;
+    return 0;
+}
+
+/**
+ * Lowercases an ASCII letter if fold is set.
+ */
+static inline unsigned char collationFold(unsigned char c, bool fold) {
+    return fold && c >= 'A' && c <= 'Z' ? (unsigned char)(c - 'A' + 'a') : c;
+}
+
+/**
+ * Writes the byte-wise key of s (COLLATION_CASE_INSENSITIVE and the natural
+ * modes) to out, which has room for collationByteKeyMax(strlen(s)) bytes.
+ *
+ * @return The key length
+ */
+static size_t collationByteKey(const unsigned char* s, bool natural, bool fold, unsigned char* out) {
+    unsigned char* start = out;
+    while (*s != '\0') {
+        if (!natural || *s < '0' || *s > '9') {
+            *out++ = collationFold(*s++, fold);
+            continue;
+        }
+
+        while (*s == '0') {
+            s++;
+        }
+        const unsigned char* digits = s;
+        while (*s >= '0' && *s <= '9') {
+            s++;
+        }
+        size_t significant = (size_t)(s - digits);
+        // The marker sorts a number where its first digit would sort among other bytes
+        *out++ = '0';
+        if (significant < 0xFF) {
+            *out++ = (unsigned char)significant;
+        } else {
+            *out++ = 0xFF;
+            for (int b = 7; b >= 0; b--) {
+                *out++ = (unsigned char)((uint64_t)significant >> (8 * b));
+            }
+        }
+        memcpy(out, digits, significant);
+        out += significant;
+    }
+    return (size_t)(out - start);
+}
+
+/**
+ * Upper bound of the byte-wise key length of a string of length bytes:
+ * a run of one digit grows to three bytes, longer runs grow less.
+ */
+static inline size_t collationByteKeyMax(size_t length) {
+    return 3 * length;
+}
+
+/**
+ * Frees sort keys; the struct can be reused afterwards.
+ */
+void collationKeysFree(CollationKeys* keys) {
+    free(keys->data);
+    free(keys->offsets);
+    keys->data = NULL;
+    keys->offsets = NULL;
+    keys->count = 0;
+    keys->capacity = 0;
+}
+
+/**
+ * Computes the sort key of every string into one arena.
+ *
+ * @param arr Strings to compute keys for
+ * @param n Number of strings
+ * @param mode Ordering the keys encode
+ * @param keys Receives the keys; free with collationKeysFree
+ * @return 0 on success, -1 with errno set to ENOMEM on failure
+ */
+int collationKeysBuild(const char* const arr[], size_t n, CollationMode mode, CollationKeys* keys) {
+    *keys = (CollationKeys)COLLATION_KEYS_INIT;
+    keys->offsets = (uint64_t*)malloc((n + 1) * sizeof(uint64_t));
+    if (keys->offsets == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    keys->count = n;
+
+    // Start from the input size; locale keys are usually larger and grow the arena a few times
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        total += strlen(arr[i]) + 1;
+    }
+    if (collationReserve(keys, 0, total + 1) != 0) {
+        collationKeysFree(keys);
+        return -1;
+    }
+
+    bool natural = mode == COLLATION_NATURAL || mode == COLLATION_NATURAL_CASE_INSENSITIVE;
+    bool fold = mode == COLLATION_CASE_INSENSITIVE || mode == COLLATION_NATURAL_CASE_INSENSITIVE;
+    size_t used = 0;
+    keys->offsets[0] = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (mode == COLLATION_LOCALE) {
+            // strxfrm returns the full key length; if it did not fit, grow and transform again
+            size_t length = strxfrm((char*)keys->data + used, arr[i], keys->capacity - used);
+            if (length >= keys->capacity - used) {
+                if (collationReserve(keys, used, length + 1) != 0) {
+                    collationKeysFree(keys);
+                    return -1;
+                }
+                strxfrm((char*)keys->data + used, arr[i], length + 1);
+            }
+            used += length;
+        } else {
+            const unsigned char* s = (const unsigned char*)arr[i];
+            if (collationReserve(keys, used, collationByteKeyMax(strlen(arr[i]))) != 0) {
+                collationKeysFree(keys);
+                return -1;
+            }
+            used += collationByteKey(s, natural, fold, keys->data + used);
+        }
+        keys->offsets[i + 1] = used;
+    }
+    return 0;
+}
+
+/**
+ * Sorts strings by a collation and returns the permutation; the array
+ * itself is not modified.
+ *
+ * @param arr Strings to sort
+ * @param n Number of strings
+ * @param mode Ordering to sort by
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ * @param perm Receives the indices in sorted order; strings that collate
+ *             equal keep ascending indices
+ * @return 0 on success, -1 with errno set to ENOMEM on failure
+ */
+int collationArgsort(const char* const arr[], size_t n, CollationMode mode, bool reverse, uint64_t perm[]) {
+    CollationKeys keys;
+    if (collationKeysBuild(arr, n, mode, &keys) != 0) {
+        return -1;
+    }
+    int result = stringTableSortWide(keys.data, keys.offsets, n, reverse, perm, NULL);
+    collationKeysFree(&keys);
+    return result;
+}
+
+/**
+ * Sorts strings by a collation. With COLLATION_LOCALE the order is that of
+ * strcoll under the current LC_COLLATE, as set by setlocale.
+ *
+ * @param arr String array to be sorted
+ * @param n Size of the array
+ * @param mode Ordering to sort by
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ * @return 0 on success, -1 with errno set to ENOMEM on failure, leaving
+ *         the array unchanged
+ */
+int collationSortString(char* arr[], size_t n, CollationMode mode, bool reverse) {
+    if (n == 0) {
+        return 0;
+    }
+    uint64_t* perm = (uint64_t*)malloc(n * sizeof(uint64_t));
+    char** sorted = (char**)malloc(n * sizeof(char*));
+    if (perm == NULL || sorted == NULL) {
+        free(perm);
+        free(sorted);
+        errno = ENOMEM;
+        return -1;
+    }
+    if (collationArgsort((const char* const*)arr, n, mode, reverse, perm) != 0) {
+        free(perm);
+        free(sorted);
+        return -1;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        sorted[i] = arr[perm[i]];
+    }
+    memcpy(arr, sorted, n * sizeof(char*));
+    free(perm);
+    free(sorted);
+    return 0;
+}
+
+#ifdef COLLATION_SORT_MAIN
+
+/**
+ * Prints a string array on one line.
+ */
+static void printCollated(const char* label, char* arr[], size_t n) {
+    printf("%-26s", label);
+    for (size_t i = 0; i < n; i++) {
+        printf(" %s", arr[i]);
+    }
+    printf("\n");
+}
+
+/**
+ * Main function with examples.
+ */
+int main() {
+    char* files[] = {"file10.txt", "File2.txt", "file1.txt", "file02.txt", "Readme", "file2.txt", "apple"};
+    size_t n = sizeof(files) / sizeof(files[0]);
+
+    collationSortString(files, n, COLLATION_CASE_INSENSITIVE, false);
+    printCollated("Case-insensitive:", files, n);
+
+    collationSortString(files, n, COLLATION_NATURAL, false);
+    printCollated("Natural:", files, n);
+
+    collationSortString(files, n, COLLATION_NATURAL_CASE_INSENSITIVE, false);
+    printCollated("Natural, case-insensitive:", files, n);
+
+    // The environment's locale, as strcoll would use it
+    const char* locale = setlocale(LC_COLLATE, "");
+    collationSortString(files, n, COLLATION_LOCALE, false);
+    printCollated(locale != NULL ? locale : "C", files, n);
+    return 0;
+}
+
+#endif /* COLLATION_SORT_MAIN */
+
+#endif /* COLLATION_SORT_C */
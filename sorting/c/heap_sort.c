@@ -13,13 +13,42 @@
  * 1. Build a max heap (for ascending order) or min heap (for descending order) from the array
  * 2. Repeatedly extract the root element (which is the largest or smallest) and rebuild the heap
  * 3. The extracted elements form the sorted array
+ *
+ * The sorts are instantiated from sort_template.h once per direction, so
+ * their sift-down carries no reverse test; the heapify functions below keep
+ * the runtime flag as standalone heap primitives.
  */
 
+#ifndef HEAP_SORT_C
+#define HEAP_SORT_C
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 
+#include "sort_stats.h"
+
+#define SORT_TEMPLATE_NAME heapSortAscInt
+#define SORT_TEMPLATE_TYPE int
+#include "sort_template.h"
+
+#define SORT_TEMPLATE_NAME heapSortDescInt
+#define SORT_TEMPLATE_TYPE int
+#define SORT_TEMPLATE_DESCENDING
+#include "sort_template.h"
+
+#define SORT_TEMPLATE_NAME heapSortAscString
+#define SORT_TEMPLATE_TYPE char*
+#define SORT_TEMPLATE_COMPARE(a, b) strcmp(a, b)
+#include "sort_template.h"
+
+#define SORT_TEMPLATE_NAME heapSortDescString
+#define SORT_TEMPLATE_TYPE char*
+#define SORT_TEMPLATE_COMPARE(a, b) strcmp(a, b)
+#define SORT_TEMPLATE_DESCENDING
+#include "sort_template.h"
+
 /**
  * Helper function to maintain the heap property for integers.
  * 
@@ -29,6 +58,11 @@
  * @param reverse If true, creates a min heap; if false, creates a max heap
  */
 void heapifyInt(int arr[], int n, int i, bool reverse) {
+    // Nodes from n / 2 on are leaves; returning early also keeps 2 * i + 2 from overflowing
+    if (i >= n / 2) {
+        return;
+    }
+
     // Initialize the largest/smallest as the root
     int extreme = i;
     int left = 2 * i + 1;  // Left child
@@ -36,6 +70,7 @@ void heapifyInt(int arr[], int n, int i, bool reverse) {
     
     // Check if left child exists and is greater/smaller than the root
     if (left < n) {
+        SORT_STAT_COMPARE();
         if ((!reverse && arr[left] > arr[extreme]) || (reverse && arr[left] < arr[extreme])) {
             extreme = left;
         }
@@ -43,6 +78,7 @@ void heapifyInt(int arr[], int n, int i, bool reverse) {
     
     // Check if right child exists and is greater/smaller than the largest/smallest so far
     if (right < n) {
+        SORT_STAT_COMPARE();
         if ((!reverse && arr[right] > arr[extreme]) || (reverse && arr[right] < arr[extreme])) {
             extreme = right;
         }
@@ -54,9 +90,12 @@ void heapifyInt(int arr[], int n, int i, bool reverse) {
         int temp = arr[i];
         arr[i] = arr[extreme];
         arr[extreme] = temp;
+        SORT_STAT_SWAP();
         
         // Recursively heapify the affected sub-tree
+        SORT_STAT_ENTER();
         heapifyInt(arr, n, extreme, reverse);
+        SORT_STAT_LEAVE();
     }
 }
 
@@ -68,35 +107,12 @@ void heapifyInt(int arr[], int n, int i, bool reverse) {
  * @param reverse If true, sorts in descending order; if false, in ascending order
  */
 void heapSortInt(int arr[], int n, bool reverse) {
-    // Use a copy of the array to avoid modifying the original
-    int* result = (int*)malloc(n * sizeof(int));
-    for (int i = 0; i < n; i++) {
-        result[i] = arr[i];
+    // Max heap for ascending order, min heap for descending order
+    if (reverse) {
+        heapSortDescIntHeapSort(arr, n > 0 ? (size_t)n : 0);
+    } else {
+        heapSortAscIntHeapSort(arr, n > 0 ? (size_t)n : 0);
     }
-    
-    // Build a max heap (for ascending order) or min heap (for descending order)
-    for (int i = n / 2 - 1; i >= 0; i--) {
-        heapifyInt(result, n, i, reverse);
-    }
-    
-    // Extract elements one by one
-    for (int i = n - 1; i > 0; i--) {
-        // Swap the root (maximum/minimum element) with the last element
-        int temp = result[0];
-        result[0] = result[i];
-        result[i] = temp;
-        
-        // Call heapify on the reduced heap
-        heapifyInt(result, i, 0, reverse);
-    }
-    
-    // Copy the result back to the original array
-    for (int i = 0; i < n; i++) {
-        arr[i] = result[i];
-    }
-    
-    // Free allocated memory
-    free(result);
 }
 
 /**
@@ -108,6 +124,11 @@ void heapSortInt(int arr[], int n, bool reverse) {
  * @param reverse If true, creates a min heap; if false, creates a max heap
  */
 void heapifyString(char* arr[], int n, int i, bool reverse) {
+    // Nodes from n / 2 on are leaves; returning early also keeps 2 * i + 2 from overflowing
+    if (i >= n / 2) {
+        return;
+    }
+
     // Initialize the largest/smallest as the root
     int extreme = i;
     int left = 2 * i + 1;  // Left child
@@ -115,6 +136,7 @@ void heapifyString(char* arr[], int n, int i, bool reverse) {
     
     // Check if left child exists and is greater/smaller than the root
     if (left < n) {
+        SORT_STAT_COMPARE();
         if ((!reverse && strcmp(arr[left], arr[extreme]) > 0) || 
             (reverse && strcmp(arr[left], arr[extreme]) < 0)) {
             extreme = left;
@@ -123,6 +145,7 @@ void heapifyString(char* arr[], int n, int i, bool reverse) {
     
     // Check if right child exists and is greater/smaller than the largest/smallest so far
     if (right < n) {
+        SORT_STAT_COMPARE();
         if ((!reverse && strcmp(arr[right], arr[extreme]) > 0) || 
             (reverse && strcmp(arr[right], arr[extreme]) < 0)) {
             extreme = right;
@@ -135,9 +158,12 @@ void heapifyString(char* arr[], int n, int i, bool reverse) {
         char* temp = arr[i];
         arr[i] = arr[extreme];
         arr[extreme] = temp;
+        SORT_STAT_SWAP();
         
         // Recursively heapify the affected sub-tree
+        SORT_STAT_ENTER();
         heapifyString(arr, n, extreme, reverse);
+        SORT_STAT_LEAVE();
     }
 }
 
@@ -149,37 +175,116 @@ void heapifyString(char* arr[], int n, int i, bool reverse) {
  * @param reverse If true, sorts in descending order; if false, in ascending order
  */
 void heapSortString(char* arr[], int n, bool reverse) {
-    // Use a copy of the array to avoid modifying the original
-    char** result = (char**)malloc(n * sizeof(char*));
-    for (int i = 0; i < n; i++) {
-        result[i] = arr[i];
+    // Max heap for ascending order, min heap for descending order
+    if (reverse) {
+        heapSortDescStringHeapSort(arr, n > 0 ? (size_t)n : 0);
+    } else {
+        heapSortAscStringHeapSort(arr, n > 0 ? (size_t)n : 0);
     }
-    
-    // Build a max heap (for ascending order) or min heap (for descending order)
-    for (int i = n / 2 - 1; i >= 0; i--) {
-        heapifyString(result, n, i, reverse);
+}
+
+/**
+ * Sift-down for heaps with a size_t element count. Iterative, so the depth
+ * of a heap with billions of elements never reaches the call stack.
+ *
+ * @param arr Array to heapify
+ * @param n Size of the heap
+ * @param i Index of the current node
+ * @param reverse If true, creates a min heap; if false, creates a max heap
+ */
+void heapifyIntWide(int arr[], size_t n, size_t i, bool reverse) {
+    while (i < n / 2) {
+        size_t extreme = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+
+        SORT_STAT_COMPARE();
+        if (reverse ? arr[left] < arr[extreme] : arr[left] > arr[extreme]) {
+            extreme = left;
+        }
+        if (right < n) {
+            SORT_STAT_COMPARE();
+            if (reverse ? arr[right] < arr[extreme] : arr[right] > arr[extreme]) {
+                extreme = right;
+            }
+        }
+        if (extreme == i) {
+            return;
+        }
+
+        int temp = arr[i];
+        arr[i] = arr[extreme];
+        arr[extreme] = temp;
+        SORT_STAT_SWAP();
+        i = extreme;
     }
-    
-    // Extract elements one by one
-    for (int i = n - 1; i > 0; i--) {
-        // Swap the root (maximum/minimum element) with the last element
-        char* temp = result[0];
-        result[0] = result[i];
-        result[i] = temp;
-        
-        // Call heapify on the reduced heap
-        heapifyString(result, i, 0, reverse);
+}
+
+/**
+ * Heap Sort for integers with a size_t element count.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void heapSortIntWide(int arr[], size_t n, bool reverse) {
+    if (reverse) {
+        heapSortDescIntHeapSort(arr, n);
+    } else {
+        heapSortAscIntHeapSort(arr, n);
     }
-    
-    // Copy the result back to the original array
-    for (int i = 0; i < n; i++) {
-        arr[i] = result[i];
+}
+
+/**
+ * String version of heapifyIntWide.
+ */
+void heapifyStringWide(char* arr[], size_t n, size_t i, bool reverse) {
+    while (i < n / 2) {
+        size_t extreme = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+
+        SORT_STAT_COMPARE();
+        int cmp = strcmp(arr[left], arr[extreme]);
+        if (reverse ? cmp < 0 : cmp > 0) {
+            extreme = left;
+        }
+        if (right < n) {
+            SORT_STAT_COMPARE();
+            cmp = strcmp(arr[right], arr[extreme]);
+            if (reverse ? cmp < 0 : cmp > 0) {
+                extreme = right;
+            }
+        }
+        if (extreme == i) {
+            return;
+        }
+
+        char* temp = arr[i];
+        arr[i] = arr[extreme];
+        arr[extreme] = temp;
+        SORT_STAT_SWAP();
+        i = extreme;
     }
-    
-    // Free allocated memory
-    free(result);
 }
 
+/**
+ * Heap Sort for strings with a size_t element count.
+ *
+ * @param arr String array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void heapSortStringWide(char* arr[], size_t n, bool reverse) {
+    if (reverse) {
+        heapSortDescStringHeapSort(arr, n);
+    } else {
+        heapSortAscStringHeapSort(arr, n);
+    }
+}
+
+#ifndef SORTING_NO_MAIN
+
 /**
  * Function to print an integer array.
  */
@@ -260,3 +365,7 @@ int main() {
     
     return 0;
 }
+
+#endif /* SORTING_NO_MAIN */
+
+#endif /* HEAP_SORT_C */
@@ -13,13 +13,41 @@
  * The algorithm divides the array into a sorted part and an unsorted part.
  * In each iteration, it removes one element from the unsorted part and
  * inserts it into the correct position within the sorted part.
+ *
+ * The sorts are instantiated from sort_template.h once per direction, so
+ * the inner loop carries no reverse test.
  */
 
+#ifndef INSERTION_SORT_C
+#define INSERTION_SORT_C
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 
+#include "sort_stats.h"
+
+#define SORT_TEMPLATE_NAME insertionSortAscInt
+#define SORT_TEMPLATE_TYPE int
+#include "sort_template.h"
+
+#define SORT_TEMPLATE_NAME insertionSortDescInt
+#define SORT_TEMPLATE_TYPE int
+#define SORT_TEMPLATE_DESCENDING
+#include "sort_template.h"
+
+#define SORT_TEMPLATE_NAME insertionSortAscString
+#define SORT_TEMPLATE_TYPE char*
+#define SORT_TEMPLATE_COMPARE(a, b) strcmp(a, b)
+#include "sort_template.h"
+
+#define SORT_TEMPLATE_NAME insertionSortDescString
+#define SORT_TEMPLATE_TYPE char*
+#define SORT_TEMPLATE_COMPARE(a, b) strcmp(a, b)
+#define SORT_TEMPLATE_DESCENDING
+#include "sort_template.h"
+
 /**
  * Implementation of the Insertion Sort algorithm for integers.
  * 
@@ -28,45 +56,11 @@
  * @param reverse If true, sorts in descending order; if false, in ascending order
  */
 void insertionSortInt(int arr[], int n, bool reverse) {
-    // Use a copy of the array to avoid modifying the original
-    int* result = (int*)malloc(n * sizeof(int));
-    for (int i = 0; i < n; i++) {
-        result[i] = arr[i];
-    }
-    
-    // Start from the second element (index 1)
-    for (int i = 1; i < n; i++) {
-        // Element to be inserted into the sorted part
-        int key = result[i];
-        
-        // Move elements of the sorted part that are greater (or smaller) than key
-        // one position ahead of their current position
-        int j = i - 1;
-        if (!reverse) {
-            // Ascending order
-            while (j >= 0 && result[j] > key) {
-                result[j + 1] = result[j];
-                j--;
-            }
-        } else {
-            // Descending order
-            while (j >= 0 && result[j] < key) {
-                result[j + 1] = result[j];
-                j--;
-            }
-        }
-        
-        // Insert the element in the correct position
-        result[j + 1] = key;
+    if (reverse) {
+        insertionSortDescIntInsertionSort(arr, n > 0 ? (size_t)n : 0);
+    } else {
+        insertionSortAscIntInsertionSort(arr, n > 0 ? (size_t)n : 0);
     }
-    
-    // Copy the result back to the original array
-    for (int i = 0; i < n; i++) {
-        arr[i] = result[i];
-    }
-    
-    // Free allocated memory
-    free(result);
 }
 
 /**
@@ -77,47 +71,45 @@ void insertionSortInt(int arr[], int n, bool reverse) {
  * @param reverse If true, sorts in descending order; if false, in ascending order
  */
 void insertionSortString(char* arr[], int n, bool reverse) {
-    // Use a copy of the array to avoid modifying the original
-    char** result = (char**)malloc(n * sizeof(char*));
-    for (int i = 0; i < n; i++) {
-        result[i] = arr[i];
+    if (reverse) {
+        insertionSortDescStringInsertionSort(arr, n > 0 ? (size_t)n : 0);
+    } else {
+        insertionSortAscStringInsertionSort(arr, n > 0 ? (size_t)n : 0);
     }
-    
-    // Start from the second element (index 1)
-    for (int i = 1; i < n; i++) {
-        // Element to be inserted into the sorted part
-        char* key = result[i];
-        
-        // Move elements of the sorted part that are greater (or smaller) than key
-        // one position ahead of their current position
-        int j = i - 1;
-        if (!reverse) {
-            // Ascending order
-            while (j >= 0 && strcmp(result[j], key) > 0) {
-                result[j + 1] = result[j];
-                j--;
-            }
-        } else {
-            // Descending order
-            while (j >= 0 && strcmp(result[j], key) < 0) {
-                result[j + 1] = result[j];
-                j--;
-            }
-        }
-        
-        // Insert the element in the correct position
-        result[j + 1] = key;
+}
+
+/**
+ * Insertion Sort for integers with a size_t element count.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void insertionSortIntWide(int arr[], size_t n, bool reverse) {
+    if (reverse) {
+        insertionSortDescIntInsertionSort(arr, n);
+    } else {
+        insertionSortAscIntInsertionSort(arr, n);
     }
-    
-    // Copy the result back to the original array
-    for (int i = 0; i < n; i++) {
-        arr[i] = result[i];
+}
+
+/**
+ * Insertion Sort for strings with a size_t element count.
+ *
+ * @param arr String array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void insertionSortStringWide(char* arr[], size_t n, bool reverse) {
+    if (reverse) {
+        insertionSortDescStringInsertionSort(arr, n);
+    } else {
+        insertionSortAscStringInsertionSort(arr, n);
     }
-    
-    // Free allocated memory
-    free(result);
 }
 
+#ifndef SORTING_NO_MAIN
+
 /**
  * Function to print an integer array.
  */
@@ -198,3 +190,7 @@ int main() {
     
     return 0;
 }
+
+#endif /* SORTING_NO_MAIN */
+
+#endif /* INSERTION_SORT_C */
@@ -0,0 +1,379 @@
+/**
+ * Line Sort - sort(1)-style Command-Line Tool
+ *
+ * Usage:
+ *   line_sort [-r] [-u] [-n] [-o OUTPUT] [FILE...]
+ *
+ * Sorts the lines of the given files (or standard input) in byte order,
+ * like GNU sort with LC_ALL=C, using the merge sort engine from merge_sort.c.
+ *
+ * How it works:
+ * 1. Read all input into one large buffer, growing it geometrically
+ * 2. Replace every newline with a NUL and build a char* index into the buffer,
+ *    so no line is ever copied or allocated on its own
+ * 3. Sort the index with mergeSortStringBy (stable, one scratch array)
+ * 4. Write the lines back out through a large output buffer with few write calls
+ *
+ * Options:
+ *   -r  reverse the result of comparisons
+ *   -u  output only the first of a run of equal lines (equal keys with -n)
+ *   -n  compare by leading numeric value; ties fall back to byte order
+ *   -o  write the result to OUTPUT instead of standard output
+ */
+
+#ifndef LINE_SORT_C
+#define LINE_SORT_C
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+
+#ifndef SORTING_NO_MAIN
+#define SORTING_NO_MAIN
+#define LINE_SORT_MAIN
+#endif
+
+#include "merge_sort.c"
+
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Size of each read call and of the output buffer
+#define LINE_SORT_IO_SIZE (1 << 20)
+
+/**
+ * Input text and the index of lines pointing into it.
+ */
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+    char** lines;
+    int count;
+} LineTable;
+
+/**
+ * Appends the whole content of a file descriptor to the table buffer.
+ *
+ * @return 0 on success, -1 on failure with errno set
+ */
+int lineTableRead(LineTable* table, int fd) {
+    for (;;) {
+        // Keep one spare byte for a missing final newline
+        if (table->capacity - table->length < LINE_SORT_IO_SIZE + 1) {
+            size_t capacity = table->capacity ? table->capacity * 2 : 4 * LINE_SORT_IO_SIZE;
+            char* data = (char*)realloc(table->data, capacity);
+            if (data == NULL) {
+                return -1;
+            }
+            table->data = data;
+            table->capacity = capacity;
+        }
+
+        ssize_t got = read(fd, table->data + table->length, LINE_SORT_IO_SIZE);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (got == 0) {
+            return 0;
+        }
+        table->length += (size_t)got;
+    }
+}
+
+/**
+ * Terminates every line with a NUL and builds the char* index.
+ *
+ * @return 0 on success, -1 on failure with errno set
+ */
+int lineTableIndex(LineTable* table) {
+    if (table->data == NULL) {
+        return 0;
+    }
+
+    // Make sure the last line is terminated as well
+    if (table->length > 0 && table->data[table->length - 1] != '\n') {
+        table->data[table->length++] = '\n';
+    }
+
+    size_t lineCount = 0;
+    for (char* p = table->data; (p = memchr(p, '\n', table->data + table->length - p)) != NULL; p++) {
+        lineCount++;
+    }
+    if (lineCount > INT_MAX) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+
+    if (lineCount == 0) {
+        return 0;
+    }
+    table->lines = (char**)malloc(lineCount * sizeof(char*));
+    if (table->lines == NULL) {
+        return -1;
+    }
+
+    char* start = table->data;
+    char* end = table->data + table->length;
+    while (start < end) {
+        char* newline = memchr(start, '\n', end - start);
+        *newline = '\0';
+        table->lines[table->count++] = start;
+        start = newline + 1;
+    }
+    return 0;
+}
+
+/**
+ * Compares the leading numbers of two lines like sort -n in the C locale:
+ * optional blanks, an optional minus sign, digits and an optional fraction.
+ * Lines without a number compare as zero. Numbers of any length are compared
+ * digit by digit, without conversion.
+ */
+int compareNumericKey(const char* a, const char* b) {
+    while (*a == ' ' || *a == '\t') {
+        a++;
+    }
+    while (*b == ' ' || *b == '\t') {
+        b++;
+    }
+
+    bool negA = *a == '-';
+    bool negB = *b == '-';
+    a += negA;
+    b += negB;
+
+    // Skip leading zeros and measure the integer parts
+    while (*a == '0') {
+        a++;
+    }
+    while (*b == '0') {
+        b++;
+    }
+    size_t lenA = 0, lenB = 0;
+    while (a[lenA] >= '0' && a[lenA] <= '9') {
+        lenA++;
+    }
+    while (b[lenB] >= '0' && b[lenB] <= '9') {
+        lenB++;
+    }
+
+    // Check whether each side is zero, so that -0 equals 0
+    const char* fracA = a[lenA] == '.' ? a + lenA + 1 : a + lenA;
+    const char* fracB = b[lenB] == '.' ? b + lenB + 1 : b + lenB;
+    bool zeroA = lenA == 0 && strspn(fracA, "0") == strspn(fracA, "0123456789");
+    bool zeroB = lenB == 0 && strspn(fracB, "0") == strspn(fracB, "0123456789");
+    negA = negA && !zeroA;
+    negB = negB && !zeroB;
+
+    if (negA != negB) {
+        return negA ? -1 : 1;
+    }
+    int sign = negA ? -1 : 1;
+
+    // Longer integer part means larger magnitude
+    if (lenA != lenB) {
+        return lenA < lenB ? -sign : sign;
+    }
+    int cmp = memcmp(a, b, lenA);
+    if (cmp != 0) {
+        return cmp < 0 ? -sign : sign;
+    }
+
+    // Compare the fractions digit by digit, missing digits count as zero
+    if (a[lenA] != '.') {
+        fracA = "";
+    }
+    if (b[lenB] != '.') {
+        fracB = "";
+    }
+    for (;;) {
+        bool digitA = *fracA >= '0' && *fracA <= '9';
+        bool digitB = *fracB >= '0' && *fracB <= '9';
+        if (!digitA && !digitB) {
+            return 0;
+        }
+        char x = digitA ? *fracA++ : '0';
+        char y = digitB ? *fracB++ : '0';
+        if (x != y) {
+            return x < y ? -sign : sign;
+        }
+    }
+}
+
+/**
+ * Numeric comparison with a byte-wise last resort, as sort -n does.
+ */
+int compareNumericLine(const char* a, const char* b) {
+    int cmp = compareNumericKey(a, b);
+    return cmp != 0 ? cmp : strcmp(a, b);
+}
+
+/**
+ * Writes all of buf to fd, retrying on short writes.
+ *
+ * @return 0 on success, -1 on failure with errno set
+ */
+int writeAll(int fd, const char* buf, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, buf, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        buf += written;
+        length -= (size_t)written;
+    }
+    return 0;
+}
+
+/**
+ * Writes the sorted lines through a large buffer.
+ *
+ * @param keyCompare Comparator used to detect duplicates, or NULL to keep all lines
+ * @return 0 on success, -1 on failure with errno set
+ */
+int lineTableWrite(const LineTable* table, int fd, int (*keyCompare)(const char*, const char*)) {
+    char* out = (char*)malloc(LINE_SORT_IO_SIZE);
+    if (out == NULL) {
+        return -1;
+    }
+    size_t used = 0;
+
+    for (int i = 0; i < table->count; i++) {
+        const char* line = table->lines[i];
+        if (keyCompare != NULL && i > 0 && keyCompare(table->lines[i - 1], line) == 0) {
+            continue;
+        }
+
+        // Lines are NUL-terminated in place, so the length is still known cheaply
+        size_t length = strlen(line);
+        if (used + length + 1 > LINE_SORT_IO_SIZE) {
+            if (writeAll(fd, out, used) < 0) {
+                free(out);
+                return -1;
+            }
+            used = 0;
+        }
+
+        if (length + 1 > LINE_SORT_IO_SIZE) {
+            // The line does not fit the buffer at all: write it directly
+            if (writeAll(fd, line, length) < 0 || writeAll(fd, "\n", 1) < 0) {
+                free(out);
+                return -1;
+            }
+            continue;
+        }
+
+        memcpy(out + used, line, length);
+        used += length;
+        out[used++] = '\n';
+    }
+
+    int status = writeAll(fd, out, used);
+    free(out);
+    return status;
+}
+
+#ifdef LINE_SORT_MAIN
+
+/**
+ * Prints the command-line usage.
+ */
+static void printUsage(const char* program) {
+    fprintf(stderr, "Usage: %s [-r] [-u] [-n] [-o OUTPUT] [FILE...]\n", program);
+}
+
+/**
+ * Sorts the lines of the files given on the command line.
+ */
+int main(int argc, char* argv[]) {
+    bool reverse = false;
+    bool unique = false;
+    bool numeric = false;
+    const char* outputPath = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "runo:")) != -1) {
+        switch (opt) {
+            case 'r': reverse = true; break;
+            case 'u': unique = true; break;
+            case 'n': numeric = true; break;
+            case 'o': outputPath = optarg; break;
+            default:
+                printUsage(argv[0]);
+                return 2;
+        }
+    }
+
+    LineTable table = {0};
+
+    // Read every input into the same buffer
+    if (optind == argc) {
+        if (lineTableRead(&table, STDIN_FILENO) < 0) {
+            perror("stdin");
+            return 2;
+        }
+    }
+    for (int i = optind; i < argc; i++) {
+        int fd = strcmp(argv[i], "-") == 0 ? STDIN_FILENO : open(argv[i], O_RDONLY);
+        if (fd < 0 || lineTableRead(&table, fd) < 0) {
+            perror(argv[i]);
+            return 2;
+        }
+        if (fd != STDIN_FILENO) {
+            close(fd);
+        }
+        // Files that do not end with a newline must not run into the next one
+        if (table.length > 0 && table.data[table.length - 1] != '\n') {
+            table.data[table.length++] = '\n';
+        }
+    }
+
+    if (lineTableIndex(&table) < 0) {
+        perror("line index");
+        return 2;
+    }
+
+    // Like sort -u, unique mode drops the last-resort comparison, so the stable
+    // sort keeps the first input line of every run of equal keys
+    int (*compare)(const char*, const char*) = strcmp;
+    if (numeric) {
+        compare = unique ? compareNumericKey : compareNumericLine;
+    }
+    mergeSortStringBy(table.lines, table.count, compare, reverse);
+
+    // Open the output only after the input is consumed, so -o may name an input file
+    int out = STDOUT_FILENO;
+    if (outputPath != NULL) {
+        out = open(outputPath, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        if (out < 0) {
+            perror(outputPath);
+            return 2;
+        }
+    }
+
+    if (lineTableWrite(&table, out, unique ? compare : NULL) < 0) {
+        perror("write");
+        return 2;
+    }
+    if (out != STDOUT_FILENO && close(out) < 0) {
+        perror(outputPath);
+        return 2;
+    }
+
+    free(table.lines);
+    free(table.data);
+    return 0;
+}
+
+#endif /* LINE_SORT_MAIN */
+
+#endif /* LINE_SORT_C */
@@ -13,12 +13,125 @@
  * 1. Divide the array into two halves
  * 2. Recursively sort each half
  * 3. Merge the two sorted halves to produce the final sorted array
+ *
+ * The in-place variants (mergeSortInPlaceInt and friends) merge without a
+ * scratch array by rotating the overlapping parts of the two runs into
+ * place (SymMerge), in O(n log^2 n) time and O(log n) space. A small
+ * caller-provided buffer takes over every merge step whose shorter run fits,
+ * moving the cost toward O(n log n) as the buffer grows.
  */
 
+#ifndef MERGE_SORT_C
+#define MERGE_SORT_C
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+
+#ifndef SORTING_NO_MAIN
+#define SORTING_NO_MAIN
+#define MERGE_SORT_MAIN
+#endif
+
+#include "sort_index.h"
+#include "sort_stats.h"
+#include "sort_workspace.h"
+
+// Stable merge sort specialized per direction at compile time. Given a buffer
+// of n / 2 elements every merge is a plain buffered merge (mergeSortInt and
+// friends); with a smaller buffer or none the merges rotate in place
+#define SORT_TEMPLATE_NAME mergeSortAscInt
+#define SORT_TEMPLATE_TYPE int
+#include "sort_template.h"
+
+#define SORT_TEMPLATE_NAME mergeSortDescInt
+#define SORT_TEMPLATE_TYPE int
+#define SORT_TEMPLATE_DESCENDING
+#include "sort_template.h"
+
+#define SORT_TEMPLATE_NAME mergeSortAscString
+#define SORT_TEMPLATE_TYPE char*
+#define SORT_TEMPLATE_COMPARE(a, b) strcmp(a, b)
+#include "sort_template.h"
+
+#define SORT_TEMPLATE_NAME mergeSortDescString
+#define SORT_TEMPLATE_TYPE char*
+#define SORT_TEMPLATE_COMPARE(a, b) strcmp(a, b)
+#define SORT_TEMPLATE_DESCENDING
+#include "sort_template.h"
+
+/**
+ * Stable Merge Sort for integers that needs no scratch array: runs are
+ * merged in place by rotations (SymMerge), in O(n log^2 n) time and
+ * O(log n) stack. An optional buffer trades memory for speed: every merge,
+ * or part of a merge, whose shorter run fits in it is done as an ordinary
+ * buffered merge. A buffer of about sqrt(n) elements already removes most
+ * rotations; with n / 2 elements the sort does the work of mergeSortInt.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ * @param buffer Scratch space of bufferSize elements, or NULL
+ * @param bufferSize Number of elements in buffer, 0 without one
+ */
+void mergeSortInPlaceIntWide(int arr[], size_t n, bool reverse, int buffer[], size_t bufferSize) {
+    if (reverse) {
+        mergeSortDescIntInPlaceStableSort(arr, n, buffer, bufferSize);
+    } else {
+        mergeSortAscIntInPlaceStableSort(arr, n, buffer, bufferSize);
+    }
+}
+
+/**
+ * mergeSortInPlaceIntWide with an int element count.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ * @param buffer Scratch space of bufferSize elements, or NULL
+ * @param bufferSize Number of elements in buffer, 0 without one
+ */
+void mergeSortInPlaceInt(int arr[], int n, bool reverse, int buffer[], int bufferSize) {
+    if (n <= 1) {
+        return;
+    }
+    mergeSortInPlaceIntWide(arr, (size_t)n, reverse, buffer, bufferSize > 0 ? (size_t)bufferSize : 0);
+}
+
+/**
+ * String version of mergeSortInPlaceIntWide.
+ *
+ * @param arr String array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ * @param buffer Scratch space of bufferSize pointers, or NULL
+ * @param bufferSize Number of pointers in buffer, 0 without one
+ */
+void mergeSortInPlaceStringWide(char* arr[], size_t n, bool reverse, char* buffer[], size_t bufferSize) {
+    if (reverse) {
+        mergeSortDescStringInPlaceStableSort(arr, n, buffer, bufferSize);
+    } else {
+        mergeSortAscStringInPlaceStableSort(arr, n, buffer, bufferSize);
+    }
+}
+
+/**
+ * String version of mergeSortInPlaceInt.
+ *
+ * @param arr String array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ * @param buffer Scratch space of bufferSize pointers, or NULL
+ * @param bufferSize Number of pointers in buffer, 0 without one
+ */
+void mergeSortInPlaceString(char* arr[], int n, bool reverse, char* buffer[], int bufferSize) {
+    if (n <= 1) {
+        return;
+    }
+    mergeSortInPlaceStringWide(arr, (size_t)n, reverse, buffer, bufferSize > 0 ? (size_t)bufferSize : 0);
+}
 
 /**
  * Function to merge two sorted integer sublists.
@@ -33,9 +146,12 @@
 int* mergeInt(int left[], int leftSize, int right[], int rightSize, bool reverse) {
     int* result = (int*)malloc((leftSize + rightSize) * sizeof(int));
     int i = 0, j = 0, k = 0;
+    SORT_STAT_ALLOC((leftSize + rightSize) * sizeof(int));
+    SORT_STAT_PHASE_BEGIN(phaseStart);
     
     // Compare elements from the two sublists and add the smaller (or larger) to the result
     while (i < leftSize && j < rightSize) {
+        SORT_STAT_COMPARE();
         if (!reverse) {
             // Ascending order
             if (left[i] <= right[j]) {
@@ -62,6 +178,8 @@ int* mergeInt(int left[], int leftSize, int right[], int rightSize, bool reverse
     while (j < rightSize) {
         result[k++] = right[j++];
     }
+    SORT_STAT_MOVE(k);
+    SORT_STAT_PHASE_END(phaseStart, SORT_PHASE_MERGE);
     
     return result;
 }
@@ -78,6 +196,7 @@ int* mergeSortRecursiveInt(int arr[], int size, bool reverse) {
     // Base case: if the array has size 0 or 1, it's already sorted
     if (size <= 1) {
         int* result = (int*)malloc(size * sizeof(int));
+        SORT_STAT_ALLOC(size * sizeof(int));
         if (size == 1) {
             result[0] = arr[0];
         }
@@ -88,18 +207,25 @@ int* mergeSortRecursiveInt(int arr[], int size, bool reverse) {
     int mid = size / 2;
     int* left = (int*)malloc(mid * sizeof(int));
     int* right = (int*)malloc((size - mid) * sizeof(int));
+    SORT_STAT_ALLOC(mid * sizeof(int));
+    SORT_STAT_ALLOC((size - mid) * sizeof(int));
     
     // Copy the elements to the sublists
+    SORT_STAT_PHASE_BEGIN(copyStart);
     for (int i = 0; i < mid; i++) {
         left[i] = arr[i];
     }
     for (int i = mid; i < size; i++) {
         right[i - mid] = arr[i];
     }
+    SORT_STAT_MOVE(size);
+    SORT_STAT_PHASE_END(copyStart, SORT_PHASE_COPY);
     
     // Recursively sort each half
+    SORT_STAT_ENTER();
     int* sortedLeft = mergeSortRecursiveInt(left, mid, reverse);
     int* sortedRight = mergeSortRecursiveInt(right, size - mid, reverse);
+    SORT_STAT_LEAVE();
     
     // Free the memory of the original sublists
     free(left);
@@ -115,6 +241,32 @@ int* mergeSortRecursiveInt(int arr[], int size, bool reverse) {
     return result;
 }
 
+/**
+ * Merge Sort for integers using scratch memory from a reusable workspace.
+ * Once the workspace has grown to n / 2 elements, the sort performs no
+ * heap allocation.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ * @param ws Workspace to take scratch memory from, or NULL for the per-thread workspace
+ */
+void mergeSortIntWorkspace(int arr[], int n, bool reverse, SortWorkspace* ws) {
+    if (n <= 1) {
+        return;
+    }
+
+    size_t bytes = (size_t)(n / 2) * sizeof(int);
+    ws = sortWorkspaceReserve(ws, sortWorkspaceSize(bytes));
+    if (ws == NULL) {
+        // Out of memory: the in-place merge sort needs no scratch and is still stable
+        mergeSortInPlaceInt(arr, n, reverse, NULL, 0);
+        return;
+    }
+
+    mergeSortInPlaceIntWide(arr, (size_t)n, reverse, (int*)sortWorkspaceAlloc(ws, bytes), (size_t)(n / 2));
+}
+
 /**
  * Implementation of the Merge Sort algorithm for integers.
  * 
@@ -123,16 +275,10 @@ int* mergeSortRecursiveInt(int arr[], int size, bool reverse) {
  * @param reverse If true, sorts in descending order; if false, in ascending order
  */
 void mergeSortInt(int arr[], int n, bool reverse) {
-    // Start the recursive sorting
-    int* result = mergeSortRecursiveInt(arr, n, reverse);
-    
-    // Copy the result back to the original array
-    for (int i = 0; i < n; i++) {
-        arr[i] = result[i];
-    }
-    
-    // Free allocated memory
-    free(result);
+    // A private workspace costs a single allocation for the whole sort
+    SortWorkspace ws = SORT_WORKSPACE_INIT;
+    mergeSortIntWorkspace(arr, n, reverse, &ws);
+    sortWorkspaceFree(&ws);
 }
 
 /**
@@ -148,9 +294,12 @@ void mergeSortInt(int arr[], int n, bool reverse) {
 char** mergeString(char* left[], int leftSize, char* right[], int rightSize, bool reverse) {
     char** result = (char**)malloc((leftSize + rightSize) * sizeof(char*));
     int i = 0, j = 0, k = 0;
+    SORT_STAT_ALLOC((leftSize + rightSize) * sizeof(char*));
+    SORT_STAT_PHASE_BEGIN(phaseStart);
     
     // Compare elements from the two sublists and add the smaller (or larger) to the result
     while (i < leftSize && j < rightSize) {
+        SORT_STAT_COMPARE();
         if (!reverse) {
             // Ascending order
             if (strcmp(left[i], right[j]) <= 0) {
@@ -177,6 +326,8 @@ char** mergeString(char* left[], int leftSize, char* right[], int rightSize, boo
     while (j < rightSize) {
         result[k++] = right[j++];
     }
+    SORT_STAT_MOVE(k);
+    SORT_STAT_PHASE_END(phaseStart, SORT_PHASE_MERGE);
     
     return result;
 }
@@ -193,6 +344,7 @@ char** mergeSortRecursiveString(char* arr[], int size, bool reverse) {
     // Base case: if the array has size 0 or 1, it's already sorted
     if (size <= 1) {
         char** result = (char**)malloc(size * sizeof(char*));
+        SORT_STAT_ALLOC(size * sizeof(char*));
         if (size == 1) {
             result[0] = arr[0];
         }
@@ -203,18 +355,25 @@ char** mergeSortRecursiveString(char* arr[], int size, bool reverse) {
     int mid = size / 2;
     char** left = (char**)malloc(mid * sizeof(char*));
     char** right = (char**)malloc((size - mid) * sizeof(char*));
+    SORT_STAT_ALLOC(mid * sizeof(char*));
+    SORT_STAT_ALLOC((size - mid) * sizeof(char*));
     
     // Copy the elements to the sublists
+    SORT_STAT_PHASE_BEGIN(copyStart);
     for (int i = 0; i < mid; i++) {
         left[i] = arr[i];
     }
     for (int i = mid; i < size; i++) {
         right[i - mid] = arr[i];
     }
+    SORT_STAT_MOVE(size);
+    SORT_STAT_PHASE_END(copyStart, SORT_PHASE_COPY);
     
     // Recursively sort each half
+    SORT_STAT_ENTER();
     char** sortedLeft = mergeSortRecursiveString(left, mid, reverse);
     char** sortedRight = mergeSortRecursiveString(right, size - mid, reverse);
+    SORT_STAT_LEAVE();
     
     // Free the memory of the original sublists
     free(left);
@@ -230,6 +389,30 @@ char** mergeSortRecursiveString(char* arr[], int size, bool reverse) {
     return result;
 }
 
+/**
+ * Merge Sort for strings using scratch memory from a reusable workspace.
+ *
+ * @param arr String array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ * @param ws Workspace to take scratch memory from, or NULL for the per-thread workspace
+ */
+void mergeSortStringWorkspace(char* arr[], int n, bool reverse, SortWorkspace* ws) {
+    if (n <= 1) {
+        return;
+    }
+
+    size_t bytes = (size_t)(n / 2) * sizeof(char*);
+    ws = sortWorkspaceReserve(ws, sortWorkspaceSize(bytes));
+    if (ws == NULL) {
+        // Out of memory: the in-place merge sort needs no scratch and is still stable
+        mergeSortInPlaceString(arr, n, reverse, NULL, 0);
+        return;
+    }
+
+    mergeSortInPlaceStringWide(arr, (size_t)n, reverse, (char**)sortWorkspaceAlloc(ws, bytes), (size_t)(n / 2));
+}
+
 /**
  * Implementation of the Merge Sort algorithm for strings.
  * 
@@ -238,18 +421,356 @@ char** mergeSortRecursiveString(char* arr[], int size, bool reverse) {
  * @param reverse If true, sorts in descending order; if false, in ascending order
  */
 void mergeSortString(char* arr[], int n, bool reverse) {
-    // Start the recursive sorting
-    char** result = mergeSortRecursiveString(arr, n, reverse);
-    
-    // Copy the result back to the original array
-    for (int i = 0; i < n; i++) {
-        arr[i] = result[i];
+    // A private workspace costs a single allocation for the whole sort
+    SortWorkspace ws = SORT_WORKSPACE_INIT;
+    mergeSortStringWorkspace(arr, n, reverse, &ws);
+    sortWorkspaceFree(&ws);
+}
+
+/**
+ * Merge Sort for integers with a size_t element count.
+ * Arrays that fit in an int index are sorted by mergeSortInt.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void mergeSortIntWide(int arr[], size_t n, bool reverse) {
+    if (sortFitsInt(n)) {
+        mergeSortInt(arr, (int)n, reverse);
+        return;
     }
-    
+
+    SortWorkspace ws = SORT_WORKSPACE_INIT;
+    size_t bytes = n / 2 * sizeof(int);
+    if (sortWorkspaceReserve(&ws, sortWorkspaceSize(bytes)) == NULL) {
+        // Out of memory: the in-place merge sort needs no scratch and is still stable
+        mergeSortInPlaceIntWide(arr, n, reverse, NULL, 0);
+        return;
+    }
+    mergeSortInPlaceIntWide(arr, n, reverse, (int*)sortWorkspaceAlloc(&ws, bytes), n / 2);
+    sortWorkspaceFree(&ws);
+}
+
+/**
+ * Merge Sort for strings with a size_t element count.
+ *
+ * @param arr String array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void mergeSortStringWide(char* arr[], size_t n, bool reverse) {
+    if (sortFitsInt(n)) {
+        mergeSortString(arr, (int)n, reverse);
+        return;
+    }
+
+    SortWorkspace ws = SORT_WORKSPACE_INIT;
+    size_t bytes = n / 2 * sizeof(char*);
+    if (sortWorkspaceReserve(&ws, sortWorkspaceSize(bytes)) == NULL) {
+        mergeSortInPlaceStringWide(arr, n, reverse, NULL, 0);
+        return;
+    }
+    mergeSortInPlaceStringWide(arr, n, reverse, (char**)sortWorkspaceAlloc(&ws, bytes), n / 2);
+    sortWorkspaceFree(&ws);
+}
+
+// Runs up to this length are built with insertion sort before merging
+#define MERGE_SORT_BY_RUN 16
+
+/**
+ * Implementation of a stable bottom-up Merge Sort for strings with a custom comparator.
+ * Unlike mergeSortString, it allocates a single scratch array for the whole sort
+ * and ping-pongs between it and the input instead of allocating at every level.
+ *
+ * @param arr String array to be sorted
+ * @param n Size of the array
+ * @param compare Comparator returning a negative, zero or positive value like strcmp
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void mergeSortStringBy(char* arr[], int n, int (*compare)(const char*, const char*), bool reverse) {
+    if (n <= 1) {
+        return;
+    }
+
+    // Build short sorted runs with insertion sort
+    for (int lo = 0; lo < n; lo += MERGE_SORT_BY_RUN) {
+        int hi = lo + MERGE_SORT_BY_RUN < n ? lo + MERGE_SORT_BY_RUN : n;
+        for (int i = lo + 1; i < hi; i++) {
+            char* key = arr[i];
+            int j = i - 1;
+            while (j >= lo) {
+                int cmp = compare(arr[j], key);
+                SORT_STAT_COMPARE();
+                if ((reverse ? -cmp : cmp) <= 0) {
+                    break;
+                }
+                arr[j + 1] = arr[j];
+                j--;
+            }
+            arr[j + 1] = key;
+            SORT_STAT_MOVE(i - j);
+        }
+    }
+
+    char** buffer = (char**)malloc(n * sizeof(char*));
+    SORT_STAT_ALLOC(n * sizeof(char*));
+    char** src = arr;
+    char** dst = buffer;
+
+    // Merge runs of doubling width, alternating between the two arrays
+    for (int width = MERGE_SORT_BY_RUN; width < n; width *= 2) {
+        for (int lo = 0; lo < n; lo += 2 * width) {
+            int mid = lo + width < n ? lo + width : n;
+            int hi = lo + 2 * width < n ? lo + 2 * width : n;
+            int i = lo, j = mid, k = lo;
+
+            while (i < mid && j < hi) {
+                int cmp = compare(src[i], src[j]);
+                SORT_STAT_COMPARE();
+                if ((reverse ? -cmp : cmp) <= 0) {
+                    dst[k++] = src[i++];
+                } else {
+                    dst[k++] = src[j++];
+                }
+            }
+            while (i < mid) {
+                dst[k++] = src[i++];
+            }
+            while (j < hi) {
+                dst[k++] = src[j++];
+            }
+        }
+        SORT_STAT_MOVE(n);
+
+        char** temp = src;
+        src = dst;
+        dst = temp;
+    }
+
+    // Copy the result back if the last pass ended in the scratch array
+    if (src != arr) {
+        memcpy(arr, src, n * sizeof(char*));
+        SORT_STAT_MOVE(n);
+    }
+
     // Free allocated memory
-    free(result);
+    free(buffer);
 }
 
+/**
+ * Packs the head of an integer run into a single 64-bit tournament entry.
+ * The upper half holds the key, mapped so that unsigned order matches the
+ * sort direction; the lower half holds the run index, which breaks ties
+ * in favour of earlier runs and keeps the merge stable.
+ *
+ * @param key Head element of the run
+ * @param run Index of the run
+ * @param reverse Sort direction
+ * @return Entry where a smaller value must be output first
+ */
+static inline uint64_t kWayEntryInt(int key, int run, bool reverse) {
+    uint32_t biased = (uint32_t)key ^ 0x80000000u;
+    if (reverse) {
+        biased = ~biased;
+    }
+    return ((uint64_t)biased << 32) | (uint32_t)run;
+}
+
+/**
+ * Entry of an exhausted run: larger than any real entry, so it always loses.
+ */
+#define KWAY_EXHAUSTED UINT64_MAX
+
+/**
+ * Builds the loser tree for the integer k-way merge.
+ * Internal nodes are 1..k-1 and leaf k + r stands for run r.
+ *
+ * @return Entry that wins the subtree rooted at node
+ */
+static uint64_t kWayBuildInt(uint64_t tree[], int node, int k, const uint64_t leaves[]) {
+    if (node >= k) {
+        return leaves[node - k];
+    }
+
+    uint64_t left = kWayBuildInt(tree, 2 * node, k, leaves);
+    uint64_t right = kWayBuildInt(tree, 2 * node + 1, k, leaves);
+
+    // The loser stays in the node, the winner moves up
+    tree[node] = left < right ? right : left;
+    return left < right ? left : right;
+}
+
+/**
+ * Merges k sorted integer runs in a single pass using a loser (tournament) tree.
+ * Each output element costs about log2(k) comparisons, instead of the log2(k)
+ * full passes needed when merging the runs pairwise with mergeInt.
+ * Equal elements keep the order of their runs, so the merge is stable.
+ *
+ * @param runs Array of k sorted runs
+ * @param runSizes Size of each run
+ * @param k Number of runs
+ * @param reverse If true, runs are sorted in descending order; if false, in ascending order
+ * @return Merged sorted array (caller must free)
+ */
+int* kWayMergeInt(int* runs[], int runSizes[], int k, bool reverse) {
+    int total = 0;
+    for (int r = 0; r < k; r++) {
+        total += runSizes[r];
+    }
+
+    int* result = (int*)malloc(total * sizeof(int));
+    SORT_STAT_ALLOC(total * sizeof(int));
+    if (k <= 0) {
+        return result;
+    }
+
+    int* pos = (int*)calloc((size_t)k, sizeof(int));
+    uint64_t* tree = (uint64_t*)malloc((size_t)k * sizeof(uint64_t));
+
+    // Leaf entries are only needed while the tree is being built
+    uint64_t* leaves = (uint64_t*)malloc((size_t)k * sizeof(uint64_t));
+    for (int r = 0; r < k; r++) {
+        leaves[r] = runSizes[r] > 0 ? kWayEntryInt(runs[r][0], r, reverse) : KWAY_EXHAUSTED;
+    }
+
+    // tree[0] holds the overall winner, tree[1..k-1] hold the losers
+    tree[0] = kWayBuildInt(tree, 1, k, leaves);
+    free(leaves);
+
+    for (int out = 0; out < total; out++) {
+        int winner = (int)(uint32_t)tree[0];
+        result[out] = runs[winner][pos[winner]++];
+
+        uint64_t entry = pos[winner] < runSizes[winner]
+            ? kWayEntryInt(runs[winner][pos[winner]], winner, reverse)
+            : KWAY_EXHAUSTED;
+
+        // Replay the matches on the path from the winner's leaf to the root
+        for (int node = (winner + k) / 2; node > 0; node /= 2) {
+            uint64_t challenger = tree[node];
+            SORT_STAT_COMPARE();
+            tree[node] = challenger < entry ? entry : challenger;
+            entry = challenger < entry ? challenger : entry;
+        }
+        tree[0] = entry;
+    }
+    SORT_STAT_MOVE(total);
+
+    // Free allocated memory
+    free(pos);
+    free(tree);
+
+    return result;
+}
+
+/**
+ * Decides whether run a beats run b in the string loser tree.
+ * Exhausted runs (NULL head) always lose; ties are broken by run index for stability.
+ *
+ * @param heads Current head string of each run
+ * @param a First run index
+ * @param b Second run index
+ * @param reverse Sort direction
+ * @return true if the head of run a must be output before the head of run b
+ */
+static inline bool kWayBeatsString(char* heads[], int a, int b, bool reverse) {
+    if (heads[a] == NULL) {
+        return false;
+    }
+    if (heads[b] == NULL) {
+        return true;
+    }
+
+    int cmp = strcmp(heads[a], heads[b]);
+    if (cmp != 0) {
+        return reverse ? cmp > 0 : cmp < 0;
+    }
+    return a < b;
+}
+
+/**
+ * Builds the loser tree for the string k-way merge.
+ *
+ * @return Index of the run that wins the subtree rooted at node
+ */
+static int kWayBuildString(int tree[], int node, int k, char* heads[], bool reverse) {
+    if (node >= k) {
+        return node - k;
+    }
+
+    int left = kWayBuildString(tree, 2 * node, k, heads, reverse);
+    int right = kWayBuildString(tree, 2 * node + 1, k, heads, reverse);
+
+    if (kWayBeatsString(heads, left, right, reverse)) {
+        tree[node] = right;
+        return left;
+    }
+    tree[node] = left;
+    return right;
+}
+
+/**
+ * Merges k sorted string runs in a single pass using a loser (tournament) tree.
+ *
+ * @param runs Array of k sorted string runs
+ * @param runSizes Size of each run
+ * @param k Number of runs
+ * @param reverse If true, runs are sorted in descending order; if false, in ascending order
+ * @return Merged sorted array (caller must free)
+ */
+char** kWayMergeString(char** runs[], int runSizes[], int k, bool reverse) {
+    int total = 0;
+    for (int r = 0; r < k; r++) {
+        total += runSizes[r];
+    }
+
+    char** result = (char**)malloc(total * sizeof(char*));
+    SORT_STAT_ALLOC(total * sizeof(char*));
+    if (k <= 0) {
+        return result;
+    }
+
+    int* pos = (int*)calloc((size_t)k, sizeof(int));
+    int* tree = (int*)malloc((size_t)k * sizeof(int));
+
+    // Cache the head of every run so matches do not chase runs[r][pos[r]]
+    char** heads = (char**)malloc((size_t)k * sizeof(char*));
+    for (int r = 0; r < k; r++) {
+        heads[r] = runSizes[r] > 0 ? runs[r][0] : NULL;
+    }
+
+    tree[0] = kWayBuildString(tree, 1, k, heads, reverse);
+
+    for (int out = 0; out < total; out++) {
+        int winner = tree[0];
+        result[out] = heads[winner];
+        pos[winner]++;
+        heads[winner] = pos[winner] < runSizes[winner] ? runs[winner][pos[winner]] : NULL;
+
+        // Replay the matches on the path from the winner's leaf to the root
+        for (int node = (winner + k) / 2; node > 0; node /= 2) {
+            SORT_STAT_COMPARE();
+            if (kWayBeatsString(heads, tree[node], winner, reverse)) {
+                int temp = tree[node];
+                tree[node] = winner;
+                winner = temp;
+            }
+        }
+        tree[0] = winner;
+    }
+    SORT_STAT_MOVE(total);
+
+    // Free allocated memory
+    free(pos);
+    free(tree);
+    free(heads);
+
+    return result;
+}
+
+#ifdef MERGE_SORT_MAIN
+
 /**
  * Function to print an integer array.
  */
@@ -327,6 +848,22 @@ int main() {
     mergeSortString(strArrDesc, strN, true);
     printf("Descending order: ");
     printStringArray(strArrDesc, strN);
-    
+
+    // Example of a k-way merge of pre-sorted runs
+    int run0[] = {11, 25, 64};
+    int run1[] = {12, 34};
+    int run2[] = {22, 90};
+    int* runs[] = {run0, run1, run2};
+    int runSizes[] = {3, 2, 2};
+
+    printf("\nK-way merge of 3 sorted runs: ");
+    int* merged = kWayMergeInt(runs, runSizes, 3, false);
+    printIntArray(merged, 7);
+    free(merged);
+
     return 0;
 }
+
+#endif /* MERGE_SORT_MAIN */
+
+#endif /* MERGE_SORT_C */
@@ -0,0 +1,418 @@
+/**
+ * Memory-Mapped In-Place Sort - Sorting Binary Key Files
+ *
+ * Time Complexity:
+ * - O(n * k) where n is the number of elements and k is the number of key bytes
+ *
+ * Space Complexity: O(k) - besides the mapping itself, only 256 counters per key byte
+ *
+ * How it works:
+ * The file is mapped into memory with mmap and sorted directly in the mapping
+ * with an in-place MSD radix sort (American flag sort), with no heap copy of
+ * the file. The mapping is private: a shared one is flushed by background
+ * writeback between the passes and dirtied again by the next one, so the file
+ * would be written up to twice. Its pages are copied in one sequential pass
+ * up front and the sorted pages are written to the file once, in order, and
+ * released as they go, so the data is read once and written once.
+ * 1. Count the first key byte of every element (sequential pass)
+ * 2. Permute the elements in place into 256 buckets by swapping cycles (random pass)
+ * 3. Sort each bucket on the next key byte; small buckets use insertion sort
+ * 4. Write the mapping back to the file sequentially
+ *
+ * Supported layouts are native-endian int32 and int64 keys and fixed-size records
+ * compared byte-wise (memcmp order) on a key at a given offset.
+ */
+
+#ifndef MMAP_SORT_C
+#define MMAP_SORT_C
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * Layout of the elements stored in the file.
+ */
+typedef enum {
+    MMAP_KEY_INT32,
+    MMAP_KEY_INT64,
+    MMAP_KEY_RECORD
+} MmapKeyType;
+
+/**
+ * Describes the elements of a mapped file and how to order them.
+ */
+typedef struct {
+    MmapKeyType type;
+    size_t elemSize;   // Size of one element in bytes
+    size_t keyOffset;  // Offset of the key inside a record
+    size_t keyLength;  // Number of key bytes
+    bool reverse;      // Sort direction
+} MmapSortKey;
+
+// Buckets at or below this size are finished with insertion sort
+#define MMAP_INSERTION_THRESHOLD 32
+
+// Bytes of the sorted mapping written back before they are released
+#define MMAP_WRITE_CHUNK ((size_t)64 << 20)
+
+/**
+ * Returns key byte number depth of an element, most significant first.
+ * Integers are read with the sign bit flipped so that byte order matches
+ * numeric order; in reverse mode every byte is inverted.
+ *
+ * @param elem Pointer to the element
+ * @param key Element description
+ * @param depth Index of the key byte
+ * @return Key byte in the range 0-255
+ */
+static inline unsigned mmapKeyByte(const unsigned char* elem, const MmapSortKey* key, size_t depth) {
+    unsigned byte;
+    if (key->type == MMAP_KEY_INT32) {
+        uint32_t value;
+        memcpy(&value, elem, sizeof(value));
+        byte = ((value ^ 0x80000000u) >> (8 * (3 - depth))) & 0xFF;
+    } else if (key->type == MMAP_KEY_INT64) {
+        uint64_t value;
+        memcpy(&value, elem, sizeof(value));
+        byte = (unsigned)((value ^ 0x8000000000000000ull) >> (8 * (7 - depth))) & 0xFF;
+    } else {
+        byte = elem[key->keyOffset + depth];
+    }
+    return key->reverse ? 255 - byte : byte;
+}
+
+/**
+ * Compares the keys of two elements from key byte depth onwards.
+ *
+ * @return Negative, zero or positive like memcmp, already adjusted for direction
+ */
+static int mmapCompareFrom(const unsigned char* a, const unsigned char* b, const MmapSortKey* key, size_t depth) {
+    if (key->type == MMAP_KEY_INT32) {
+        int32_t x, y;
+        memcpy(&x, a, sizeof(x));
+        memcpy(&y, b, sizeof(y));
+        int cmp = (x > y) - (x < y);
+        return key->reverse ? -cmp : cmp;
+    }
+    if (key->type == MMAP_KEY_INT64) {
+        int64_t x, y;
+        memcpy(&x, a, sizeof(x));
+        memcpy(&y, b, sizeof(y));
+        int cmp = (x > y) - (x < y);
+        return key->reverse ? -cmp : cmp;
+    }
+
+    int cmp = memcmp(a + key->keyOffset + depth, b + key->keyOffset + depth, key->keyLength - depth);
+    return key->reverse ? -cmp : cmp;
+}
+
+/**
+ * Swaps two elements of elemSize bytes.
+ */
+static inline void mmapSwap(unsigned char* a, unsigned char* b, size_t elemSize, unsigned char* temp) {
+    memcpy(temp, a, elemSize);
+    memcpy(a, b, elemSize);
+    memcpy(b, temp, elemSize);
+}
+
+/**
+ * Insertion sort for small buckets whose first depth key bytes are equal.
+ */
+static void mmapInsertionSort(unsigned char* base, size_t n, const MmapSortKey* key, size_t depth, unsigned char* temp) {
+    size_t size = key->elemSize;
+    for (size_t i = 1; i < n; i++) {
+        size_t j = i;
+        while (j > 0 && mmapCompareFrom(base + (j - 1) * size, base + j * size, key, depth) > 0) {
+            mmapSwap(base + (j - 1) * size, base + j * size, size, temp);
+            j--;
+        }
+    }
+}
+
+/**
+ * American flag sort on key byte depth. The smaller buckets are sorted
+ * recursively and the largest one in the same frame, so the stack depth is
+ * O(log n) however many key bytes the elements share.
+ *
+ * @param base First element of the range
+ * @param n Number of elements in the range
+ * @param key Element description
+ * @param depth Key byte to distribute on
+ * @param temp Scratch space for one element
+ */
+static void mmapRadixSort(unsigned char* base, size_t n, const MmapSortKey* key, size_t depth, unsigned char* temp) {
+    size_t size = key->elemSize;
+    while (n > MMAP_INSERTION_THRESHOLD && depth < key->keyLength) {
+        // The top level streams over the whole file, so tell the kernel to read ahead
+        if (depth == 0) {
+            madvise(base, n * size, MADV_SEQUENTIAL);
+        }
+
+        // Count the occurrences of each byte value
+        size_t count[256] = {0};
+        for (size_t i = 0; i < n; i++) {
+            count[mmapKeyByte(base + i * size, key, depth)]++;
+        }
+
+        // Compute the start (next free slot) and end of every bucket
+        size_t next[256];
+        size_t end[256];
+        size_t offset = 0;
+        for (int b = 0; b < 256; b++) {
+            next[b] = offset;
+            offset += count[b];
+            end[b] = offset;
+        }
+
+        // The permutation jumps between buckets, so readahead would only waste I/O
+        if (depth == 0) {
+            madvise(base, n * size, MADV_RANDOM);
+        }
+
+        // Swap every element into its bucket, following cycles
+        for (int b = 0; b < 256; b++) {
+            while (next[b] < end[b]) {
+                unsigned char* elem = base + next[b] * size;
+                unsigned v = mmapKeyByte(elem, key, depth);
+                if (v == (unsigned)b) {
+                    next[b]++;
+                } else {
+                    mmapSwap(elem, base + next[v] * size, size, temp);
+                    next[v]++;
+                }
+            }
+        }
+
+        // Buckets are now contiguous ranges that are processed one after another
+        if (depth == 0) {
+            madvise(base, n * size, MADV_NORMAL);
+        }
+
+        // Sort the buckets on the next key byte: recurse into all but the largest
+        int largest = 0;
+        for (int b = 1; b < 256; b++) {
+            largest = count[b] > count[largest] ? b : largest;
+        }
+        size_t start = 0, largestStart = 0;
+        for (int b = 0; b < 256; b++) {
+            if (b == largest) {
+                largestStart = start;
+            } else if (count[b] > 1) {
+                mmapRadixSort(base + start * size, count[b], key, depth + 1, temp);
+            }
+            start += count[b];
+        }
+        base += largestStart * size;
+        n = count[largest];
+        depth++;
+    }
+    if (n > 1 && depth < key->keyLength) {
+        mmapInsertionSort(base, n, key, depth, temp);
+    }
+}
+
+/**
+ * Sorts a memory region of fixed-size elements in place.
+ *
+ * @param data Start of the region
+ * @param n Number of elements
+ * @param key Element description
+ */
+void mmapSortBuffer(void* data, size_t n, const MmapSortKey* key) {
+    unsigned char* temp = (unsigned char*)malloc(key->elemSize);
+    mmapRadixSort((unsigned char*)data, n, key, 0, temp);
+    free(temp);
+}
+
+/**
+ * Checks that a key description is usable: integer keys are exactly 4 or
+ * 8 bytes at the start of the element, record keys lie inside the record.
+ *
+ * @return true if the description is valid
+ */
+static bool mmapKeyValid(const MmapSortKey* key) {
+    if (key->elemSize == 0 || key->keyLength == 0 || key->keyLength > key->elemSize) {
+        return false;
+    }
+    if (key->type == MMAP_KEY_INT32 || key->type == MMAP_KEY_INT64) {
+        size_t width = key->type == MMAP_KEY_INT32 ? sizeof(int32_t) : sizeof(int64_t);
+        return key->keyLength == width && key->keyOffset == 0;
+    }
+    return key->type == MMAP_KEY_RECORD && key->keyOffset <= key->elemSize - key->keyLength;
+}
+
+/**
+ * Copies every page of the private mapping in one sequential pass and drops
+ * the file from the page cache, so the sort runs on private pages alone and
+ * no page has to be read from the file a second time under memory pressure.
+ *
+ * @param fd Mapped file
+ * @param data Start of the mapping
+ * @param length Size of the mapping in bytes
+ */
+static void mmapPrefault(int fd, unsigned char* data, size_t length) {
+    madvise(data, length, MADV_SEQUENTIAL);
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    volatile unsigned char* page = data;
+    for (size_t offset = 0; offset < length; offset += pageSize) {
+        page[offset] = page[offset];
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    madvise(data, length, MADV_NORMAL);
+}
+
+/**
+ * Writes the sorted private mapping to the start of the file, releasing each
+ * chunk of the mapping once it is written so memory use does not double.
+ *
+ * @param fd File opened for writing
+ * @param data Start of the mapping
+ * @param length Size of the mapping in bytes
+ * @return 0 on success, -1 with errno set
+ */
+static int mmapWriteBack(int fd, unsigned char* data, size_t length) {
+    madvise(data, length, MADV_SEQUENTIAL);
+    size_t offset = 0;
+    while (offset < length) {
+        size_t chunk = length - offset < MMAP_WRITE_CHUNK ? length - offset : MMAP_WRITE_CHUNK;
+        size_t done = 0;
+        while (done < chunk) {
+            ssize_t written = pwrite(fd, data + offset + done, chunk - done, (off_t)(offset + done));
+            if (written < 0 && errno != EINTR) {
+                return -1;
+            }
+            done += written > 0 ? (size_t)written : 0;
+        }
+        madvise(data + offset, chunk, MADV_DONTNEED);
+        offset += chunk;
+    }
+    return 0;
+}
+
+/**
+ * Sorts a binary file in place through a private memory mapping.
+ * The key type and element size must describe the file exactly; the file
+ * size has to be a multiple of the element size.
+ *
+ * @param path Path of the file to sort
+ * @param key Element description
+ * @return 0 on success, -1 on failure with errno set (EINVAL for an invalid
+ *         key description or a file size that is not a multiple of the element size)
+ */
+int mmapSortFile(const char* path, const MmapSortKey* key) {
+    if (!mmapKeyValid(key)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int fd = open(path, O_RDWR);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    size_t length = (size_t)st.st_size;
+    if (length % key->elemSize != 0) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+    if (length == 0) {
+        close(fd);
+        return 0;
+    }
+
+    void* data = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+
+    mmapPrefault(fd, (unsigned char*)data, length);
+
+    mmapSortBuffer(data, length / key->elemSize, key);
+
+    // Write the sorted pages back before reporting success
+    int status = mmapWriteBack(fd, (unsigned char*)data, length);
+    status = status == 0 ? fsync(fd) : status;
+    int savedErrno = errno;
+    munmap(data, length);
+    close(fd);
+    errno = savedErrno;
+    return status;
+}
+
+#ifndef SORTING_NO_MAIN
+
+/**
+ * Prints the command-line usage.
+ */
+static void printUsage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [-r] [-t int32|int64] [-R size:keyOffset:keyLength] FILE\n"
+            "  -t  sort native-endian int32 (default) or int64 keys\n"
+            "  -R  sort fixed-size records on a byte-wise key\n"
+            "  -r  sort in descending order\n",
+            program);
+}
+
+/**
+ * Sorts a binary key file given on the command line.
+ */
+int main(int argc, char* argv[]) {
+    MmapSortKey key = {MMAP_KEY_INT32, 4, 0, 4, false};
+    int opt;
+
+    while ((opt = getopt(argc, argv, "rt:R:")) != -1) {
+        if (opt == 'r') {
+            key.reverse = true;
+        } else if (opt == 't' && strcmp(optarg, "int32") == 0) {
+            key.type = MMAP_KEY_INT32;
+            key.elemSize = key.keyLength = 4;
+            key.keyOffset = 0;
+        } else if (opt == 't' && strcmp(optarg, "int64") == 0) {
+            key.type = MMAP_KEY_INT64;
+            key.elemSize = key.keyLength = 8;
+            key.keyOffset = 0;
+        } else if (opt == 'R' &&
+                   sscanf(optarg, "%zu:%zu:%zu", &key.elemSize, &key.keyOffset, &key.keyLength) == 3) {
+            key.type = MMAP_KEY_RECORD;
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (optind != argc - 1) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    if (mmapSortFile(argv[optind], &key) != 0) {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    return 0;
+}
+
+#endif /* SORTING_NO_MAIN */
+
+#endif /* MMAP_SORT_C */
@@ -0,0 +1,515 @@
+/**
+ * Normalized Keys - Sorting Algorithm
+ *
+ * Time Complexity:
+ * - Encoding: O(total key bytes)
+ * - Sorting: O(total key bytes examined) for the MSD radix passes, plus
+ *   O(b log b) comparisons within buckets of b < NORMALIZED_KEYS_MSD_MIN keys
+ *
+ * Space Complexity: O(total key bytes) for the keys, plus 49 bytes per row of
+ * scratch from a SortWorkspace
+ *
+ * How it works:
+ * An ORDER BY over mixed columns (a ASC, b DESC NULLS FIRST, c ASC) is turned
+ * into one byte string per row whose memcmp order is the requested row
+ * order, so the sort itself never looks at column types:
+ * 1. Each column appends its encoding to the row's key, column by column:
+ *    - if the column has a null mask, one byte placing NULL first or last
+ *      (independent of the direction, as in SQL)
+ *    - int and int64: big-endian with the sign bit flipped
+ *    - double: big-endian with the sign bit flipped for positive numbers and
+ *      all bits flipped for negative ones; -0.0 is encoded as 0.0 and every
+ *      NaN as one NaN that sorts after infinity
+ *    - string: its bytes followed by a 0 terminator, which sorts before any
+ *      other byte, so "ab" comes before "abc"
+ *    - descending columns invert every byte of their value encoding
+ *    Because every column encoding ends unambiguously, no key is a proper
+ *    prefix of another key.
+ * 2. The keys are sorted by a byte-wise MSD radix sort. Each level caches the
+ *    current byte of every key in one sequential array, counts the buckets,
+ *    and scatters stably into a scratch array; a level where all keys share
+ *    the byte is skipped without moving anything.
+ * 3. Buckets smaller than NORMALIZED_KEYS_MSD_MIN are finished by an
+ *    introsort (sort_template.h) over the next 8 key bytes, loaded once as a
+ *    big-endian integer; only keys equal in those 8 bytes call memcmp.
+ * 4. The result is the row permutation. Rows with equal keys keep their
+ *    original order.
+ */
+
+#ifndef NORMALIZED_KEYS_C
+#define NORMALIZED_KEYS_C
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+
+#ifndef SORTING_NO_MAIN
+#define SORTING_NO_MAIN
+#define NORMALIZED_KEYS_MAIN
+#endif
+
+#include "sort_stats.h"
+#include "sort_workspace.h"
+
+// Buckets below this many keys are sorted by comparison
+#define NORMALIZED_KEYS_MSD_MIN 32
+
+/**
+ * Value type of a column.
+ */
+typedef enum {
+    NORMALIZED_KEY_INT,     // const int*
+    NORMALIZED_KEY_INT64,   // const int64_t*
+    NORMALIZED_KEY_DOUBLE,  // const double*
+    NORMALIZED_KEY_STRING   // const char* const*
+} NormalizedKeyType;
+
+/**
+ * One ORDER BY column.
+ */
+typedef struct {
+    NormalizedKeyType type;
+    const void* values;  // n values of the given type
+    const bool* nulls;   // nulls[i] marks row i as NULL, or NULL if the column has no NULLs
+    bool reverse;        // DESC
+    bool nullsFirst;     // NULLS FIRST; otherwise NULLS LAST
+} NormalizedKeyColumn;
+
+/**
+ * Encoded keys: the key of row i is data[offsets[i]..offsets[i + 1]).
+ */
+typedef struct {
+    unsigned char* data;
+    size_t* offsets;  // count + 1 entries
+    size_t count;
+} NormalizedKeys;
+
+#define NORMALIZED_KEYS_INIT {NULL, NULL, 0}
+
+/**
+ * A key being sorted.
+ */
+typedef struct {
+    const unsigned char* key;
+    size_t length;
+    uint64_t row;
+} NormalizedKeyRef;
+
+/**
+ * A key in a small bucket: the 8 bytes after the bucket's common prefix as a
+ * big-endian integer (zero-padded past the end), and the rest of the key.
+ */
+typedef struct {
+    uint64_t prefix;
+    const unsigned char* rest;
+    size_t restLength;
+    uint64_t row;
+} NormalizedKeyCached;
+
+/**
+ * Orders two cached keys; keys that are equal keep the order of their rows.
+ */
+static inline bool normalizedKeyCachedLess(const NormalizedKeyCached* a, const NormalizedKeyCached* b) {
+    if (a->prefix != b->prefix) {
+        return a->prefix < b->prefix;
+    }
+    size_t common = a->restLength < b->restLength ? a->restLength : b->restLength;
+    int cmp = common > 0 ? memcmp(a->rest, b->rest, common) : 0;
+    if (cmp != 0) {
+        return cmp < 0;
+    }
+    return a->row < b->row;
+}
+
+#define SORT_TEMPLATE_NAME normalizedKeysCached
+#define SORT_TEMPLATE_TYPE NormalizedKeyCached
+#define SORT_TEMPLATE_LESS(a, b) normalizedKeyCachedLess(&(a), &(b))
+#include "sort_template.h"
+
+/**
+ * Writes value as count big-endian bytes, inverted if reverse.
+ */
+static inline unsigned char* normalizedKeyPutBigEndian(unsigned char* out, uint64_t value, int count,
+                                                       bool reverse) {
+    if (reverse) {
+        value = ~value;
+    }
+    for (int b = count - 1; b >= 0; b--) {
+        *out++ = (unsigned char)(value >> (8 * b));
+    }
+    return out;
+}
+
+/**
+ * Maps a double to an unsigned integer with the same order.
+ */
+static inline uint64_t normalizedKeyDoubleBits(double value) {
+    if (value == 0.0) {
+        value = 0.0;  // -0.0 equals 0.0
+    }
+    uint64_t bits;
+    if (value != value) {
+        bits = 0x7FF8000000000000ull;  // One NaN, after infinity
+    } else {
+        memcpy(&bits, &value, sizeof(bits));
+    }
+    return bits ^ ((uint64_t)(-(int64_t)(bits >> 63)) | 0x8000000000000000ull);
+}
+
+/**
+ * Bytes of the encoding of one row of a column.
+ */
+static inline size_t normalizedKeyLength(const NormalizedKeyColumn* column, size_t row) {
+    size_t indicator = column->nulls != NULL;
+    if (indicator && column->nulls[row]) {
+        return 1;
+    }
+    switch (column->type) {
+    case NORMALIZED_KEY_INT:
+        return indicator + 4;
+    case NORMALIZED_KEY_INT64:
+    case NORMALIZED_KEY_DOUBLE:
+        return indicator + 8;
+    default:
+        return indicator + strlen(((const char* const*)column->values)[row]) + 1;
+    }
+}
+
+/**
+ * Frees encoded keys; the struct can be reused afterwards.
+ */
+void normalizedKeysFree(NormalizedKeys* keys) {
+    free(keys->data);
+    free(keys->offsets);
+    keys->data = NULL;
+    keys->offsets = NULL;
+    keys->count = 0;
+}
+
+/**
+ * Encodes the ORDER BY columns of n rows into memcmp-comparable keys.
+ * Each column is encoded in its own loop over the rows, so the column type
+ * is looked at once per column, not once per value.
+ *
+ * @param columns ORDER BY columns, most significant first
+ * @param columnCount Number of columns
+ * @param n Number of rows
+ * @param keys Receives the keys; free with normalizedKeysFree
+ * @return 0 on success, -1 with errno set to ENOMEM on failure
+ */
+int normalizedKeysEncode(const NormalizedKeyColumn columns[], size_t columnCount, size_t n, NormalizedKeys* keys) {
+    keys->count = n;
+    keys->data = NULL;
+    keys->offsets = (size_t*)malloc((n + 1) * sizeof(size_t));
+    if (keys->offsets == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    // Fixed-width columns add the same length to every row
+    size_t fixed = 0;
+    for (size_t c = 0; c < columnCount; c++) {
+        if (columns[c].type != NORMALIZED_KEY_STRING && columns[c].nulls == NULL) {
+            fixed += normalizedKeyLength(&columns[c], 0);
+        }
+    }
+    // offsets[i + 1] collects the length of row i, then becomes its end
+    keys->offsets[0] = 0;
+    for (size_t i = 0; i < n; i++) {
+        keys->offsets[i + 1] = fixed;
+    }
+    for (size_t c = 0; c < columnCount; c++) {
+        if (columns[c].type == NORMALIZED_KEY_STRING || columns[c].nulls != NULL) {
+            for (size_t i = 0; i < n; i++) {
+                keys->offsets[i + 1] += normalizedKeyLength(&columns[c], i);
+            }
+        }
+    }
+    for (size_t i = 1; i <= n; i++) {
+        keys->offsets[i] += keys->offsets[i - 1];
+    }
+
+    keys->data = (unsigned char*)malloc(keys->offsets[n] > 0 ? keys->offsets[n] : 1);
+    size_t* cursor = (size_t*)malloc((n + 1) * sizeof(size_t));
+    if (keys->data == NULL || cursor == NULL) {
+        free(cursor);
+        normalizedKeysFree(keys);
+        errno = ENOMEM;
+        return -1;
+    }
+    memcpy(cursor, keys->offsets, (n + 1) * sizeof(size_t));
+
+    for (size_t c = 0; c < columnCount; c++) {
+        const NormalizedKeyColumn* column = &columns[c];
+        bool reverse = column->reverse;
+        unsigned char nullByte = column->nullsFirst ? 0x00 : 0x02;
+
+        for (size_t i = 0; i < n; i++) {
+            unsigned char* out = keys->data + cursor[i];
+            if (column->nulls != NULL) {
+                if (column->nulls[i]) {
+                    *out++ = nullByte;
+                    cursor[i] = (size_t)(out - keys->data);
+                    continue;
+                }
+                *out++ = 0x01;
+            }
+            switch (column->type) {
+            case NORMALIZED_KEY_INT:
+                out = normalizedKeyPutBigEndian(out, (uint32_t)((const int*)column->values)[i] ^ 0x80000000u, 4,
+                                                reverse);
+                break;
+            case NORMALIZED_KEY_INT64:
+                out = normalizedKeyPutBigEndian(
+                    out, (uint64_t)((const int64_t*)column->values)[i] ^ 0x8000000000000000ull, 8, reverse);
+                break;
+            case NORMALIZED_KEY_DOUBLE:
+                out = normalizedKeyPutBigEndian(out, normalizedKeyDoubleBits(((const double*)column->values)[i]),
+                                                8, reverse);
+                break;
+            default: {
+                const unsigned char* s = (const unsigned char*)((const char* const*)column->values)[i];
+                unsigned char flip = reverse ? 0xFF : 0x00;
+                for (; *s != 0; s++) {
+                    *out++ = *s ^ flip;
+                }
+                *out++ = flip;
+                break;
+            }
+            }
+            cursor[i] = (size_t)(out - keys->data);
+        }
+    }
+    free(cursor);
+    return 0;
+}
+
+/**
+ * Sorts a bucket of fewer than NORMALIZED_KEYS_MSD_MIN keys that share their
+ * first depth bytes.
+ */
+static void normalizedKeysSmallSort(NormalizedKeyRef refs[], size_t n, size_t depth) {
+    NormalizedKeyCached cached[NORMALIZED_KEYS_MSD_MIN];
+    for (size_t i = 0; i < n; i++) {
+        const unsigned char* key = refs[i].key + depth;
+        size_t remaining = refs[i].length - depth;
+        size_t take = remaining < 8 ? remaining : 8;
+        uint64_t prefix = 0;
+        for (size_t b = 0; b < take; b++) {
+            prefix |= (uint64_t)key[b] << (56 - 8 * b);
+        }
+        cached[i].prefix = prefix;
+        cached[i].rest = key + take;
+        cached[i].restLength = remaining - take;
+        cached[i].row = i;  // Position in refs, which is in row order
+    }
+    normalizedKeysCachedSort(cached, n);
+
+    // Reorder refs by the sorted positions
+    NormalizedKeyRef sorted[NORMALIZED_KEYS_MSD_MIN];
+    for (size_t i = 0; i < n; i++) {
+        sorted[i] = refs[cached[i].row];
+    }
+    memcpy(refs, sorted, n * sizeof(NormalizedKeyRef));
+    SORT_STAT_MOVE(n);
+}
+
+/**
+ * MSD radix sort of keys that share their first depth bytes.
+ *
+ * @param refs Keys to sort, in row order among equal keys
+ * @param scratch Scratch of n refs
+ * @param cache Scratch of n bytes
+ * @param n Number of keys
+ * @param depth Length of the common prefix
+ */
+static void normalizedKeysMsd(NormalizedKeyRef refs[], NormalizedKeyRef scratch[], unsigned char cache[], size_t n,
+                              size_t depth) {
+    while (n >= NORMALIZED_KEYS_MSD_MIN) {
+        // No key is a proper prefix of another: if one key ends here, all are equal
+        if (refs[0].length == depth) {
+            return;
+        }
+
+        size_t count[256] = {0};
+        for (size_t i = 0; i < n; i++) {
+            cache[i] = refs[i].key[depth];
+            count[cache[i]]++;
+        }
+        if (count[cache[0]] == n) {
+            depth++;
+            continue;
+        }
+
+        SORT_STAT_PHASE_BEGIN(distributeStart);
+        size_t pos[256];
+        size_t sum = 0;
+        for (int b = 0; b < 256; b++) {
+            pos[b] = sum;
+            sum += count[b];
+        }
+        for (size_t i = 0; i < n; i++) {
+            scratch[pos[cache[i]]++] = refs[i];
+        }
+        memcpy(refs, scratch, n * sizeof(NormalizedKeyRef));
+        SORT_STAT_MOVE(2 * n);
+        SORT_STAT_PHASE_END(distributeStart, SORT_PHASE_DISTRIBUTE);
+
+        // Recurse into every bucket but the largest and continue with that one
+        // in this frame, so the stack depth is O(log n) however long the
+        // shared prefixes are
+        int largest = 0;
+        for (int b = 1; b < 256; b++) {
+            largest = count[b] > count[largest] ? b : largest;
+        }
+        size_t start = 0, largestStart = 0;
+        for (int b = 0; b < 256; b++) {
+            if (b == largest) {
+                largestStart = start;
+            } else if (count[b] > 1) {
+                normalizedKeysMsd(refs + start, scratch + start, cache + start, count[b], depth + 1);
+            }
+            start += count[b];
+        }
+        refs += largestStart;
+        scratch += largestStart;
+        cache += largestStart;
+        n = count[largest];
+        depth++;
+    }
+    if (n > 1) {
+        normalizedKeysSmallSort(refs, n, depth);
+    }
+}
+
+/**
+ * Shared implementation of normalizedKeysSort and normalizedKeysSortWide.
+ */
+static int normalizedKeysSortImpl(const NormalizedKeys* keys, void* perm, bool wide, SortWorkspace* ws) {
+    size_t n = keys->count;
+    size_t refBytes = n * sizeof(NormalizedKeyRef);
+    ws = sortWorkspaceReserve(ws, 2 * sortWorkspaceSize(refBytes) + sortWorkspaceSize(n));
+    if (ws == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    NormalizedKeyRef* refs = (NormalizedKeyRef*)sortWorkspaceAlloc(ws, refBytes);
+    NormalizedKeyRef* scratch = (NormalizedKeyRef*)sortWorkspaceAlloc(ws, refBytes);
+    unsigned char* cache = (unsigned char*)sortWorkspaceAlloc(ws, n);
+
+    for (size_t i = 0; i < n; i++) {
+        refs[i].key = keys->data + keys->offsets[i];
+        refs[i].length = keys->offsets[i + 1] - keys->offsets[i];
+        refs[i].row = i;
+    }
+    normalizedKeysMsd(refs, scratch, cache, n, 0);
+
+    for (size_t i = 0; i < n; i++) {
+        if (wide) {
+            ((uint64_t*)perm)[i] = refs[i].row;
+        } else {
+            ((uint32_t*)perm)[i] = (uint32_t)refs[i].row;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Sorts encoded keys and returns the row permutation.
+ *
+ * @param keys Keys from normalizedKeysEncode
+ * @param perm Receives the rows in sorted order; equal keys keep ascending rows
+ * @param ws Workspace to take scratch memory from, or NULL for the per-thread workspace
+ * @return 0 on success, -1 with errno set to EINVAL if there are more than
+ *         2^32 rows or to ENOMEM
+ */
+int normalizedKeysSort(const NormalizedKeys* keys, uint32_t perm[], SortWorkspace* ws) {
+    if (keys->count > (size_t)UINT32_MAX + 1) {
+        errno = EINVAL;
+        return -1;
+    }
+    return normalizedKeysSortImpl(keys, perm, false, ws);
+}
+
+/**
+ * normalizedKeysSort with a 64-bit permutation.
+ */
+int normalizedKeysSortWide(const NormalizedKeys* keys, uint64_t perm[], SortWorkspace* ws) {
+    return normalizedKeysSortImpl(keys, perm, true, ws);
+}
+
+/**
+ * Encodes and sorts in one call; the keys are freed before returning.
+ *
+ * @param columns ORDER BY columns, most significant first
+ * @param columnCount Number of columns
+ * @param n Number of rows
+ * @param perm Receives the rows in sorted order
+ * @param ws Workspace to take scratch memory from, or NULL for the per-thread workspace
+ * @return 0 on success, -1 with errno set to EINVAL or ENOMEM
+ */
+int normalizedKeysArgsort(const NormalizedKeyColumn columns[], size_t columnCount, size_t n, uint32_t perm[],
+                          SortWorkspace* ws) {
+    if (n > (size_t)UINT32_MAX + 1) {
+        errno = EINVAL;
+        return -1;
+    }
+    NormalizedKeys keys = NORMALIZED_KEYS_INIT;
+    if (normalizedKeysEncode(columns, columnCount, n, &keys) != 0) {
+        return -1;
+    }
+    int result = normalizedKeysSort(&keys, perm, ws);
+    normalizedKeysFree(&keys);
+    return result;
+}
+
+#ifdef NORMALIZED_KEYS_MAIN
+
+/**
+ * Main function with examples.
+ */
+int main() {
+    // ORDER BY team ASC, score DESC NULLS FIRST, name ASC
+    const char* team[] = {"red", "blue", "red", "blue", "red", "blue"};
+    double score[] = {3.5, 2.0, 0.0, 2.0, 7.25, -1.0};
+    bool scoreNull[] = {false, false, true, false, false, false};
+    const char* name[] = {"ada", "bob", "cy", "al", "dee", "eve"};
+    size_t n = sizeof(score) / sizeof(score[0]);
+
+    NormalizedKeyColumn columns[] = {
+        {NORMALIZED_KEY_STRING, team, NULL, false, false},
+        {NORMALIZED_KEY_DOUBLE, score, scoreNull, true, true},
+        {NORMALIZED_KEY_STRING, name, NULL, false, false},
+    };
+    NormalizedKeys keys = NORMALIZED_KEYS_INIT;
+    if (normalizedKeysEncode(columns, 3, n, &keys) != 0) {
+        perror("normalizedKeysEncode");
+        return 1;
+    }
+    printf("Key of row 0:");
+    for (size_t b = keys.offsets[0]; b < keys.offsets[1]; b++) {
+        printf(" %02x", keys.data[b]);
+    }
+    printf("\n");
+
+    uint32_t perm[6];
+    normalizedKeysSort(&keys, perm, NULL);
+    printf("ORDER BY team, score DESC NULLS FIRST, name:\n");
+    for (size_t i = 0; i < n; i++) {
+        uint32_t row = perm[i];
+        if (scoreNull[row]) {
+            printf("  %-5s %6s %s\n", team[row], "NULL", name[row]);
+        } else {
+            printf("  %-5s %6.2f %s\n", team[row], score[row], name[row]);
+        }
+    }
+    normalizedKeysFree(&keys);
+    return 0;
+}
+
+#endif /* NORMALIZED_KEYS_MAIN */
+
+#endif /* NORMALIZED_KEYS_C */
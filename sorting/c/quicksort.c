@@ -17,11 +17,23 @@
  * 3. Recursively sort the two sub-partitions
  */
 
+#ifndef QUICKSORT_C
+#define QUICKSORT_C
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 
+#ifndef SORTING_NO_MAIN
+#define SORTING_NO_MAIN
+#define QUICKSORT_MAIN
+#endif
+
+#include "heap_sort.c"
+#include "sort_index.h"
+#include "sort_stats.h"
+
 /**
  * Function to partition the array around the pivot.
  * 
@@ -32,6 +44,8 @@
  * @return Pivot index after partitioning
  */
 int partitionInt(int arr[], int low, int high, bool reverse) {
+    SORT_STAT_PHASE_BEGIN(phaseStart);
+
     // Choose the rightmost element as pivot
     int pivot = arr[high];
     
@@ -40,6 +54,7 @@ int partitionInt(int arr[], int low, int high, bool reverse) {
     
     for (int j = low; j < high; j++) {
         // Comparison based on sort direction
+        SORT_STAT_COMPARE();
         if ((!reverse && arr[j] <= pivot) || (reverse && arr[j] >= pivot)) {
             // Increment the index of the smaller element
             i++;
@@ -47,6 +62,7 @@ int partitionInt(int arr[], int low, int high, bool reverse) {
             int temp = arr[i];
             arr[i] = arr[j];
             arr[j] = temp;
+            SORT_STAT_SWAP();
         }
     }
     
@@ -54,6 +70,8 @@ int partitionInt(int arr[], int low, int high, bool reverse) {
     int temp = arr[i + 1];
     arr[i + 1] = arr[high];
     arr[high] = temp;
+    SORT_STAT_SWAP();
+    SORT_STAT_PHASE_END(phaseStart, SORT_PHASE_PARTITION);
     
     // Return the pivot index
     return i + 1;
@@ -69,12 +87,16 @@ int partitionInt(int arr[], int low, int high, bool reverse) {
  */
 void quicksortRecursiveInt(int arr[], int low, int high, bool reverse) {
     if (low < high) {
+        SORT_STAT_ENTER();
+
         // Partition the array and get the pivot index
         int pivotIdx = partitionInt(arr, low, high, reverse);
         
         // Recursively sort the sub-partitions
         quicksortRecursiveInt(arr, low, pivotIdx - 1, reverse);
         quicksortRecursiveInt(arr, pivotIdx + 1, high, reverse);
+
+        SORT_STAT_LEAVE();
     }
 }
 
@@ -86,22 +108,8 @@ void quicksortRecursiveInt(int arr[], int low, int high, bool reverse) {
  * @param reverse If true, sorts in descending order; if false, in ascending order
  */
 void quicksortInt(int arr[], int n, bool reverse) {
-    // Use a copy of the array to avoid modifying the original
-    int* result = (int*)malloc(n * sizeof(int));
-    for (int i = 0; i < n; i++) {
-        result[i] = arr[i];
-    }
-    
     // Start the recursive sorting
-    quicksortRecursiveInt(result, 0, n - 1, reverse);
-    
-    // Copy the result back to the original array
-    for (int i = 0; i < n; i++) {
-        arr[i] = result[i];
-    }
-    
-    // Free allocated memory
-    free(result);
+    quicksortRecursiveInt(arr, 0, n - 1, reverse);
 }
 
 /**
@@ -114,6 +122,8 @@ void quicksortInt(int arr[], int n, bool reverse) {
  * @return Pivot index after partitioning
  */
 int partitionString(char* arr[], int low, int high, bool reverse) {
+    SORT_STAT_PHASE_BEGIN(phaseStart);
+
     // Choose the rightmost element as pivot
     char* pivot = arr[high];
     
@@ -122,6 +132,7 @@ int partitionString(char* arr[], int low, int high, bool reverse) {
     
     for (int j = low; j < high; j++) {
         // Comparison based on sort direction
+        SORT_STAT_COMPARE();
         if ((!reverse && strcmp(arr[j], pivot) <= 0) || 
             (reverse && strcmp(arr[j], pivot) >= 0)) {
             // Increment the index of the smaller element
@@ -130,6 +141,7 @@ int partitionString(char* arr[], int low, int high, bool reverse) {
             char* temp = arr[i];
             arr[i] = arr[j];
             arr[j] = temp;
+            SORT_STAT_SWAP();
         }
     }
     
@@ -137,6 +149,8 @@ int partitionString(char* arr[], int low, int high, bool reverse) {
     char* temp = arr[i + 1];
     arr[i + 1] = arr[high];
     arr[high] = temp;
+    SORT_STAT_SWAP();
+    SORT_STAT_PHASE_END(phaseStart, SORT_PHASE_PARTITION);
     
     // Return the pivot index
     return i + 1;
@@ -152,12 +166,16 @@ int partitionString(char* arr[], int low, int high, bool reverse) {
  */
 void quicksortRecursiveString(char* arr[], int low, int high, bool reverse) {
     if (low < high) {
+        SORT_STAT_ENTER();
+
         // Partition the array and get the pivot index
         int pivotIdx = partitionString(arr, low, high, reverse);
         
         // Recursively sort the sub-partitions
         quicksortRecursiveString(arr, low, pivotIdx - 1, reverse);
         quicksortRecursiveString(arr, pivotIdx + 1, high, reverse);
+
+        SORT_STAT_LEAVE();
     }
 }
 
@@ -169,24 +187,239 @@ void quicksortRecursiveString(char* arr[], int low, int high, bool reverse) {
  * @param reverse If true, sorts in descending order; if false, in ascending order
  */
 void quicksortString(char* arr[], int n, bool reverse) {
-    // Use a copy of the array to avoid modifying the original
-    char** result = (char**)malloc(n * sizeof(char*));
-    for (int i = 0; i < n; i++) {
-        result[i] = arr[i];
-    }
-    
     // Start the recursive sorting
-    quicksortRecursiveString(result, 0, n - 1, reverse);
-    
-    // Copy the result back to the original array
-    for (int i = 0; i < n; i++) {
-        arr[i] = result[i];
+    quicksortRecursiveString(arr, 0, n - 1, reverse);
+}
+
+// Three-way quicksort specialized per direction at compile time, so the
+// inner loops carry no reverse test and the comparisons are inlined
+#define SORT_TEMPLATE_NAME quicksort3WayAscInt
+#define SORT_TEMPLATE_TYPE int
+#include "sort_template.h"
+
+#define SORT_TEMPLATE_NAME quicksort3WayDescInt
+#define SORT_TEMPLATE_TYPE int
+#define SORT_TEMPLATE_DESCENDING
+#include "sort_template.h"
+
+#define SORT_TEMPLATE_NAME quicksort3WayAscString
+#define SORT_TEMPLATE_TYPE char*
+#define SORT_TEMPLATE_COMPARE(a, b) strcmp(a, b)
+#include "sort_template.h"
+
+#define SORT_TEMPLATE_NAME quicksort3WayDescString
+#define SORT_TEMPLATE_TYPE char*
+#define SORT_TEMPLATE_COMPARE(a, b) strcmp(a, b)
+#define SORT_TEMPLATE_DESCENDING
+#include "sort_template.h"
+
+/**
+ * Three-way (Dijkstra) partitioning Quicksort for integers on arr[low..high].
+ * Elements equal to the pivot are gathered in the middle and never touched
+ * again, so inputs with many duplicates sort in close to linear time.
+ * The pivot is the median of the first, middle and last elements; the
+ * recursion goes into the smaller side and loops on the larger one, and a
+ * depth limit switches to heap sort so the worst case stays O(n log n).
+ * The direction is tested once, here; the work is done by the ascending or
+ * descending instantiation of sort_template.h.
+ *
+ * @param arr Array to be sorted
+ * @param low Starting index of the range
+ * @param high Ending index of the range (inclusive)
+ * @param reverse Sort direction
+ * @param depthLimit Remaining partitioning levels before falling back to heap sort
+ */
+void quicksort3WayRecursiveInt(int arr[], int low, int high, bool reverse, int depthLimit) {
+    if (low >= high) {
+        return;
+    }
+    if (reverse) {
+        quicksort3WayDescIntIntroSort(arr + low, (size_t)(high - low) + 1, depthLimit);
+    } else {
+        quicksort3WayAscIntIntroSort(arr + low, (size_t)(high - low) + 1, depthLimit);
+    }
+}
+
+/**
+ * Implementation of three-way Quicksort for integers.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void quicksort3WayInt(int arr[], int n, bool reverse) {
+    quicksort3WayRecursiveInt(arr, 0, n - 1, reverse, sortTemplateDepthLimit(n > 0 ? (size_t)n : 0));
+}
+
+/**
+ * Three-way partitioning Quicksort for strings on arr[low..high].
+ * Same scheme as quicksort3WayRecursiveInt, with one strcmp per element
+ * and partitioning step.
+ */
+void quicksort3WayRecursiveString(char* arr[], int low, int high, bool reverse, int depthLimit) {
+    if (low >= high) {
+        return;
+    }
+    if (reverse) {
+        quicksort3WayDescStringIntroSort(arr + low, (size_t)(high - low) + 1, depthLimit);
+    } else {
+        quicksort3WayAscStringIntroSort(arr + low, (size_t)(high - low) + 1, depthLimit);
+    }
+}
+
+/**
+ * Implementation of three-way Quicksort for strings.
+ *
+ * @param arr String array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void quicksort3WayString(char* arr[], int n, bool reverse) {
+    quicksort3WayRecursiveString(arr, 0, n - 1, reverse, sortTemplateDepthLimit(n > 0 ? (size_t)n : 0));
+}
+
+/**
+ * Lomuto partition of arr[low..high) with a size_t range.
+ *
+ * @param arr Array to be partitioned
+ * @param low Starting index of the partition
+ * @param high End of the partition (exclusive)
+ * @param reverse Sort direction
+ * @return Pivot index after partitioning
+ */
+size_t partitionIntWide(int arr[], size_t low, size_t high, bool reverse) {
+    SORT_STAT_PHASE_BEGIN(phaseStart);
+    int pivot = arr[high - 1];
+    size_t store = low;
+
+    for (size_t j = low; j < high - 1; j++) {
+        SORT_STAT_COMPARE();
+        if (reverse ? arr[j] >= pivot : arr[j] <= pivot) {
+            int temp = arr[store];
+            arr[store] = arr[j];
+            arr[j] = temp;
+            SORT_STAT_SWAP();
+            store++;
+        }
+    }
+
+    int temp = arr[store];
+    arr[store] = arr[high - 1];
+    arr[high - 1] = temp;
+    SORT_STAT_SWAP();
+    SORT_STAT_PHASE_END(phaseStart, SORT_PHASE_PARTITION);
+    return store;
+}
+
+/**
+ * Quicksort for integers with a size_t element count. Partitions with size_t
+ * indices until a side fits in an int index, then hands it to quicksortInt.
+ * Recursion goes into the smaller side, so the stack stays O(log n) deep
+ * above the int threshold.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void quicksortIntWide(int arr[], size_t n, bool reverse) {
+    size_t low = 0, high = n;
+    while (!sortFitsInt(high - low)) {
+        size_t pivotIdx = partitionIntWide(arr, low, high, reverse);
+        if (pivotIdx - low < high - pivotIdx - 1) {
+            quicksortIntWide(arr + low, pivotIdx - low, reverse);
+            low = pivotIdx + 1;
+        } else {
+            quicksortIntWide(arr + pivotIdx + 1, high - pivotIdx - 1, reverse);
+            high = pivotIdx;
+        }
+    }
+    quicksortInt(arr + low, (int)(high - low), reverse);
+}
+
+/**
+ * String version of partitionIntWide.
+ */
+size_t partitionStringWide(char* arr[], size_t low, size_t high, bool reverse) {
+    SORT_STAT_PHASE_BEGIN(phaseStart);
+    char* pivot = arr[high - 1];
+    size_t store = low;
+
+    for (size_t j = low; j < high - 1; j++) {
+        SORT_STAT_COMPARE();
+        int cmp = strcmp(arr[j], pivot);
+        if (reverse ? cmp >= 0 : cmp <= 0) {
+            char* temp = arr[store];
+            arr[store] = arr[j];
+            arr[j] = temp;
+            SORT_STAT_SWAP();
+            store++;
+        }
+    }
+
+    char* temp = arr[store];
+    arr[store] = arr[high - 1];
+    arr[high - 1] = temp;
+    SORT_STAT_SWAP();
+    SORT_STAT_PHASE_END(phaseStart, SORT_PHASE_PARTITION);
+    return store;
+}
+
+/**
+ * Quicksort for strings with a size_t element count.
+ *
+ * @param arr String array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void quicksortStringWide(char* arr[], size_t n, bool reverse) {
+    size_t low = 0, high = n;
+    while (!sortFitsInt(high - low)) {
+        size_t pivotIdx = partitionStringWide(arr, low, high, reverse);
+        if (pivotIdx - low < high - pivotIdx - 1) {
+            quicksortStringWide(arr + low, pivotIdx - low, reverse);
+            low = pivotIdx + 1;
+        } else {
+            quicksortStringWide(arr + pivotIdx + 1, high - pivotIdx - 1, reverse);
+            high = pivotIdx;
+        }
+    }
+    quicksortString(arr + low, (int)(high - low), reverse);
+}
+
+/**
+ * Three-way Quicksort for integers with a size_t element count.
+ * The instantiations index with size_t throughout, so there is no separate
+ * int-indexed stage.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void quicksort3WayIntWide(int arr[], size_t n, bool reverse) {
+    if (reverse) {
+        quicksort3WayDescIntSort(arr, n);
+    } else {
+        quicksort3WayAscIntSort(arr, n);
     }
-    
-    // Free allocated memory
-    free(result);
 }
 
+/**
+ * Three-way Quicksort for strings with a size_t element count.
+ *
+ * @param arr String array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void quicksort3WayStringWide(char* arr[], size_t n, bool reverse) {
+    if (reverse) {
+        quicksort3WayDescStringSort(arr, n);
+    } else {
+        quicksort3WayAscStringSort(arr, n);
+    }
+}
+
+#ifdef QUICKSORT_MAIN
+
 /**
  * Function to print an integer array.
  */
@@ -267,3 +500,7 @@ int main() {
     
     return 0;
 }
+
+#endif /* QUICKSORT_MAIN */
+
+#endif /* QUICKSORT_C */
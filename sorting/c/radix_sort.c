@@ -14,12 +14,33 @@
  * 2. Group numbers into buckets according to the current digit value
  * 3. Collect the numbers from the buckets in order
  * 4. Repeat the process for each digit position, up to the most significant digit
+ *
+ * The digits are taken from key - min, so negative keys sort too and a
+ * narrow range far from zero needs few passes. When the range is narrow
+ * compared to n (see RADIX_COUNTING_MAX_RANGE), a single counting pass
+ * replaces the digit passes: one histogram of all values, from which the
+ * sorted array is written back in place, in O(n + range).
  */
 
+#ifndef RADIX_SORT_C
+#define RADIX_SORT_C
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+
+#ifndef SORTING_NO_MAIN
+#define SORTING_NO_MAIN
+#define RADIX_SORT_MAIN
+#endif
+
+#include "heap_sort.c"
+#include "sort_index.h"
+#include "sort_stats.h"
+#include "sort_workspace.h"
 
 /**
  * Helper function to find the maximum number in the array.
@@ -49,6 +70,8 @@ int getMax(int arr[], int n) {
 void countingSort(int arr[], int n, int exp, bool reverse) {
     int* output = (int*)malloc(n * sizeof(int));
     int count[10] = {0}; // 10 possible digits (0-9)
+    SORT_STAT_ALLOC(n * sizeof(int));
+    SORT_STAT_PHASE_BEGIN(distributeStart);
     
     // Count occurrences of each digit at the current position
     for (int i = 0; i < n; i++) {
@@ -75,47 +98,496 @@ void countingSort(int arr[], int n, int exp, bool reverse) {
         output[count[index] - 1] = arr[i];
         count[index]--;
     }
+    SORT_STAT_MOVE(n);
+    SORT_STAT_PHASE_END(distributeStart, SORT_PHASE_DISTRIBUTE);
     
     // Copy the result back to the original array
+    SORT_STAT_PHASE_BEGIN(copyStart);
     for (int i = 0; i < n; i++) {
         arr[i] = output[i];
     }
+    SORT_STAT_MOVE(n);
+    SORT_STAT_PHASE_END(copyStart, SORT_PHASE_COPY);
     
     // Free the memory allocated
     free(output);
 }
 
+// Key ranges below this many values are sorted by counting: one histogram
+// pass and one output pass instead of up to ten digit passes
+#define RADIX_COUNTING_MAX_RANGE (1u << 24)
+
+/**
+ * Finds the smallest and largest key in one pass. Eight independent lanes
+ * let the compiler keep them in one vector register.
+ */
+static void radixMinMax(const int arr[], size_t n, int* minOut, int* maxOut) {
+    int lo[8], hi[8];
+    for (int l = 0; l < 8; l++) {
+        lo[l] = arr[0];
+        hi[l] = arr[0];
+    }
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (int l = 0; l < 8; l++) {
+            lo[l] = arr[i + l] < lo[l] ? arr[i + l] : lo[l];
+            hi[l] = arr[i + l] > hi[l] ? arr[i + l] : hi[l];
+        }
+    }
+    for (; i < n; i++) {
+        lo[0] = arr[i] < lo[0] ? arr[i] : lo[0];
+        hi[0] = arr[i] > hi[0] ? arr[i] : hi[0];
+    }
+    for (int l = 1; l < 8; l++) {
+        lo[0] = lo[l] < lo[0] ? lo[l] : lo[0];
+        hi[0] = hi[l] > hi[0] ? hi[l] : hi[0];
+    }
+    *minOut = lo[0];
+    *maxOut = hi[0];
+}
+
+/**
+ * Counting sort for keys in [min, min + range]: counts every value, then
+ * writes the values back in order straight from the counts, so the sort
+ * needs no scatter buffer and works in place.
+ *
+ * @return false if the workspace could not hold the histogram
+ */
+static bool radixCountingSort(int arr[], size_t n, bool reverse, int min, unsigned range, SortWorkspace* ws) {
+    size_t values = (size_t)range + 1;
+    ws = sortWorkspaceReserve(ws, sortWorkspaceSize(values * sizeof(uint32_t)));
+    if (ws == NULL) {
+        return false;
+    }
+    uint32_t* count = (uint32_t*)sortWorkspaceAlloc(ws, values * sizeof(uint32_t));
+    memset(count, 0, values * sizeof(uint32_t));
+
+    SORT_STAT_PHASE_BEGIN(distributeStart);
+    for (size_t i = 0; i < n; i++) {
+        count[(unsigned)arr[i] - (unsigned)min]++;
+    }
+
+    size_t pos = 0;
+    for (size_t v = 0; v < values; v++) {
+        size_t value = reverse ? range - v : v;
+        int key = (int)((unsigned)min + (unsigned)value);
+        for (uint32_t c = count[value]; c > 0; c--) {
+            arr[pos++] = key;
+        }
+    }
+    SORT_STAT_MOVE(n);
+    SORT_STAT_PHASE_END(distributeStart, SORT_PHASE_DISTRIBUTE);
+    return true;
+}
+
+/**
+ * Returns whether a key range is narrow enough for radixCountingSort: the
+ * histogram must be no larger than the scratch buffer of the digit passes,
+ * and its 32-bit counters must not overflow.
+ */
+static inline bool radixCountingFits(size_t n, unsigned range) {
+    return range < RADIX_COUNTING_MAX_RANGE && range < n && n <= UINT32_MAX;
+}
+
+/**
+ * Digit of key - min for a decimal position, so negative keys sort too
+ * and a narrow range far from zero needs few passes.
+ */
+static inline unsigned radixOffsetDigit(int key, int min, unsigned exp) {
+    return ((unsigned)key - (unsigned)min) / exp % 10;
+}
+
 /**
- * Implementation of the Radix Sort algorithm for positive integers.
+ * Counting sort pass on one decimal digit of key - min. When starts is not
+ * NULL this is the final pass, and it also marks in the bitmap every
+ * position where a group of equal keys begins: elements of one bucket land
+ * next to each other in the output, so remembering the last key written to
+ * each bucket is enough to see a boundary.
+ *
+ * @param starts Bitmap of n + 1 bits, zeroed, or NULL
+ * @return Number of groups if starts is not NULL
+ */
+static size_t countingSortPassOffsetWide(const int src[], int dst[], size_t n, int min, unsigned exp, bool reverse,
+                                         uint64_t starts[]) {
+    size_t count[10] = {0};
+    SORT_STAT_PHASE_BEGIN(phaseStart);
+
+    for (size_t i = 0; i < n; i++) {
+        count[radixOffsetDigit(src[i], min, exp)]++;
+    }
+
+    if (!reverse) {
+        for (int i = 1; i < 10; i++) {
+            count[i] += count[i - 1];
+        }
+    } else {
+        for (int i = 8; i >= 0; i--) {
+            count[i] += count[i + 1];
+        }
+    }
+
+    size_t groups = 0;
+    if (starts == NULL) {
+        for (size_t i = n; i-- > 0;) {
+            dst[--count[radixOffsetDigit(src[i], min, exp)]] = src[i];
+        }
+    } else {
+        // Buckets fill from the back, so the key written before this one
+        // in the same bucket sits right after it. The first key written to
+        // a bucket compares with a dummy and may mark the position after
+        // the bucket: that is the next bucket's start, marked below anyway,
+        // or position n, cleared below.
+        int last[10] = {0};
+        for (size_t i = n; i-- > 0;) {
+            int key = src[i];
+            unsigned digit = radixOffsetDigit(key, min, exp);
+            size_t pos = --count[digit];
+            dst[pos] = key;
+            starts[(pos + 1) >> 6] |= (uint64_t)(last[digit] != key) << ((pos + 1) & 63);
+            last[digit] = key;
+        }
+        for (int d = 0; d < 10; d++) {
+            starts[count[d] >> 6] |= (uint64_t)1 << (count[d] & 63);
+        }
+        starts[n >> 6] &= ~((uint64_t)1 << (n & 63));
+        for (size_t w = 0; w <= n / 64; w++) {
+            groups += (size_t)__builtin_popcountll(starts[w]);
+        }
+    }
+    SORT_STAT_MOVE(n);
+    SORT_STAT_PHASE_END(phaseStart, SORT_PHASE_DISTRIBUTE);
+    return groups;
+}
+
+/**
+ * Decimal digit passes over key - min, alternating between arr and scratch,
+ * with the result copied back to arr if the last pass ended in scratch.
+ */
+static void radixSortOffsetPasses(int arr[], int scratch[], size_t n, bool reverse, int min, unsigned range) {
+    int* src = arr;
+    int* dst = scratch;
+    for (unsigned exp = 1; range / exp > 0; exp *= 10) {
+        countingSortPassOffsetWide(src, dst, n, min, exp, reverse, NULL);
+        int* temp = src;
+        src = dst;
+        dst = temp;
+
+        // Stop before exp * 10 overflows
+        if (exp > range / 10) {
+            break;
+        }
+    }
+
+    // Copy the result back if the last pass ended in the workspace
+    if (src != arr) {
+        SORT_STAT_PHASE_BEGIN(copyStart);
+        memcpy(arr, src, n * sizeof(int));
+        SORT_STAT_MOVE(n);
+        SORT_STAT_PHASE_END(copyStart, SORT_PHASE_COPY);
+    }
+}
+
+/**
+ * Radix Sort using scratch memory from a reusable workspace.
+ * Narrow key ranges are counted into a histogram from the workspace instead.
+ * The digit passes alternate between arr and one workspace buffer of n elements,
+ * so once the workspace has grown the sort performs no heap allocation.
+ *
+ * @param arr Array of integers to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ * @param ws Workspace to take scratch memory from, or NULL for the per-thread workspace
+ */
+void radixSortWorkspace(int arr[], int n, bool reverse, SortWorkspace* ws) {
+    if (n <= 1) {
+        return;
+    }
+
+    // The key range decides between one counting pass and the digit passes
+    int min, max;
+    radixMinMax(arr, n, &min, &max);
+    unsigned range = (unsigned)max - (unsigned)min;
+    if (radixCountingFits(n, range) && radixCountingSort(arr, n, reverse, min, range, ws)) {
+        return;
+    }
+
+    size_t bytes = (size_t)n * sizeof(int);
+    ws = sortWorkspaceReserve(ws, sortWorkspaceSize(bytes));
+    if (ws == NULL) {
+        // Out of memory: heap sort needs no scratch space
+        heapSortInt(arr, n, reverse);
+        return;
+    }
+    radixSortOffsetPasses(arr, (int*)sortWorkspaceAlloc(ws, bytes), n, reverse, min, range);
+}
+
+/**
+ * Implementation of the Radix Sort algorithm.
  * 
- * @param arr Array of positive integers to be sorted
+ * @param arr Array of integers to be sorted
  * @param n Size of the array
  * @param reverse If true, sorts in descending order; if false, in ascending order
  */
 void radixSort(int arr[], int n, bool reverse) {
-    // Create a copy of the array to avoid modifying the original
-    int* result = (int*)malloc(n * sizeof(int));
-    for (int i = 0; i < n; i++) {
-        result[i] = arr[i];
+    // A private workspace costs a single allocation for the whole sort
+    SortWorkspace ws = SORT_WORKSPACE_INIT;
+    radixSortWorkspace(arr, n, reverse, &ws);
+    sortWorkspaceFree(&ws);
+}
+
+/**
+ * Radix Sort with a size_t element count.
+ * Arrays that fit in an int index are sorted by radixSortWorkspace.
+ *
+ * @param arr Array of integers to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ * @param ws Workspace to take scratch memory from, or NULL for the per-thread workspace
+ */
+void radixSortWideWorkspace(int arr[], size_t n, bool reverse, SortWorkspace* ws) {
+    if (sortFitsInt(n)) {
+        radixSortWorkspace(arr, (int)n, reverse, ws);
+        return;
     }
-    
-    // Find the maximum number to determine the number of digits
-    int max = getMax(result, n);
-    
-    // Perform counting sort for each digit position
-    for (int exp = 1; max / exp > 0; exp *= 10) {
-        countingSort(result, n, exp, reverse);
+
+    int min, max;
+    radixMinMax(arr, n, &min, &max);
+    unsigned range = (unsigned)max - (unsigned)min;
+    if (radixCountingFits(n, range) && radixCountingSort(arr, n, reverse, min, range, ws)) {
+        return;
     }
-    
-    // Copy the result back to the original array
-    for (int i = 0; i < n; i++) {
-        arr[i] = result[i];
+
+    size_t bytes = n * sizeof(int);
+    ws = sortWorkspaceReserve(ws, sortWorkspaceSize(bytes));
+    if (ws == NULL) {
+        // Out of memory: heap sort needs no scratch space
+        heapSortIntWide(arr, n, reverse);
+        return;
     }
-    
-    // Free the memory allocated
-    free(result);
+    radixSortOffsetPasses(arr, (int*)sortWorkspaceAlloc(ws, bytes), n, reverse, min, range);
+}
+
+/**
+ * Radix Sort with a size_t element count.
+ *
+ * @param arr Array of integers to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void radixSortWide(int arr[], size_t n, bool reverse) {
+    SortWorkspace ws = SORT_WORKSPACE_INIT;
+    radixSortWideWorkspace(arr, n, reverse, &ws);
+    sortWorkspaceFree(&ws);
+}
+
+/**
+ * Groups of equal keys found while sorting: GROUP BY and DISTINCT results
+ * that come with the sorted array.
+ */
+typedef struct {
+    int* keys;          // Distinct keys in sorted order
+    size_t* counts;     // Number of occurrences of each key
+    size_t* offsets;    // Start of each group in the sorted array; offsets[groupCount] = n
+    size_t groupCount;
+} SortGroups;
+
+#define SORT_GROUPS_INIT {NULL, NULL, NULL, 0}
+
+/**
+ * Radix sort on key - min whose final pass marks the group boundaries.
+ *
+ * @param starts Receives the bitmap of group starts (n + 1 bits)
+ * @param sorted Receives the buffer holding the sorted keys: arr or scratch
+ * @return Number of groups
+ */
+static size_t radixSortMarkGroups(int arr[], int scratch[], size_t n, bool reverse, uint64_t starts[],
+                                  int** sorted) {
+    int min, max;
+    radixMinMax(arr, n, &min, &max);
+    unsigned range = (unsigned)max - (unsigned)min;
+    memset(starts, 0, (n / 64 + 1) * sizeof(uint64_t));
+
+    int* src = arr;
+    int* dst = scratch;
+    size_t groups = 0;
+    for (unsigned exp = 1;; exp *= 10) {
+        // At least one pass, so equal keys are grouped even if all are equal
+        bool final = exp > range / 10;
+        groups = countingSortPassOffsetWide(src, dst, n, min, exp, reverse, final ? starts : NULL);
+        int* temp = src;
+        src = dst;
+        dst = temp;
+        if (final) {
+            break;
+        }
+    }
+    *sorted = src;
+    return groups;
+}
+
+/**
+ * Frees the arrays of a SortGroups.
+ */
+void sortGroupsFree(SortGroups* groups) {
+    free(groups->keys);
+    free(groups->counts);
+    free(groups->offsets);
+    *groups = (SortGroups)SORT_GROUPS_INIT;
+}
+
+/**
+ * Radix sort that also returns the groups of equal keys (GROUP BY). The
+ * group boundaries are found in the final digit pass, so no separate pass
+ * over the sorted keys compares neighbours. Any int keys are accepted.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ * @param groups Receives the distinct keys, counts and offsets; free with sortGroupsFree
+ * @param ws Workspace to take scratch memory from, or NULL for the per-thread workspace
+ * @return 0 on success, -1 with errno set to ENOMEM on failure. groups is then
+ *         empty; arr is unchanged if the scratch could not be reserved and
+ *         already sorted if the group arrays could not be allocated
+ */
+int radixSortGroupsWorkspace(int arr[], size_t n, bool reverse, SortGroups* groups, SortWorkspace* ws) {
+    *groups = (SortGroups)SORT_GROUPS_INIT;
+    groups->offsets = (size_t*)malloc(sizeof(size_t));
+    if (groups->offsets == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    groups->offsets[0] = 0;
+    if (n == 0) {
+        return 0;
+    }
+
+    size_t scratchBytes = n * sizeof(int);
+    size_t bitmapBytes = (n / 64 + 1) * sizeof(uint64_t);
+    ws = sortWorkspaceReserve(ws, sortWorkspaceSize(scratchBytes) + sortWorkspaceSize(bitmapBytes));
+    if (ws == NULL) {
+        sortGroupsFree(groups);
+        errno = ENOMEM;
+        return -1;
+    }
+    int* scratch = (int*)sortWorkspaceAlloc(ws, scratchBytes);
+    uint64_t* starts = (uint64_t*)sortWorkspaceAlloc(ws, bitmapBytes);
+
+    int* sorted;
+    size_t count = radixSortMarkGroups(arr, scratch, n, reverse, starts, &sorted);
+    free(groups->offsets);
+    groups->keys = (int*)malloc(count * sizeof(int));
+    groups->counts = (size_t*)malloc(count * sizeof(size_t));
+    groups->offsets = (size_t*)malloc((count + 1) * sizeof(size_t));
+    if (groups->keys == NULL || groups->counts == NULL || groups->offsets == NULL) {
+        sortGroupsFree(groups);
+        if (sorted != arr) {
+            memcpy(arr, sorted, scratchBytes);
+        }
+        errno = ENOMEM;
+        return -1;
+    }
+
+    // Only the group starts are read from the sorted keys
+    size_t g = 0;
+    for (size_t w = 0; w <= n / 64; w++) {
+        for (uint64_t bits = starts[w]; bits != 0; bits &= bits - 1) {
+            size_t pos = w * 64 + (size_t)__builtin_ctzll(bits);
+            groups->offsets[g] = pos;
+            groups->keys[g] = sorted[pos];
+            g++;
+        }
+    }
+    groups->offsets[count] = n;
+    for (g = 0; g < count; g++) {
+        groups->counts[g] = groups->offsets[g + 1] - groups->offsets[g];
+    }
+    groups->groupCount = count;
+
+    if (sorted != arr) {
+        SORT_STAT_PHASE_BEGIN(copyStart);
+        memcpy(arr, sorted, scratchBytes);
+        SORT_STAT_MOVE(n);
+        SORT_STAT_PHASE_END(copyStart, SORT_PHASE_COPY);
+    }
+    return 0;
+}
+
+/**
+ * Radix sort that also returns the groups of equal keys.
+ *
+ * @see radixSortGroupsWorkspace
+ */
+int radixSortGroups(int arr[], size_t n, bool reverse, SortGroups* groups) {
+    SortWorkspace ws = SORT_WORKSPACE_INIT;
+    int result = radixSortGroupsWorkspace(arr, n, reverse, groups, &ws);
+    sortWorkspaceFree(&ws);
+    return result;
 }
 
+/**
+ * Sorts and removes duplicates (DISTINCT): afterwards the first k elements
+ * of arr are the distinct keys in sorted order. The compaction reads only
+ * the group starts marked by the final digit pass and also replaces the
+ * copy back from scratch memory that radixSort would need.
+ *
+ * @param arr Array to be sorted and deduplicated
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ * @param ws Workspace to take scratch memory from, or NULL for the per-thread workspace
+ * @return Number of distinct keys k
+ */
+size_t radixSortDistinctWorkspace(int arr[], size_t n, bool reverse, SortWorkspace* ws) {
+    if (n <= 1) {
+        return n;
+    }
+
+    size_t scratchBytes = n * sizeof(int);
+    size_t bitmapBytes = (n / 64 + 1) * sizeof(uint64_t);
+    ws = sortWorkspaceReserve(ws, sortWorkspaceSize(scratchBytes) + sortWorkspaceSize(bitmapBytes));
+    if (ws == NULL) {
+        // Out of memory: heap sort needs no scratch space, then compact neighbours
+        heapSortIntWide(arr, n, reverse);
+        size_t k = 1;
+        for (size_t i = 1; i < n; i++) {
+            if (arr[i] != arr[k - 1]) {
+                arr[k++] = arr[i];
+            }
+        }
+        return k;
+    }
+    int* scratch = (int*)sortWorkspaceAlloc(ws, scratchBytes);
+    uint64_t* starts = (uint64_t*)sortWorkspaceAlloc(ws, bitmapBytes);
+
+    int* sorted;
+    radixSortMarkGroups(arr, scratch, n, reverse, starts, &sorted);
+
+    // Group starts only increase, so compacting within arr is safe
+    SORT_STAT_PHASE_BEGIN(copyStart);
+    size_t k = 0;
+    for (size_t w = 0; w <= n / 64; w++) {
+        for (uint64_t bits = starts[w]; bits != 0; bits &= bits - 1) {
+            arr[k++] = sorted[w * 64 + (size_t)__builtin_ctzll(bits)];
+        }
+    }
+    SORT_STAT_MOVE(k);
+    SORT_STAT_PHASE_END(copyStart, SORT_PHASE_COPY);
+    return k;
+}
+
+/**
+ * Sorts and removes duplicates.
+ *
+ * @see radixSortDistinctWorkspace
+ */
+size_t radixSortDistinct(int arr[], size_t n, bool reverse) {
+    SortWorkspace ws = SORT_WORKSPACE_INIT;
+    size_t k = radixSortDistinctWorkspace(arr, n, reverse, &ws);
+    sortWorkspaceFree(&ws);
+    return k;
+}
+
+#ifdef RADIX_SORT_MAIN
+
 /**
  * Function to print an integer array.
  */
@@ -154,6 +626,26 @@ int main() {
     radixSort(arrDesc, n, true);
     printf("Descending order: ");
     printIntArray(arrDesc, n);
-    
+
+    // Sorting with GROUP BY and DISTINCT results
+    int votes[] = {3, -1, 3, 7, -1, 3, 0};
+    int m = sizeof(votes) / sizeof(votes[0]);
+    SortGroups groups;
+    if (radixSortGroups(votes, m, false, &groups) == 0) {
+        printf("Groups of ");
+        printIntArray(votes, m);
+        for (size_t g = 0; g < groups.groupCount; g++) {
+            printf("  key %d: count %zu at offset %zu\n", groups.keys[g], groups.counts[g], groups.offsets[g]);
+        }
+        sortGroupsFree(&groups);
+    }
+    size_t distinct = radixSortDistinct(votes, m, true);
+    printf("Distinct, descending: ");
+    printIntArray(votes, (int)distinct);
+
     return 0;
 }
+
+#endif /* RADIX_SORT_MAIN */
+
+#endif /* RADIX_SORT_C */
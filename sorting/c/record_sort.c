@@ -0,0 +1,596 @@
+/**
+ * Record Sort - Sorting Fixed-Width Records by a Byte Key
+ *
+ * Time Complexity:
+ * - O(n * k) where k is the number of key bytes, typically a few passes over the entries
+ *
+ * Space Complexity: O(n) - 32 bytes per record for the sort entries, independent of the record size
+ *
+ * How it works:
+ * Records are GraySort-style fixed-width byte strings (for example a 10-byte
+ * key followed by a 90-byte payload) ordered by memcmp on a key at a fixed
+ * offset. Moving 100-byte records during the sort would dominate its cost,
+ * so only 16-byte (prefix, index) entries are sorted and each record is
+ * moved once at the end:
+ * 1. Load the first 8 key bytes of every record as a big-endian integer,
+ *    and count the entries per bucket of the top RECORD_SORT_BUCKET_BITS bits
+ * 2. Scatter the entries into their buckets (stable, in record order)
+ * 3. Sort every bucket with stable MSD radix passes on the 8 highest prefix
+ *    bits that still differ, down to small buckets that are insertion sorted
+ *    by (prefix, index); runs of equal prefixes move on to the next 8 key
+ *    bytes until the key is exhausted, so records with equal keys keep their
+ *    input order
+ * 4. Apply the permutation: recordSortTo gathers the records into a second
+ *    buffer in blocks, prefetching a whole block of sources before copying
+ *    the previous one; recordSort follows the permutation's cycles in place
+ *
+ * With threads > 1, steps 1, 2 and 4 (recordSortTo) split the records into
+ * slices, and threads take buckets for step 3 from a shared atomic counter.
+ * Step 4 of recordSort is sequential.
+ *
+ * Build with -pthread.
+ */
+
+#ifndef RECORD_SORT_C
+#define RECORD_SORT_C
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+
+#ifndef SORTING_NO_MAIN
+#define SORTING_NO_MAIN
+#define RECORD_SORT_MAIN
+#endif
+
+#include "sort_stats.h"
+#include "sort_workspace.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// The bucket pass splits on this many leading key bits
+#define RECORD_SORT_BUCKET_BITS 12
+#define RECORD_SORT_BUCKETS (1u << RECORD_SORT_BUCKET_BITS)
+// Below this many records the entries are sorted without the bucket pass
+#define RECORD_SORT_BUCKET_MIN 16384
+// Buckets up to this size are finished with insertion sort
+#define RECORD_SORT_INSERTION_MAX 24
+// Records whose sources are prefetched together before they are copied
+#define RECORD_SORT_GATHER_BLOCK 32
+// Records per unit of work in the parallel gather
+#define RECORD_SORT_GATHER_CHUNK 65536
+// Inputs below this many records are sorted on the calling thread
+#define RECORD_SORT_PARALLEL_MIN 131072
+#define RECORD_SORT_MAX_THREADS 256
+
+/**
+ * Describes the records and how to order them.
+ */
+typedef struct {
+    size_t recordSize;  // Size of one record in bytes
+    size_t keyOffset;   // Offset of the key inside a record
+    size_t keyLength;   // Number of key bytes, compared with memcmp
+    bool reverse;       // Sort direction
+} RecordSortKey;
+
+/**
+ * A record being sorted: 8 key bytes as a big-endian integer (inverted when
+ * sorting in reverse) and the record's position in the input.
+ */
+typedef struct {
+    uint64_t prefix;
+    uint64_t index;
+} RecordSortEntry;
+
+// Only the insertion sort is used, for the smallest buckets
+#define SORT_TEMPLATE_NAME recordSortEntries
+#define SORT_TEMPLATE_TYPE RecordSortEntry
+#define SORT_TEMPLATE_LESS(a, b) ((a).prefix < (b).prefix || ((a).prefix == (b).prefix && (a).index < (b).index))
+#include "sort_template.h"
+
+/**
+ * Loads the key bytes depth..depth + 7 of a record as a big-endian integer,
+ * zero-padded past the end of the key.
+ */
+static inline uint64_t recordSortPrefix(const unsigned char* key, size_t keyLength, size_t depth, bool reverse) {
+    uint64_t prefix = 0;
+    if (keyLength - depth >= 8) {
+        memcpy(&prefix, key + depth, 8);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        prefix = __builtin_bswap64(prefix);
+#endif
+    } else {
+        for (size_t b = 0; depth + b < keyLength; b++) {
+            prefix |= (uint64_t)key[depth + b] << (56 - 8 * b);
+        }
+    }
+    return reverse ? ~prefix : prefix;
+}
+
+/**
+ * Phases of a record sort; the threads run one phase at a time.
+ */
+typedef enum {
+    RECORD_PHASE_LOAD,
+    RECORD_PHASE_SCATTER,
+    RECORD_PHASE_SORT,
+    RECORD_PHASE_GATHER
+} RecordSortPhase;
+
+/**
+ * Work shared by the threads of one record sort.
+ */
+typedef struct {
+    const unsigned char* src;
+    unsigned char* dst;         // NULL when the permutation is applied in place
+    size_t count;
+    RecordSortKey key;
+    RecordSortEntry* entries;   // Loaded entries, in record order
+    RecordSortEntry* sorted;    // Entries grouped by bucket, then sorted
+    size_t* counts;             // RECORD_SORT_BUCKETS counters per slice
+    size_t* bucketStart;        // RECORD_SORT_BUCKETS + 1 offsets into sorted
+    size_t slices;              // Record ranges of the load and scatter phases
+    RecordSortPhase phase;
+    size_t units;               // Units of work in the current phase
+    atomic_size_t next;         // Next unit to hand out
+} RecordSortJob;
+
+/**
+ * Reloads the prefixes of entries from key byte depth.
+ */
+static void recordSortReload(const RecordSortJob* job, RecordSortEntry entries[], size_t n, size_t depth) {
+    for (size_t i = 0; i < n; i++) {
+        const unsigned char* key = job->src + entries[i].index * job->key.recordSize + job->key.keyOffset;
+        entries[i].prefix = recordSortPrefix(key, job->key.keyLength, depth, job->key.reverse);
+    }
+}
+
+/**
+ * Sorts entries, which are in index order, by (prefix, index): an MSD radix
+ * pass on the 8 highest bits in which the prefixes differ, stable so each
+ * bucket stays in index order, down to buckets of RECORD_SORT_INSERTION_MAX
+ * entries, which are insertion sorted. Runs of equal prefixes then move on
+ * to the next 8 key bytes.
+ *
+ * Only the smaller parts of a split are sorted recursively; the largest
+ * bucket or run is sorted on in the same frame, also when it moves on to
+ * the next key bytes, so the stack depth is O(log n) for keys of any length.
+ *
+ * @param scratch n entries of scratch space
+ * @param depth Key bytes the prefixes start at
+ */
+static void recordSortRange(const RecordSortJob* job, RecordSortEntry entries[], RecordSortEntry scratch[],
+                            size_t n, size_t depth) {
+    while (n > 1) {
+        if (n <= RECORD_SORT_INSERTION_MAX) {
+            recordSortEntriesInsertionSort(entries, n);
+            if (depth + 8 >= job->key.keyLength) {
+                return;
+            }
+
+            // Runs of equal prefixes: recurse into all but the largest, which continues here
+            size_t largestStart = 0, largestLength = 0;
+            for (size_t start = 0, end; start < n; start = end) {
+                end = start + 1;
+                while (end < n && entries[end].prefix == entries[start].prefix) {
+                    end++;
+                }
+                if (end - start > largestLength) {
+                    if (largestLength > 1) {
+                        recordSortReload(job, entries + largestStart, largestLength, depth + 8);
+                        recordSortRange(job, entries + largestStart, scratch + largestStart, largestLength,
+                                        depth + 8);
+                    }
+                    largestStart = start;
+                    largestLength = end - start;
+                } else if (end - start > 1) {
+                    recordSortReload(job, entries + start, end - start, depth + 8);
+                    recordSortRange(job, entries + start, scratch + start, end - start, depth + 8);
+                }
+            }
+            if (largestLength < 2) {
+                return;
+            }
+            entries += largestStart;
+            scratch += largestStart;
+            n = largestLength;
+            depth += 8;
+            recordSortReload(job, entries, n, depth);
+            continue;
+        }
+
+        uint64_t differ = 0;
+        for (size_t i = 1; i < n; i++) {
+            differ |= entries[i].prefix ^ entries[0].prefix;
+        }
+        if (differ == 0) {
+            // One run of equal prefixes, still in index order
+            if (depth + 8 >= job->key.keyLength) {
+                return;
+            }
+            depth += 8;
+            recordSortReload(job, entries, n, depth);
+            continue;
+        }
+
+        int highest = 63 - __builtin_clzll(differ);
+        int shift = highest >= 7 ? highest - 7 : 0;
+        size_t count[256] = {0};
+        for (size_t i = 0; i < n; i++) {
+            count[(entries[i].prefix >> shift) & 0xFF]++;
+        }
+        size_t position[256];
+        size_t sum = 0;
+        int largest = 0;
+        for (int b = 0; b < 256; b++) {
+            position[b] = sum;
+            sum += count[b];
+            largest = count[b] > count[largest] ? b : largest;
+        }
+        for (size_t i = 0; i < n; i++) {
+            scratch[position[(entries[i].prefix >> shift) & 0xFF]++] = entries[i];
+        }
+        memcpy(entries, scratch, n * sizeof(RecordSortEntry));
+        SORT_STAT_MOVE(2 * n);
+
+        size_t start = 0, largestStart = 0;
+        for (int b = 0; b < 256; b++) {
+            if (b == largest) {
+                largestStart = start;
+            } else if (count[b] > 1) {
+                recordSortRange(job, entries + start, scratch + start, count[b], depth);
+            }
+            start += count[b];
+        }
+        entries += largestStart;
+        scratch += largestStart;
+        n = count[largest];
+    }
+}
+
+/**
+ * Returns the first record of a slice of the load and scatter phases.
+ */
+static inline size_t recordSortSliceStart(const RecordSortJob* job, size_t slice) {
+    return job->count / job->slices * slice + (slice < job->count % job->slices ? slice : job->count % job->slices);
+}
+
+/**
+ * Step 1 for one slice: loads its entries and counts them per bucket.
+ */
+static void recordSortLoad(RecordSortJob* job, size_t slice) {
+    size_t* counts = job->counts + slice * RECORD_SORT_BUCKETS;
+    size_t end = recordSortSliceStart(job, slice + 1);
+    memset(counts, 0, RECORD_SORT_BUCKETS * sizeof(size_t));
+
+    for (size_t i = recordSortSliceStart(job, slice); i < end; i++) {
+        const unsigned char* key = job->src + i * job->key.recordSize + job->key.keyOffset;
+        uint64_t prefix = recordSortPrefix(key, job->key.keyLength, 0, job->key.reverse);
+        job->entries[i].prefix = prefix;
+        job->entries[i].index = i;
+        counts[prefix >> (64 - RECORD_SORT_BUCKET_BITS)]++;
+    }
+}
+
+/**
+ * Step 2 for one slice: moves its entries to the positions that the
+ * counts were turned into.
+ */
+static void recordSortScatter(RecordSortJob* job, size_t slice) {
+    size_t* position = job->counts + slice * RECORD_SORT_BUCKETS;
+    size_t end = recordSortSliceStart(job, slice + 1);
+    for (size_t i = recordSortSliceStart(job, slice); i < end; i++) {
+        RecordSortEntry entry = job->entries[i];
+        job->sorted[position[entry.prefix >> (64 - RECORD_SORT_BUCKET_BITS)]++] = entry;
+    }
+    SORT_STAT_MOVE(end - recordSortSliceStart(job, slice));
+}
+
+/**
+ * Prefetches every cache line of a record.
+ */
+static inline void recordSortPrefetch(const unsigned char* record, size_t size) {
+    for (size_t offset = 0; offset < size; offset += 64) {
+        __builtin_prefetch(record + offset);
+    }
+    __builtin_prefetch(record + size - 1);
+}
+
+/**
+ * Step 4 for records first..last - 1 of the output: copies them from src
+ * to dst, a block at a time, with the sources of the next block prefetched.
+ */
+static void recordSortGather(RecordSortJob* job, size_t first, size_t last) {
+    size_t size = job->key.recordSize;
+    const RecordSortEntry* sorted = job->sorted;
+    for (size_t i = first; i < last && i < first + RECORD_SORT_GATHER_BLOCK; i++) {
+        recordSortPrefetch(job->src + sorted[i].index * size, size);
+    }
+
+    for (size_t block = first; block < last; block += RECORD_SORT_GATHER_BLOCK) {
+        size_t blockEnd = block + RECORD_SORT_GATHER_BLOCK < last ? block + RECORD_SORT_GATHER_BLOCK : last;
+        size_t nextEnd = blockEnd + RECORD_SORT_GATHER_BLOCK < last ? blockEnd + RECORD_SORT_GATHER_BLOCK : last;
+        for (size_t i = blockEnd; i < nextEnd; i++) {
+            recordSortPrefetch(job->src + sorted[i].index * size, size);
+        }
+        for (size_t i = block; i < blockEnd; i++) {
+            memcpy(job->dst + i * size, job->src + sorted[i].index * size, size);
+        }
+    }
+}
+
+/**
+ * Worker loop: takes units of the current phase until none are left.
+ */
+static void* recordSortWorker(void* arg) {
+    RecordSortJob* job = (RecordSortJob*)arg;
+    for (;;) {
+        size_t unit = atomic_fetch_add(&job->next, 1);
+        if (unit >= job->units) {
+            break;
+        }
+        switch (job->phase) {
+        case RECORD_PHASE_LOAD:
+            recordSortLoad(job, unit);
+            break;
+        case RECORD_PHASE_SCATTER:
+            recordSortScatter(job, unit);
+            break;
+        case RECORD_PHASE_SORT: {
+            size_t start = job->bucketStart[unit];
+            size_t n = job->bucketStart[unit + 1] - start;
+            if (n > 1) {
+                recordSortRange(job, job->sorted + start, job->entries + start, n, 0);
+            }
+            break;
+        }
+        case RECORD_PHASE_GATHER: {
+            size_t first = unit * RECORD_SORT_GATHER_CHUNK;
+            size_t last = first + RECORD_SORT_GATHER_CHUNK < job->count ? first + RECORD_SORT_GATHER_CHUNK
+                                                                         : job->count;
+            recordSortGather(job, first, last);
+            break;
+        }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Runs one phase on the calling thread and threads - 1 helpers.
+ */
+static void recordSortRunPhase(RecordSortJob* job, RecordSortPhase phase, size_t units, int threads) {
+    job->phase = phase;
+    job->units = units;
+    atomic_init(&job->next, 0);
+
+    // If a helper cannot be started, the threads that did start still drain the whole phase
+    pthread_t helpers[RECORD_SORT_MAX_THREADS];
+    int started = 0;
+    while (started < threads - 1 && (size_t)started + 1 < units &&
+           pthread_create(&helpers[started], NULL, recordSortWorker, job) == 0) {
+        started++;
+    }
+
+    recordSortWorker(job);
+    for (int t = 0; t < started; t++) {
+        pthread_join(helpers[t], NULL);
+    }
+}
+
+/**
+ * Moves every record to its sorted position in place by following the
+ * cycles of the permutation; each record is moved once.
+ */
+static void recordSortApplyInPlace(RecordSortJob* job, unsigned char* temp) {
+    unsigned char* base = (unsigned char*)job->src;
+    size_t size = job->key.recordSize;
+    RecordSortEntry* sorted = job->sorted;
+
+    for (size_t i = 0; i < job->count; i++) {
+        if (sorted[i].index == i || sorted[i].index == UINT64_MAX) {
+            continue;
+        }
+        // Position j receives record sorted[j].index; mark each position once filled
+        memcpy(temp, base + i * size, size);
+        size_t j = i;
+        for (;;) {
+            size_t from = sorted[j].index;
+            sorted[j].index = UINT64_MAX;
+            if (from == i) {
+                memcpy(base + j * size, temp, size);
+                break;
+            }
+            __builtin_prefetch(base + sorted[from].index * size);
+            memcpy(base + j * size, base + from * size, size);
+            SORT_STAT_MOVE(1);
+            j = from;
+        }
+    }
+}
+
+/**
+ * Shared implementation of recordSortTo and recordSort.
+ */
+static int recordSortImpl(const void* src, void* dst, size_t count, const RecordSortKey* key, int threads,
+                          SortWorkspace* ws) {
+    if (key->recordSize == 0 || key->keyOffset > key->recordSize ||
+        key->keyLength > key->recordSize - key->keyOffset || count > SIZE_MAX / key->recordSize) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    if (count > SIZE_MAX / (4 * sizeof(RecordSortEntry))) {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    if (threads > RECORD_SORT_MAX_THREADS) {
+        threads = RECORD_SORT_MAX_THREADS;
+    }
+    if (count < RECORD_SORT_PARALLEL_MIN) {
+        threads = 1;
+    }
+
+    RecordSortJob job;
+    job.src = (const unsigned char*)src;
+    job.dst = (unsigned char*)dst;
+    job.count = count;
+    job.key = *key;
+    job.slices = (size_t)threads;
+
+    bool bucketed = count >= RECORD_SORT_BUCKET_MIN;
+    size_t entryBytes = count * sizeof(RecordSortEntry);
+    size_t countBytes = bucketed ? job.slices * RECORD_SORT_BUCKETS * sizeof(size_t) : 0;
+    size_t startBytes = bucketed ? (RECORD_SORT_BUCKETS + 1) * sizeof(size_t) : 0;
+    size_t tempBytes = dst == NULL ? key->recordSize : 0;
+    ws = sortWorkspaceReserve(ws, 2 * sortWorkspaceSize(entryBytes) +
+                                  sortWorkspaceSize(countBytes) + sortWorkspaceSize(startBytes) +
+                                  sortWorkspaceSize(tempBytes));
+    if (ws == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    job.entries = (RecordSortEntry*)sortWorkspaceAlloc(ws, entryBytes);
+    job.sorted = (RecordSortEntry*)sortWorkspaceAlloc(ws, entryBytes);
+    job.counts = (size_t*)sortWorkspaceAlloc(ws, countBytes);
+    job.bucketStart = (size_t*)sortWorkspaceAlloc(ws, startBytes);
+    unsigned char* temp = (unsigned char*)sortWorkspaceAlloc(ws, tempBytes);
+
+    if (!bucketed) {
+        job.slices = 1;
+        for (size_t i = 0; i < count; i++) {
+            const unsigned char* k = job.src + i * key->recordSize + key->keyOffset;
+            job.sorted[i].prefix = recordSortPrefix(k, key->keyLength, 0, key->reverse);
+            job.sorted[i].index = i;
+        }
+        SORT_STAT_PHASE_BEGIN(sortStart);
+        recordSortRange(&job, job.sorted, job.entries, count, 0);
+        SORT_STAT_PHASE_END(sortStart, SORT_PHASE_PARTITION);
+    } else {
+        SORT_STAT_PHASE_BEGIN(distributeStart);
+        recordSortRunPhase(&job, RECORD_PHASE_LOAD, job.slices, threads);
+
+        // Turn the counts into positions: bucket by bucket, slice by slice, so the scatter is stable
+        size_t position = 0;
+        for (size_t b = 0; b < RECORD_SORT_BUCKETS; b++) {
+            job.bucketStart[b] = position;
+            for (size_t s = 0; s < job.slices; s++) {
+                size_t n = job.counts[s * RECORD_SORT_BUCKETS + b];
+                job.counts[s * RECORD_SORT_BUCKETS + b] = position;
+                position += n;
+            }
+        }
+        job.bucketStart[RECORD_SORT_BUCKETS] = position;
+
+        recordSortRunPhase(&job, RECORD_PHASE_SCATTER, job.slices, threads);
+        SORT_STAT_PHASE_END(distributeStart, SORT_PHASE_DISTRIBUTE);
+
+        SORT_STAT_PHASE_BEGIN(sortStart);
+        recordSortRunPhase(&job, RECORD_PHASE_SORT, RECORD_SORT_BUCKETS, threads);
+        SORT_STAT_PHASE_END(sortStart, SORT_PHASE_PARTITION);
+    }
+
+    SORT_STAT_PHASE_BEGIN(copyStart);
+    if (dst != NULL) {
+        size_t chunks = (count + RECORD_SORT_GATHER_CHUNK - 1) / RECORD_SORT_GATHER_CHUNK;
+        recordSortRunPhase(&job, RECORD_PHASE_GATHER, chunks, threads);
+    } else {
+        recordSortApplyInPlace(&job, temp);
+    }
+    SORT_STAT_PHASE_END(copyStart, SORT_PHASE_COPY);
+    return 0;
+}
+
+/**
+ * Sorts count records from src into dst, in memcmp order of their keys.
+ * Records with equal keys keep their input order. src is not modified.
+ *
+ * @param src Records to sort, count * key->recordSize bytes
+ * @param dst Output buffer of the same size; must not overlap src
+ * @param count Number of records
+ * @param key Record size, key position and direction
+ * @param threads Number of threads to use, or 0 for one per online CPU
+ * @param ws Workspace for the 32 bytes per record of sort entries, or NULL
+ *           for the per-thread workspace
+ * @return 0 on success, -1 with errno set to EINVAL for a key outside the
+ *         record or ENOMEM if the entries cannot be allocated
+ */
+int recordSortTo(const void* src, void* dst, size_t count, const RecordSortKey* key, int threads,
+                 SortWorkspace* ws) {
+    if (dst == NULL && count > 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    return recordSortImpl(src, dst, count, key, threads, ws);
+}
+
+/**
+ * Sorts count records in place; see recordSortTo. Only the sort itself is
+ * parallel: the records are moved into place by a single thread.
+ *
+ * @param records Records to sort, count * key->recordSize bytes
+ * @param count Number of records
+ * @param key Record size, key position and direction
+ * @param threads Number of threads to use, or 0 for one per online CPU
+ * @param ws Workspace, or NULL for the per-thread workspace
+ * @return 0 on success, -1 with errno set on failure
+ */
+int recordSort(void* records, size_t count, const RecordSortKey* key, int threads, SortWorkspace* ws) {
+    return recordSortImpl(records, NULL, count, key, threads, ws);
+}
+
+#ifdef RECORD_SORT_MAIN
+
+/**
+ * Main function with examples.
+ */
+int main() {
+    // 16-byte records: a 4-character key at offset 2 between other fields
+    const char* input[] = {
+        "01pear  payload1", "02fig   payload2", "03apple payload3",
+        "04fig   payload4", "05kiwi  payload5", "06apple payload6",
+    };
+    size_t count = sizeof(input) / sizeof(input[0]);
+    char records[6][16];
+    char sorted[6][16];
+    for (size_t i = 0; i < count; i++) {
+        memcpy(records[i], input[i], 16);
+    }
+
+    RecordSortKey key = {16, 2, 4, false};
+    if (recordSortTo(records, sorted, count, &key, 1, NULL) != 0) {
+        perror("recordSortTo");
+        return 1;
+    }
+    printf("Sorted by bytes 2..5 (equal keys keep their order):\n");
+    for (size_t i = 0; i < count; i++) {
+        printf("  %.16s\n", sorted[i]);
+    }
+
+    key.reverse = true;
+    recordSort(records, count, &key, 0, NULL);
+    printf("Sorted in place, descending:\n");
+    for (size_t i = 0; i < count; i++) {
+        printf("  %.16s\n", records[i]);
+    }
+    return 0;
+}
+
+#endif /* RECORD_SORT_MAIN */
+
+#endif /* RECORD_SORT_C */
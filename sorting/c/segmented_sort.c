@@ -0,0 +1,428 @@
+/**
+ * Segmented Sort - Sorting Many Small Arrays in One Call
+ *
+ * Time Complexity:
+ * - O(sum of s log s) over the segment sizes s; O(s) per segment for radix-sized segments
+ *
+ * Space Complexity: O(largest radix-sorted segment) per thread, reused across calls
+ *
+ * How it works:
+ * The keys of all segments live in one flat array, and segment i is
+ * keys[offsets[i]..offsets[i + 1]). A single call sorts every segment
+ * in place, with no allocation or copy per segment:
+ * 1. Each segment gets a kernel chosen by its size: a sorting network up to
+ *    8 elements, insertion sort up to 48 and a byte-wise LSD radix sort above
+ *    that (on random keys radix sort already beats both quicksorts at 64)
+ * 2. The segments are cut into chunks of roughly equal element count, and
+ *    worker threads take chunks from a shared atomic counter, so a few huge
+ *    segments do not leave the other threads idle
+ * 3. Radix scratch comes from the per-thread SortWorkspace, which stops
+ *    allocating once it has reached the largest segment a thread has seen
+ *
+ * Build with -pthread.
+ */
+
+#ifndef SEGMENTED_SORT_C
+#define SEGMENTED_SORT_C
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+
+#ifndef SORTING_NO_MAIN
+#define SORTING_NO_MAIN
+#define SEGMENTED_SORT_MAIN
+#endif
+
+#include "insertion_sort.c"
+#include "quicksort.c"
+#include "sort_index.h"
+#include "sort_stats.h"
+#include "sort_workspace.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <unistd.h>
+
+// Largest segment sorted by a sorting network
+#define SEGMENTED_NETWORK_MAX 8
+// Largest segment sorted by insertion sort; larger ones are radix sorted
+#define SEGMENTED_INSERTION_MAX 48
+// Elements per unit of work handed to a thread
+#define SEGMENTED_CHUNK_ELEMENTS 65536
+// Inputs below this many elements are sorted on the calling thread
+#define SEGMENTED_PARALLEL_MIN 131072
+#define SEGMENTED_MAX_THREADS 256
+
+/**
+ * Compare-exchange pairs of size-optimal sorting networks for 2 to 8 elements.
+ */
+static const unsigned char segmentedNetwork2[][2] = {{0, 1}};
+static const unsigned char segmentedNetwork3[][2] = {{0, 2}, {0, 1}, {1, 2}};
+static const unsigned char segmentedNetwork4[][2] = {{0, 2}, {1, 3}, {0, 1}, {2, 3}, {1, 2}};
+static const unsigned char segmentedNetwork5[][2] = {
+    {0, 3}, {1, 4}, {0, 2}, {1, 3}, {0, 1}, {2, 4}, {1, 2}, {3, 4}, {2, 3},
+};
+static const unsigned char segmentedNetwork6[][2] = {
+    {0, 5}, {1, 3}, {2, 4}, {1, 2}, {3, 4}, {0, 3}, {2, 5}, {0, 1}, {2, 3}, {4, 5}, {1, 2}, {3, 4},
+};
+static const unsigned char segmentedNetwork7[][2] = {
+    {0, 6}, {2, 3}, {4, 5}, {0, 2}, {1, 4}, {3, 6}, {0, 1}, {2, 5},
+    {3, 4}, {1, 2}, {4, 6}, {2, 3}, {4, 5}, {1, 2}, {3, 4}, {5, 6},
+};
+static const unsigned char segmentedNetwork8[][2] = {
+    {0, 2}, {1, 3}, {4, 6}, {5, 7}, {0, 4}, {1, 5}, {2, 6}, {3, 7}, {0, 1}, {2, 3},
+    {4, 5}, {6, 7}, {2, 4}, {3, 5}, {1, 4}, {3, 6}, {1, 2}, {3, 4}, {5, 6},
+};
+
+static const unsigned char (*const segmentedNetworks[])[2] = {
+    NULL, NULL, segmentedNetwork2, segmentedNetwork3, segmentedNetwork4,
+    segmentedNetwork5, segmentedNetwork6, segmentedNetwork7, segmentedNetwork8,
+};
+static const int segmentedNetworkSizes[] = {0, 0, 1, 3, 5, 9, 12, 16, 19};
+
+/**
+ * Sorts up to 8 integers with a sorting network. Every compare-exchange is a
+ * branchless min/max, so the cost does not depend on the input order.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array (at most SEGMENTED_NETWORK_MAX)
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void sortingNetworkInt(int arr[], int n, bool reverse) {
+    if (n < 2) {
+        return;
+    }
+    const unsigned char (*pairs)[2] = segmentedNetworks[n];
+    for (int p = 0; p < segmentedNetworkSizes[n]; p++) {
+        int a = arr[pairs[p][0]];
+        int b = arr[pairs[p][1]];
+        int low = a < b ? a : b;
+        int high = a < b ? b : a;
+        arr[pairs[p][0]] = reverse ? high : low;
+        arr[pairs[p][1]] = reverse ? low : high;
+        SORT_STAT_COMPARE();
+    }
+}
+
+/**
+ * LSD radix sort of arbitrary (also negative) integers, one byte per pass.
+ * The sign bit is flipped so the bytes compare in two's complement order,
+ * and passes in which every key has the same byte are skipped.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ * @param ws Workspace for the n-element scratch buffer, or NULL for the per-thread workspace
+ */
+void byteRadixSortInt(int arr[], size_t n, bool reverse, SortWorkspace* ws) {
+    size_t bytes = n * sizeof(uint32_t);
+    ws = sortWorkspaceReserve(ws, sortWorkspaceSize(bytes));
+    if (ws == NULL) {
+        quicksort3WayIntWide(arr, n, reverse);
+        return;
+    }
+
+    uint32_t* src = (uint32_t*)arr;
+    uint32_t* dst = (uint32_t*)sortWorkspaceAlloc(ws, bytes);
+
+    // One counting pass builds the histograms of all four bytes
+    size_t count[4][256];
+    memset(count, 0, sizeof(count));
+    SORT_STAT_PHASE_BEGIN(distributeStart);
+    for (size_t i = 0; i < n; i++) {
+        uint32_t key = src[i] ^ 0x80000000u;
+        count[0][key & 0xFF]++;
+        count[1][(key >> 8) & 0xFF]++;
+        count[2][(key >> 16) & 0xFF]++;
+        count[3][key >> 24]++;
+    }
+
+    for (int pass = 0; pass < 4; pass++) {
+        int shift = pass * 8;
+
+        // Every key has the same byte here: the pass would not move anything
+        if (count[pass][((src[0] ^ 0x80000000u) >> shift) & 0xFF] == n) {
+            continue;
+        }
+
+        // Turn the counts into starting positions, largest byte first when reversed
+        size_t pos[256];
+        size_t sum = 0;
+        for (int b = 0; b < 256; b++) {
+            int bucket = reverse ? 255 - b : b;
+            pos[bucket] = sum;
+            sum += count[pass][bucket];
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            uint32_t byte = ((src[i] ^ 0x80000000u) >> shift) & 0xFF;
+            dst[pos[byte]++] = src[i];
+        }
+        SORT_STAT_MOVE(n);
+
+        uint32_t* temp = src;
+        src = dst;
+        dst = temp;
+    }
+    SORT_STAT_PHASE_END(distributeStart, SORT_PHASE_DISTRIBUTE);
+
+    if (src != (uint32_t*)arr) {
+        SORT_STAT_PHASE_BEGIN(copyStart);
+        memcpy(arr, src, bytes);
+        SORT_STAT_MOVE(n);
+        SORT_STAT_PHASE_END(copyStart, SORT_PHASE_COPY);
+    }
+}
+
+/**
+ * Sorts one integer segment with the kernel for its size.
+ *
+ * @param ws Workspace for the radix sort, or NULL for the per-thread workspace
+ */
+static void segmentedSortOneInt(int arr[], size_t n, bool reverse, SortWorkspace* ws) {
+    if (n <= SEGMENTED_NETWORK_MAX) {
+        sortingNetworkInt(arr, (int)n, reverse);
+    } else if (n <= SEGMENTED_INSERTION_MAX) {
+        insertionSortInt(arr, (int)n, reverse);
+    } else {
+        byteRadixSortInt(arr, n, reverse, ws);
+    }
+}
+
+/**
+ * Sorts one string segment: insertion sort for small segments, three-way
+ * quicksort (no scratch memory) otherwise.
+ */
+static void segmentedSortOneString(char* arr[], size_t n, bool reverse) {
+    if (n <= SEGMENTED_INSERTION_MAX / 2) {
+        insertionSortString(arr, (int)n, reverse);
+    } else {
+        quicksort3WayStringWide(arr, n, reverse);
+    }
+}
+
+/**
+ * Work shared by the threads of one segmented sort.
+ */
+typedef struct {
+    int* intKeys;           // Exactly one of intKeys and stringKeys is set
+    char** stringKeys;
+    const size_t* offsets;
+    size_t segmentCount;
+    bool reverse;
+    size_t chunkSegments;   // Segments per chunk
+    atomic_size_t next;     // First segment of the next chunk to hand out
+} SegmentedJob;
+
+/**
+ * One thread of a segmented sort.
+ */
+typedef struct {
+    SegmentedJob* job;
+    SortWorkspace* ws;      // Radix scratch, or NULL for the per-thread workspace
+} SegmentedWorker;
+
+/**
+ * Worker loop: takes chunks of segments until none are left.
+ */
+static void* segmentedWorker(void* arg) {
+    SegmentedJob* job = ((SegmentedWorker*)arg)->job;
+    SortWorkspace* ws = ((SegmentedWorker*)arg)->ws;
+    for (;;) {
+        size_t first = atomic_fetch_add(&job->next, job->chunkSegments);
+        if (first >= job->segmentCount) {
+            break;
+        }
+        size_t last = first + job->chunkSegments < job->segmentCount ? first + job->chunkSegments
+                                                                        : job->segmentCount;
+        for (size_t s = first; s < last; s++) {
+            size_t start = job->offsets[s];
+            size_t n = job->offsets[s + 1] - start;
+            if (job->intKeys != NULL) {
+                segmentedSortOneInt(job->intKeys + start, n, job->reverse, ws);
+            } else {
+                segmentedSortOneString(job->stringKeys + start, n, job->reverse);
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Runs a segmented job on the calling thread and threads - 1 helpers.
+ */
+static void segmentedRun(SegmentedJob* job, int threads) {
+    size_t total = job->offsets[job->segmentCount] - job->offsets[0];
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    if (threads > SEGMENTED_MAX_THREADS) {
+        threads = SEGMENTED_MAX_THREADS;
+    }
+    if (total < SEGMENTED_PARALLEL_MIN || job->segmentCount < 2) {
+        threads = 1;
+    }
+
+    // Chunks hold about SEGMENTED_CHUNK_ELEMENTS keys on average, and there
+    // are enough of them for the threads to balance uneven segment sizes
+    size_t averageSegment = total / job->segmentCount + 1;
+    job->chunkSegments = SEGMENTED_CHUNK_ELEMENTS / averageSegment + 1;
+    atomic_init(&job->next, 0);
+
+    // Helpers sort with their own workspaces, freed once they are joined, since
+    // nothing frees a per-thread workspace when its thread exits. If a helper
+    // cannot be started, the threads that did start still drain the whole job
+    pthread_t helpers[SEGMENTED_MAX_THREADS];
+    SortWorkspace helperWorkspaces[SEGMENTED_MAX_THREADS] = {SORT_WORKSPACE_INIT};
+    SegmentedWorker workers[SEGMENTED_MAX_THREADS];
+    int started = 0;
+    while (started < threads - 1) {
+        workers[started] = (SegmentedWorker){job, &helperWorkspaces[started]};
+        if (pthread_create(&helpers[started], NULL, segmentedWorker, &workers[started]) != 0) {
+            break;
+        }
+        started++;
+    }
+
+    SegmentedWorker self = {job, NULL};
+    segmentedWorker(&self);
+    for (int t = 0; t < started; t++) {
+        pthread_join(helpers[t], NULL);
+        sortWorkspaceFree(&helperWorkspaces[t]);
+    }
+}
+
+/**
+ * Checks that the offsets are non-decreasing.
+ *
+ * @return 0 if they are, -1 with errno set to EINVAL otherwise
+ */
+static int segmentedCheckOffsets(const size_t offsets[], size_t segmentCount) {
+    for (size_t s = 0; s < segmentCount; s++) {
+        if (offsets[s + 1] < offsets[s]) {
+            errno = EINVAL;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Sorts every segment keys[offsets[i]..offsets[i + 1]) of a flat integer
+ * array in place.
+ *
+ * @param keys Flat array holding all segments
+ * @param offsets segmentCount + 1 non-decreasing offsets into keys
+ * @param segmentCount Number of segments
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ * @param threads Number of threads to use, or 0 for one per online CPU
+ * @return 0 on success, -1 on invalid offsets with errno set to EINVAL
+ */
+int segmentedSortInt(int keys[], const size_t offsets[], size_t segmentCount, bool reverse, int threads) {
+    if (segmentCount == 0) {
+        return 0;
+    }
+    if (segmentedCheckOffsets(offsets, segmentCount) != 0) {
+        return -1;
+    }
+
+    SegmentedJob job;
+    job.intKeys = keys;
+    job.stringKeys = NULL;
+    job.offsets = offsets;
+    job.segmentCount = segmentCount;
+    job.reverse = reverse;
+    segmentedRun(&job, threads);
+    return 0;
+}
+
+/**
+ * Sorts every segment arr[offsets[i]..offsets[i + 1]) of a flat string
+ * array in place.
+ *
+ * @param arr Flat array holding all segments
+ * @param offsets segmentCount + 1 non-decreasing offsets into arr
+ * @param segmentCount Number of segments
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ * @param threads Number of threads to use, or 0 for one per online CPU
+ * @return 0 on success, -1 on invalid offsets with errno set to EINVAL
+ */
+int segmentedSortString(char* arr[], const size_t offsets[], size_t segmentCount, bool reverse, int threads) {
+    if (segmentCount == 0) {
+        return 0;
+    }
+    if (segmentedCheckOffsets(offsets, segmentCount) != 0) {
+        return -1;
+    }
+
+    SegmentedJob job;
+    job.intKeys = NULL;
+    job.stringKeys = arr;
+    job.offsets = offsets;
+    job.segmentCount = segmentCount;
+    job.reverse = reverse;
+    segmentedRun(&job, threads);
+    return 0;
+}
+
+#ifdef SEGMENTED_SORT_MAIN
+
+/**
+ * Prints every segment of a flat integer array on its own line.
+ */
+void printSegments(int keys[], const size_t offsets[], size_t segmentCount) {
+    for (size_t s = 0; s < segmentCount; s++) {
+        printf("  segment %zu: [", s);
+        for (size_t i = offsets[s]; i < offsets[s + 1]; i++) {
+            printf("%d", keys[i]);
+            if (i + 1 < offsets[s + 1]) {
+                printf(", ");
+            }
+        }
+        printf("]\n");
+    }
+}
+
+/**
+ * Main function with examples.
+ */
+int main() {
+    // Three groups of a GROUP BY, stored back to back
+    int keys[] = {5, 3, 9, 1, 42, -7, 0, 8, 8, 2, 13, 6};
+    size_t offsets[] = {0, 4, 5, 12};
+    size_t segmentCount = sizeof(offsets) / sizeof(offsets[0]) - 1;
+
+    printf("Original segments:\n");
+    printSegments(keys, offsets, segmentCount);
+
+    segmentedSortInt(keys, offsets, segmentCount, false, 0);
+    printf("Ascending order:\n");
+    printSegments(keys, offsets, segmentCount);
+
+    segmentedSortInt(keys, offsets, segmentCount, true, 0);
+    printf("Descending order:\n");
+    printSegments(keys, offsets, segmentCount);
+
+    // Example with strings
+    char* words[] = {"pear", "apple", "fig", "kiwi", "banana", "cherry"};
+    size_t wordOffsets[] = {0, 3, 6};
+    segmentedSortString(words, wordOffsets, 2, false, 0);
+    printf("\nString segments in ascending order:\n");
+    for (size_t s = 0; s < 2; s++) {
+        printf("  segment %zu: [", s);
+        for (size_t i = wordOffsets[s]; i < wordOffsets[s + 1]; i++) {
+            printf("\"%s\"%s", words[i], i + 1 < wordOffsets[s + 1] ? ", " : "");
+        }
+        printf("]\n");
+    }
+
+    return 0;
+}
+
+#endif /* SEGMENTED_SORT_MAIN */
+
+#endif /* SEGMENTED_SORT_C */
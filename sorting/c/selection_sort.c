@@ -14,11 +14,17 @@
  * and places it in the correct position in the sorted subarray.
  */
 
+#ifndef SELECTION_SORT_C
+#define SELECTION_SORT_C
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 
+#include "sort_index.h"
+#include "sort_stats.h"
+
 /**
  * Implementation of the Selection Sort algorithm for integers.
  * 
@@ -27,12 +33,6 @@
  * @param reverse If true, sorts in descending order; if false, in ascending order
  */
 void selectionSortInt(int arr[], int n, bool reverse) {
-    // Use a copy of the array to avoid modifying the original
-    int* result = (int*)malloc(n * sizeof(int));
-    for (int i = 0; i < n; i++) {
-        result[i] = arr[i];
-    }
-    
     for (int i = 0; i < n; i++) {
         // Assume the first unsorted element is the extreme (minimum or maximum)
         int extremeIdx = i;
@@ -40,27 +40,21 @@ void selectionSortInt(int arr[], int n, bool reverse) {
         // Find the extreme element (minimum or maximum) in the unsorted part
         for (int j = i + 1; j < n; j++) {
             // Comparison based on sort direction
-            if ((!reverse && result[j] < result[extremeIdx]) || 
-                (reverse && result[j] > result[extremeIdx])) {
+            SORT_STAT_COMPARE();
+            if ((!reverse && arr[j] < arr[extremeIdx]) || 
+                (reverse && arr[j] > arr[extremeIdx])) {
                 extremeIdx = j;
             }
         }
         
         // Swap the extreme element with the first unsorted element
         if (extremeIdx != i) {
-            int temp = result[i];
-            result[i] = result[extremeIdx];
-            result[extremeIdx] = temp;
+            int temp = arr[i];
+            arr[i] = arr[extremeIdx];
+            arr[extremeIdx] = temp;
+            SORT_STAT_SWAP();
         }
     }
-    
-    // Copy the result back to the original array
-    for (int i = 0; i < n; i++) {
-        arr[i] = result[i];
-    }
-    
-    // Free allocated memory
-    free(result);
 }
 
 /**
@@ -71,12 +65,6 @@ void selectionSortInt(int arr[], int n, bool reverse) {
  * @param reverse If true, sorts in descending order; if false, in ascending order
  */
 void selectionSortString(char* arr[], int n, bool reverse) {
-    // Use a copy of the array to avoid modifying the original
-    char** result = (char**)malloc(n * sizeof(char*));
-    for (int i = 0; i < n; i++) {
-        result[i] = arr[i];
-    }
-    
     for (int i = 0; i < n; i++) {
         // Assume the first unsorted element is the extreme (minimum or maximum)
         int extremeIdx = i;
@@ -84,29 +72,89 @@ void selectionSortString(char* arr[], int n, bool reverse) {
         // Find the extreme element (minimum or maximum) in the unsorted part
         for (int j = i + 1; j < n; j++) {
             // Comparison based on sort direction
-            if ((!reverse && strcmp(result[j], result[extremeIdx]) < 0) || 
-                (reverse && strcmp(result[j], result[extremeIdx]) > 0)) {
+            SORT_STAT_COMPARE();
+            if ((!reverse && strcmp(arr[j], arr[extremeIdx]) < 0) || 
+                (reverse && strcmp(arr[j], arr[extremeIdx]) > 0)) {
                 extremeIdx = j;
             }
         }
         
         // Swap the extreme element with the first unsorted element
         if (extremeIdx != i) {
-            char* temp = result[i];
-            result[i] = result[extremeIdx];
-            result[extremeIdx] = temp;
+            char* temp = arr[i];
+            arr[i] = arr[extremeIdx];
+            arr[extremeIdx] = temp;
+            SORT_STAT_SWAP();
         }
     }
-    
-    // Copy the result back to the original array
-    for (int i = 0; i < n; i++) {
-        arr[i] = result[i];
+}
+
+/**
+ * Selection Sort for integers with a size_t element count.
+ * Arrays that fit in an int index are sorted by selectionSortInt.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void selectionSortIntWide(int arr[], size_t n, bool reverse) {
+    if (sortFitsInt(n)) {
+        selectionSortInt(arr, (int)n, reverse);
+        return;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        size_t extremeIdx = i;
+        for (size_t j = i + 1; j < n; j++) {
+            SORT_STAT_COMPARE();
+            if (reverse ? arr[j] > arr[extremeIdx] : arr[j] < arr[extremeIdx]) {
+                extremeIdx = j;
+            }
+        }
+
+        if (extremeIdx != i) {
+            int temp = arr[i];
+            arr[i] = arr[extremeIdx];
+            arr[extremeIdx] = temp;
+            SORT_STAT_SWAP();
+        }
     }
-    
-    // Free allocated memory
-    free(result);
 }
 
+/**
+ * Selection Sort for strings with a size_t element count.
+ *
+ * @param arr String array to be sorted
+ * @param n Size of the array
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+void selectionSortStringWide(char* arr[], size_t n, bool reverse) {
+    if (sortFitsInt(n)) {
+        selectionSortString(arr, (int)n, reverse);
+        return;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        size_t extremeIdx = i;
+        for (size_t j = i + 1; j < n; j++) {
+            SORT_STAT_COMPARE();
+            int cmp = strcmp(arr[j], arr[extremeIdx]);
+            if (reverse ? cmp > 0 : cmp < 0) {
+                extremeIdx = j;
+            }
+        }
+
+        if (extremeIdx != i) {
+            char* temp = arr[i];
+            arr[i] = arr[extremeIdx];
+            arr[extremeIdx] = temp;
+            SORT_STAT_SWAP();
+        }
+    }
+}
+
+#ifndef SORTING_NO_MAIN
+
 /**
  * Function to print an integer array.
  */
@@ -187,3 +235,7 @@ int main() {
     
     return 0;
 }
+
+#endif /* SORTING_NO_MAIN */
+
+#endif /* SELECTION_SORT_C */
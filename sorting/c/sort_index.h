@@ -0,0 +1,33 @@
+/**
+ * Sort Index - Element Counts Beyond INT_MAX
+ *
+ * Every algorithm has int-indexed entry points (xxxSortInt(int arr[], int n, ...))
+ * and size_t entry points with a Wide suffix (xxxSortIntWide(int arr[], size_t n, ...)).
+ * The Wide variants hand any array, or any subarray produced while sorting,
+ * that fits in an int index over to the int implementation, so 32-bit indices
+ * are used wherever they fit and 64-bit arithmetic only where it is needed.
+ *
+ * Compiling with -DSORT_INT_INDEX_MAX=<small number> lowers the switch-over
+ * point, which exercises the 64-bit paths on inputs that fit in memory.
+ */
+
+#ifndef SORT_INDEX_H
+#define SORT_INDEX_H
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Largest element count handled by the int-indexed implementations
+#ifndef SORT_INT_INDEX_MAX
+#define SORT_INT_INDEX_MAX INT_MAX
+#endif
+
+/**
+ * Returns true if n elements can be sorted with int indices.
+ */
+static inline bool sortFitsInt(size_t n) {
+    return n <= (size_t)SORT_INT_INDEX_MAX;
+}
+
+#endif /* SORT_INDEX_H */
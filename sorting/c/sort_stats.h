@@ -0,0 +1,201 @@
+/**
+ * Sort Statistics - Compile-Time Switchable Instrumentation
+ *
+ * When the code is compiled with -DSORT_STATS, the sorting algorithms count
+ * comparisons, element moves, swaps, heap allocations, maximum recursion
+ * depth and the time spent in each phase (partition, merge, copy,
+ * distribute). With -DSORT_STATS_PERF on Linux, cycles, branch misses and
+ * last-level cache misses are also read through perf_event_open.
+ *
+ * Without SORT_STATS every hook expands to nothing, so the algorithms
+ * compile to exactly the same code as without instrumentation.
+ *
+ * Usage:
+ *   sortStatsReset();
+ *   quicksortInt(arr, n, false);
+ *   SortStats stats = sortStatsGet();
+ *
+ * Counters are per thread. They are shared by all algorithms included in
+ * the same translation unit, which is how the benchmarks and tools build.
+ */
+
+#ifndef SORT_STATS_H
+#define SORT_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * Phases whose wall-clock time is measured separately.
+ */
+typedef enum {
+    SORT_PHASE_PARTITION,   // Quicksort partitioning
+    SORT_PHASE_MERGE,       // Merging sorted runs
+    SORT_PHASE_COPY,        // Copying data between buffers
+    SORT_PHASE_DISTRIBUTE,  // Radix counting and scatter passes
+    SORT_PHASES
+} SortPhase;
+
+/**
+ * Statistics of the sorts run since the last sortStatsReset.
+ */
+typedef struct {
+    uint64_t comparisons;
+    uint64_t moves;           // Element writes, excluding swaps
+    uint64_t swaps;
+    uint64_t allocations;
+    uint64_t bytesAllocated;
+    int depth;                // Current recursion depth
+    int maxDepth;
+    double phaseSeconds[SORT_PHASES];
+
+    bool hardwareCounters;    // true if the fields below were measured
+    uint64_t cycles;
+    uint64_t branchMisses;
+    uint64_t cacheMisses;     // Last-level cache misses
+} SortStats;
+
+#ifdef SORT_STATS
+
+#include <time.h>
+
+#if defined(SORT_STATS_PERF) && defined(__linux__)
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#define SORT_STATS_HAVE_PERF 1
+#endif
+
+/**
+ * Returns the statistics of the calling thread.
+ */
+static inline SortStats* sortStatsCurrent(void) {
+    static _Thread_local SortStats stats;
+    return &stats;
+}
+
+/**
+ * Returns a monotonic timestamp in seconds for phase timing.
+ */
+static inline double sortStatsNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+#ifdef SORT_STATS_HAVE_PERF
+
+/**
+ * Returns the perf event descriptors of the calling thread, opening them on
+ * first use. A descriptor is -1 if the counter is not available (for example
+ * because of perf_event_paranoid).
+ */
+static inline int* sortStatsPerfFds(void) {
+    static _Thread_local int fds[3] = {-2, -2, -2};
+    if (fds[0] == -2) {
+        uint64_t configs[3] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES,
+        };
+        for (int i = 0; i < 3; i++) {
+            struct perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        }
+    }
+    return fds;
+}
+
+#endif /* SORT_STATS_HAVE_PERF */
+
+/**
+ * Clears the statistics of the calling thread and restarts the hardware counters.
+ */
+static inline void sortStatsReset(void) {
+    memset(sortStatsCurrent(), 0, sizeof(SortStats));
+#ifdef SORT_STATS_HAVE_PERF
+    int* fds = sortStatsPerfFds();
+    for (int i = 0; i < 3; i++) {
+        if (fds[i] >= 0) {
+            ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+/**
+ * Returns a snapshot of the statistics of the calling thread.
+ */
+static inline SortStats sortStatsGet(void) {
+    SortStats snapshot = *sortStatsCurrent();
+#ifdef SORT_STATS_HAVE_PERF
+    int* fds = sortStatsPerfFds();
+    uint64_t* fields[3] = {&snapshot.cycles, &snapshot.branchMisses, &snapshot.cacheMisses};
+    snapshot.hardwareCounters = true;
+    for (int i = 0; i < 3; i++) {
+        if (fds[i] < 0 || read(fds[i], fields[i], sizeof(uint64_t)) != sizeof(uint64_t)) {
+            snapshot.hardwareCounters = false;
+        }
+    }
+#endif
+    return snapshot;
+}
+
+// Counts one comparison; use around a comparison expression
+#define SORT_STAT_CMP(expr) (sortStatsCurrent()->comparisons++, (expr))
+// Counts one comparison as a statement
+#define SORT_STAT_COMPARE() (sortStatsCurrent()->comparisons++)
+#define SORT_STAT_MOVE(count) (sortStatsCurrent()->moves += (uint64_t)(count))
+#define SORT_STAT_SWAP() (sortStatsCurrent()->swaps++)
+#define SORT_STAT_ALLOC(bytes) \
+    (sortStatsCurrent()->allocations++, sortStatsCurrent()->bytesAllocated += (uint64_t)(bytes))
+
+// Recursion depth: pair every SORT_STAT_ENTER with a SORT_STAT_LEAVE
+#define SORT_STAT_ENTER()                          \
+    do {                                           \
+        SortStats* stats_ = sortStatsCurrent();    \
+        if (++stats_->depth > stats_->maxDepth) {  \
+            stats_->maxDepth = stats_->depth;      \
+        }                                          \
+    } while (0)
+#define SORT_STAT_LEAVE() (sortStatsCurrent()->depth--)
+
+// Phase timing: SORT_STAT_PHASE_BEGIN(t) declares the local timer t
+#define SORT_STAT_PHASE_BEGIN(timer) double timer = sortStatsNow()
+#define SORT_STAT_PHASE_END(timer, phase) (sortStatsCurrent()->phaseSeconds[phase] += sortStatsNow() - (timer))
+
+#else /* !SORT_STATS */
+
+/**
+ * Statistics are compiled out: reset does nothing and the snapshot is empty.
+ */
+static inline void sortStatsReset(void) {
+}
+
+static inline SortStats sortStatsGet(void) {
+    SortStats empty;
+    memset(&empty, 0, sizeof(empty));
+    return empty;
+}
+
+#define SORT_STAT_CMP(expr) (expr)
+#define SORT_STAT_COMPARE() ((void)0)
+#define SORT_STAT_MOVE(count) ((void)0)
+#define SORT_STAT_SWAP() ((void)0)
+#define SORT_STAT_ALLOC(bytes) ((void)0)
+#define SORT_STAT_ENTER() ((void)0)
+#define SORT_STAT_LEAVE() ((void)0)
+#define SORT_STAT_PHASE_BEGIN(timer) ((void)0)
+#define SORT_STAT_PHASE_END(timer, phase) ((void)0)
+
+#endif /* SORT_STATS */
+
+#endif /* SORT_STATS_H */
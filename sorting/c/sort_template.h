@@ -0,0 +1,489 @@
+/**
+ * Sort Template - Compile-Time Specialized Sorts
+ *
+ * A sort written out by hand with a runtime `reverse` flag tests it on
+ * every comparison. This header instead generates a family of sorts for
+ * one element type, one ordering and one direction, with the comparison as
+ * a macro the compiler can inline. It is included once per instantiation,
+ * with the parameters defined beforehand; they are undefined again at the
+ * end of the header.
+ *
+ * Parameters:
+ *   SORT_TEMPLATE_NAME        Prefix of the generated functions (required)
+ *   SORT_TEMPLATE_TYPE        Element type, any type that can be assigned (required)
+ *   SORT_TEMPLATE_KEY(x)      Key of an element; defaults to the element itself
+ *   SORT_TEMPLATE_LESS(a, b)  Strict ordering of two elements; defaults to
+ *                             SORT_TEMPLATE_KEY(a) < SORT_TEMPLATE_KEY(b)
+ *   SORT_TEMPLATE_COMPARE(a, b)  Optional three-way comparison (negative,
+ *                             zero, positive); when given, partitioning
+ *                             calls it once per element instead of
+ *                             SORT_TEMPLATE_LESS twice
+ *   SORT_TEMPLATE_DESCENDING  Defined to sort in descending order
+ *
+ * Generated functions, for SORT_TEMPLATE_NAME foo:
+ *   void fooSort(T arr[], size_t n)             Three-way introsort, O(n log n)
+ *   void fooIntroSort(T arr[], size_t n, int depthLimit)
+ *   void fooInsertionSort(T arr[], size_t n)
+ *   void fooHeapSort(T arr[], size_t n)
+ *   void fooStableSort(T arr[], size_t n, T scratch[])  Merge sort, n scratch elements
+ *   void fooInPlaceStableSort(T arr[], size_t n, T buffer[], size_t bufferSize)
+ *                                               Merge sort in place, optional buffer
+ *   void fooSymMerge(T arr[], size_t mid, size_t n, T buffer[], size_t bufferSize)
+ *                                               In-place stable merge of two runs
+ *
+ * Usage:
+ *   typedef struct { int64_t id; double score; } Row;
+ *   #define SORT_TEMPLATE_NAME rowsById
+ *   #define SORT_TEMPLATE_TYPE Row
+ *   #define SORT_TEMPLATE_KEY(r) ((r).id)
+ *   #include "sort_template.h"
+ *   ...
+ *   rowsByIdSort(rows, n);
+ *
+ * The functions are static inline, so instantiations that are never called
+ * produce no code and no unused-function warnings.
+ */
+
+#ifndef SORT_TEMPLATE_H
+#define SORT_TEMPLATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "sort_stats.h"
+
+// Ranges up to this size are finished with insertion sort
+#define SORT_TEMPLATE_INSERTION_THRESHOLD 16
+// Length of the insertion-sorted runs the stable merge sort starts from
+#define SORT_TEMPLATE_RUN 32
+
+#define SORT_TEMPLATE_CONCAT_(a, b) a##b
+#define SORT_TEMPLATE_CONCAT(a, b) SORT_TEMPLATE_CONCAT_(a, b)
+
+/**
+ * Returns the partitioning depth limit for n elements: 2 * floor(log2(n)).
+ */
+static inline int sortTemplateDepthLimit(size_t n) {
+    int limit = 0;
+    while (n > 1) {
+        n >>= 1;
+        limit += 2;
+    }
+    return limit;
+}
+
+#endif /* SORT_TEMPLATE_H */
+
+#if !defined(SORT_TEMPLATE_NAME) || !defined(SORT_TEMPLATE_TYPE)
+#error "define SORT_TEMPLATE_NAME and SORT_TEMPLATE_TYPE before including sort_template.h"
+#endif
+
+#ifndef SORT_TEMPLATE_KEY
+#define SORT_TEMPLATE_KEY(x) (x)
+#endif
+#ifndef SORT_TEMPLATE_LESS
+#ifdef SORT_TEMPLATE_COMPARE
+#define SORT_TEMPLATE_LESS(a, b) (SORT_TEMPLATE_COMPARE(a, b) < 0)
+#else
+#define SORT_TEMPLATE_LESS(a, b) (SORT_TEMPLATE_KEY(a) < SORT_TEMPLATE_KEY(b))
+#endif
+#endif
+
+// BEFORE(a, b): a belongs strictly before b in the output.
+// ORDER(a, b), only with SORT_TEMPLATE_COMPARE: negative, zero or positive as
+// a belongs before, with or after b.
+#ifdef SORT_TEMPLATE_DESCENDING
+#define SORT_TEMPLATE_BEFORE(a, b) SORT_TEMPLATE_LESS(b, a)
+#ifdef SORT_TEMPLATE_COMPARE
+#define SORT_TEMPLATE_ORDER(a, b) SORT_TEMPLATE_COMPARE(b, a)
+#endif
+#else
+#define SORT_TEMPLATE_BEFORE(a, b) SORT_TEMPLATE_LESS(a, b)
+#ifdef SORT_TEMPLATE_COMPARE
+#define SORT_TEMPLATE_ORDER(a, b) SORT_TEMPLATE_COMPARE(a, b)
+#endif
+#endif
+
+#define SORT_TEMPLATE_FN(suffix) SORT_TEMPLATE_CONCAT(SORT_TEMPLATE_NAME, suffix)
+
+/**
+ * Insertion sort of arr[0..n).
+ */
+static inline void SORT_TEMPLATE_FN(InsertionSort)(SORT_TEMPLATE_TYPE arr[], size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        SORT_TEMPLATE_TYPE key = arr[i];
+        size_t j = i;
+        while (j > 0 && SORT_STAT_CMP(SORT_TEMPLATE_BEFORE(key, arr[j - 1]))) {
+            arr[j] = arr[j - 1];
+            j--;
+        }
+        arr[j] = key;
+        SORT_STAT_MOVE(i - j);
+    }
+}
+
+/**
+ * Moves arr[i] down the heap arr[0..n) until its children belong before it.
+ */
+static inline void SORT_TEMPLATE_FN(SiftDown)(SORT_TEMPLATE_TYPE arr[], size_t n, size_t i) {
+    SORT_TEMPLATE_TYPE value = arr[i];
+    size_t child;
+    while ((child = 2 * i + 1) < n) {
+        if (child + 1 < n && SORT_STAT_CMP(SORT_TEMPLATE_BEFORE(arr[child], arr[child + 1]))) {
+            child++;
+        }
+        if (!SORT_STAT_CMP(SORT_TEMPLATE_BEFORE(value, arr[child]))) {
+            break;
+        }
+        arr[i] = arr[child];
+        SORT_STAT_MOVE(1);
+        i = child;
+    }
+    arr[i] = value;
+}
+
+/**
+ * Heap sort of arr[0..n).
+ */
+static inline void SORT_TEMPLATE_FN(HeapSort)(SORT_TEMPLATE_TYPE arr[], size_t n) {
+    for (size_t i = n / 2; i > 0; i--) {
+        SORT_TEMPLATE_FN(SiftDown)(arr, n, i - 1);
+    }
+    for (size_t i = n; i > 1; i--) {
+        SORT_TEMPLATE_TYPE temp = arr[0];
+        arr[0] = arr[i - 1];
+        arr[i - 1] = temp;
+        SORT_STAT_SWAP();
+        SORT_TEMPLATE_FN(SiftDown)(arr, i - 1, 0);
+    }
+}
+
+/**
+ * Three-way partitioning quicksort of arr[0..n), the same scheme as
+ * quicksort3WayInt: median-of-three pivot, recursion into the smaller side,
+ * heap sort once depthLimit levels have been used up.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param depthLimit Remaining partitioning levels before falling back to heap sort
+ */
+static inline void SORT_TEMPLATE_FN(IntroSort)(SORT_TEMPLATE_TYPE arr[], size_t n, int depthLimit) {
+    while (n > SORT_TEMPLATE_INSERTION_THRESHOLD) {
+        if (depthLimit-- == 0) {
+            SORT_TEMPLATE_FN(HeapSort)(arr, n);
+            return;
+        }
+
+        // Median of three as the pivot value; one declaration per variable,
+        // since the type may be a pointer declarator such as char*
+        SORT_TEMPLATE_TYPE a = arr[0];
+        SORT_TEMPLATE_TYPE b = arr[n / 2];
+        SORT_TEMPLATE_TYPE c = arr[n - 1];
+        SORT_TEMPLATE_TYPE pivot;
+        if (SORT_TEMPLATE_BEFORE(a, b) == SORT_TEMPLATE_BEFORE(b, c)) {
+            pivot = b;
+        } else if (SORT_TEMPLATE_BEFORE(b, a) == SORT_TEMPLATE_BEFORE(a, c)) {
+            pivot = a;
+        } else {
+            pivot = c;
+        }
+
+        // arr[0..lt) before the pivot, arr[gt..n) after it
+        size_t lt = 0, i = 0, gt = n;
+        SORT_STAT_PHASE_BEGIN(phaseStart);
+        while (i < gt) {
+            SORT_TEMPLATE_TYPE value = arr[i];
+            SORT_STAT_COMPARE();
+#ifdef SORT_TEMPLATE_ORDER
+            int order = SORT_TEMPLATE_ORDER(value, pivot);
+            if (order < 0) {
+#else
+            if (SORT_TEMPLATE_BEFORE(value, pivot)) {
+#endif
+                arr[i++] = arr[lt];
+                arr[lt++] = value;
+                SORT_STAT_SWAP();
+#ifdef SORT_TEMPLATE_ORDER
+            } else if (order > 0) {
+#else
+            } else if (SORT_TEMPLATE_BEFORE(pivot, value)) {
+#endif
+                arr[i] = arr[--gt];
+                arr[gt] = value;
+                SORT_STAT_SWAP();
+            } else {
+                i++;
+            }
+        }
+        SORT_STAT_PHASE_END(phaseStart, SORT_PHASE_PARTITION);
+
+        // Recurse into the smaller side, continue with the larger one
+        if (lt < n - gt) {
+            SORT_TEMPLATE_FN(IntroSort)(arr, lt, depthLimit);
+            arr += gt;
+            n -= gt;
+        } else {
+            SORT_TEMPLATE_FN(IntroSort)(arr + gt, n - gt, depthLimit);
+            n = lt;
+        }
+    }
+    SORT_TEMPLATE_FN(InsertionSort)(arr, n);
+}
+
+/**
+ * Sorts arr[0..n) in O(n log n) time and O(log n) stack; not stable.
+ */
+static inline void SORT_TEMPLATE_FN(Sort)(SORT_TEMPLATE_TYPE arr[], size_t n) {
+    SORT_TEMPLATE_FN(IntroSort)(arr, n, sortTemplateDepthLimit(n));
+}
+
+/**
+ * Merges the sorted runs src[low..mid) and src[mid..high) into dst[low..high),
+ * taking from the left run on ties.
+ */
+static inline void SORT_TEMPLATE_FN(MergeRuns)(SORT_TEMPLATE_TYPE src[], SORT_TEMPLATE_TYPE dst[], size_t low,
+                                              size_t mid, size_t high) {
+    size_t i = low, j = mid, k = low;
+    while (i < mid && j < high) {
+        if (SORT_STAT_CMP(SORT_TEMPLATE_BEFORE(src[j], src[i]))) {
+            dst[k++] = src[j++];
+        } else {
+            dst[k++] = src[i++];
+        }
+    }
+    while (i < mid) {
+        dst[k++] = src[i++];
+    }
+    while (j < high) {
+        dst[k++] = src[j++];
+    }
+    SORT_STAT_MOVE(high - low);
+}
+
+/**
+ * Stable sort of arr[0..n): bottom-up merge sort over insertion-sorted
+ * runs, alternating between arr and scratch.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param scratch Buffer of at least n elements
+ */
+static inline void SORT_TEMPLATE_FN(StableSort)(SORT_TEMPLATE_TYPE arr[], size_t n,
+                                               SORT_TEMPLATE_TYPE scratch[]) {
+    for (size_t low = 0; low < n; low += SORT_TEMPLATE_RUN) {
+        SORT_TEMPLATE_FN(InsertionSort)(arr + low, n - low < SORT_TEMPLATE_RUN ? n - low : SORT_TEMPLATE_RUN);
+    }
+
+    SORT_TEMPLATE_TYPE* src = arr;
+    SORT_TEMPLATE_TYPE* dst = scratch;
+    for (size_t width = SORT_TEMPLATE_RUN; width < n; width *= 2) {
+        SORT_STAT_PHASE_BEGIN(phaseStart);
+        for (size_t low = 0; low < n; low += 2 * width) {
+            size_t mid = n - low > width ? low + width : n;
+            size_t high = n - mid > width ? mid + width : n;
+            SORT_TEMPLATE_FN(MergeRuns)(src, dst, low, mid, high);
+        }
+        SORT_STAT_PHASE_END(phaseStart, SORT_PHASE_MERGE);
+        SORT_TEMPLATE_TYPE* temp = src;
+        src = dst;
+        dst = temp;
+    }
+    if (src != arr) {
+        memcpy(arr, src, n * sizeof(SORT_TEMPLATE_TYPE));
+        SORT_STAT_MOVE(n);
+    }
+}
+
+/**
+ * Rotates arr[0..n) so that arr[left..n) comes first, through buffer if
+ * the shorter side fits in bufferSize elements and by three reversals
+ * otherwise.
+ */
+static inline void SORT_TEMPLATE_FN(Rotate)(SORT_TEMPLATE_TYPE arr[], size_t left, size_t n,
+                                           SORT_TEMPLATE_TYPE buffer[], size_t bufferSize) {
+    size_t right = n - left;
+    if (left == 0 || right == 0) {
+        return;
+    }
+    if (left <= right && left <= bufferSize) {
+        memcpy(buffer, arr, left * sizeof(SORT_TEMPLATE_TYPE));
+        memmove(arr, arr + left, right * sizeof(SORT_TEMPLATE_TYPE));
+        memcpy(arr + right, buffer, left * sizeof(SORT_TEMPLATE_TYPE));
+    } else if (right <= bufferSize) {
+        memcpy(buffer, arr + left, right * sizeof(SORT_TEMPLATE_TYPE));
+        memmove(arr + right, arr, left * sizeof(SORT_TEMPLATE_TYPE));
+        memcpy(arr, buffer, right * sizeof(SORT_TEMPLATE_TYPE));
+    } else {
+        size_t ranges[3][2] = {{0, left}, {left, n}, {0, n}};
+        for (int r = 0; r < 3; r++) {
+            for (size_t i = ranges[r][0], j = ranges[r][1]; i + 1 < j; i++, j--) {
+                SORT_TEMPLATE_TYPE temp = arr[i];
+                arr[i] = arr[j - 1];
+                arr[j - 1] = temp;
+            }
+        }
+    }
+    SORT_STAT_MOVE(n);
+}
+
+/**
+ * Merges the sorted runs arr[0..mid) and arr[mid..n) through buffer, which
+ * holds at least the shorter run: the left run is merged forward, the
+ * right run backward.
+ */
+static inline void SORT_TEMPLATE_FN(BufferedMerge)(SORT_TEMPLATE_TYPE arr[], size_t mid, size_t n,
+                                                  SORT_TEMPLATE_TYPE buffer[]) {
+    if (mid <= n - mid) {
+        memcpy(buffer, arr, mid * sizeof(SORT_TEMPLATE_TYPE));
+        size_t i = 0, j = mid, k = 0;
+        while (i < mid && j < n) {
+            if (SORT_STAT_CMP(SORT_TEMPLATE_BEFORE(arr[j], buffer[i]))) {
+                arr[k++] = arr[j++];
+            } else {
+                arr[k++] = buffer[i++];
+            }
+        }
+        while (i < mid) {
+            arr[k++] = buffer[i++];
+        }
+        SORT_STAT_MOVE(mid + k);
+    } else {
+        size_t right = n - mid;
+        memcpy(buffer, arr + mid, right * sizeof(SORT_TEMPLATE_TYPE));
+        size_t i = mid, j = right, k = n;
+        while (i > 0 && j > 0) {
+            if (SORT_STAT_CMP(SORT_TEMPLATE_BEFORE(buffer[j - 1], arr[i - 1]))) {
+                arr[--k] = arr[--i];
+            } else {
+                arr[--k] = buffer[--j];
+            }
+        }
+        while (j > 0) {
+            arr[--k] = buffer[--j];
+        }
+        SORT_STAT_MOVE(right + (n - k));
+    }
+}
+
+/**
+ * Stable merge of the sorted runs arr[0..mid) and arr[mid..n) in place
+ * (SymMerge, Kim and Kutzner 2004): a binary search finds how far the runs
+ * overlap around the middle of arr, one rotation swaps the overlapping
+ * parts, and both halves are merged recursively. Merges whose shorter run
+ * fits in bufferSize elements go through buffer instead.
+ */
+static inline void SORT_TEMPLATE_FN(SymMerge)(SORT_TEMPLATE_TYPE arr[], size_t mid, size_t n,
+                                              SORT_TEMPLATE_TYPE buffer[], size_t bufferSize) {
+    if (mid == 0 || mid == n) {
+        return;
+    }
+    if (mid <= bufferSize || n - mid <= bufferSize) {
+        SORT_TEMPLATE_FN(BufferedMerge)(arr, mid, n, buffer);
+        return;
+    }
+
+    // A single element is inserted with a binary search and one shift
+    if (mid == 1) {
+        size_t low = 1, high = n;
+        while (low < high) {
+            size_t probe = low + (high - low) / 2;
+            if (SORT_STAT_CMP(SORT_TEMPLATE_BEFORE(arr[probe], arr[0]))) {
+                low = probe + 1;
+            } else {
+                high = probe;
+            }
+        }
+        SORT_TEMPLATE_TYPE value = arr[0];
+        memmove(arr, arr + 1, (low - 1) * sizeof(SORT_TEMPLATE_TYPE));
+        arr[low - 1] = value;
+        SORT_STAT_MOVE(low);
+        return;
+    }
+    if (n - mid == 1) {
+        size_t low = 0, high = mid;
+        while (low < high) {
+            size_t probe = low + (high - low) / 2;
+            if (SORT_STAT_CMP(SORT_TEMPLATE_BEFORE(arr[mid], arr[probe]))) {
+                high = probe;
+            } else {
+                low = probe + 1;
+            }
+        }
+        SORT_TEMPLATE_TYPE value = arr[mid];
+        memmove(arr + low + 1, arr + low, (mid - low) * sizeof(SORT_TEMPLATE_TYPE));
+        arr[low] = value;
+        SORT_STAT_MOVE(mid - low + 1);
+        return;
+    }
+
+    // Find start so that arr[start..mid) and arr[mid..end) are the parts to swap
+    size_t half = n / 2;
+    size_t sum = half + mid;
+    size_t start = mid > half ? sum - n : 0;
+    size_t limit = mid > half ? half : mid;
+    while (start < limit) {
+        size_t c = start + (limit - start) / 2;
+        if (!SORT_STAT_CMP(SORT_TEMPLATE_BEFORE(arr[sum - 1 - c], arr[c]))) {
+            start = c + 1;
+        } else {
+            limit = c;
+        }
+    }
+    size_t end = sum - start;
+
+    if (start < mid && mid < end) {
+        SORT_TEMPLATE_FN(Rotate)(arr + start, mid - start, end - start, buffer, bufferSize);
+    }
+    if (start > 0 && start < half) {
+        SORT_TEMPLATE_FN(SymMerge)(arr, start, half, buffer, bufferSize);
+    }
+    if (half < end && end < n) {
+        SORT_TEMPLATE_FN(SymMerge)(arr + half, end - half, n - half, buffer, bufferSize);
+    }
+}
+
+/**
+ * Stable sort of arr[0..n) in place: bottom-up merge sort over
+ * insertion-sorted runs, merging with SymMerge. Without a buffer it takes
+ * O(n log^2 n) time and O(log n) stack; a buffer of b elements turns every
+ * merge whose shorter run fits, and every such part of a larger merge, into
+ * a plain buffered merge, down to O(n log n) for b >= n / 2.
+ *
+ * @param arr Array to be sorted
+ * @param n Size of the array
+ * @param buffer Optional scratch of bufferSize elements, or NULL
+ * @param bufferSize Number of elements in buffer, 0 without one
+ */
+static inline void SORT_TEMPLATE_FN(InPlaceStableSort)(SORT_TEMPLATE_TYPE arr[], size_t n,
+                                                      SORT_TEMPLATE_TYPE buffer[], size_t bufferSize) {
+    if (buffer == NULL) {
+        bufferSize = 0;
+    }
+    for (size_t low = 0; low < n; low += SORT_TEMPLATE_RUN) {
+        SORT_TEMPLATE_FN(InsertionSort)(arr + low, n - low < SORT_TEMPLATE_RUN ? n - low : SORT_TEMPLATE_RUN);
+    }
+
+    for (size_t width = SORT_TEMPLATE_RUN; width < n; width *= 2) {
+        SORT_STAT_PHASE_BEGIN(phaseStart);
+        for (size_t low = 0; low + width < n; low += 2 * width) {
+            size_t mid = low + width;
+            size_t high = n - mid > width ? mid + width : n;
+            // Runs that are already in order need no merge
+            if (SORT_STAT_CMP(SORT_TEMPLATE_BEFORE(arr[mid], arr[mid - 1]))) {
+                SORT_TEMPLATE_FN(SymMerge)(arr + low, width, high - low, buffer, bufferSize);
+            }
+        }
+        SORT_STAT_PHASE_END(phaseStart, SORT_PHASE_MERGE);
+    }
+}
+
+#undef SORT_TEMPLATE_FN
+#undef SORT_TEMPLATE_ORDER
+#undef SORT_TEMPLATE_BEFORE
+#undef SORT_TEMPLATE_LESS
+#undef SORT_TEMPLATE_COMPARE
+#undef SORT_TEMPLATE_KEY
+#undef SORT_TEMPLATE_DESCENDING
+#undef SORT_TEMPLATE_TYPE
+#undef SORT_TEMPLATE_NAME
@@ -0,0 +1,116 @@
+/**
+ * Sort Workspace - Reusable Scratch Memory for Sorting
+ *
+ * Algorithms that need scratch space (merge sort, radix sort) take a
+ * SortWorkspace instead of calling malloc on every call. The workspace is a
+ * bump allocator over one buffer that only grows: a sort resets it, reserves
+ * the total it needs up front, then carves its buffers out of it. Once the
+ * buffer has reached the largest size ever requested, repeated sorts perform
+ * no heap allocation at all.
+ *
+ * Usage:
+ *   SortWorkspace ws = SORT_WORKSPACE_INIT;
+ *   for (...) mergeSortIntWorkspace(arr, n, false, &ws);
+ *   sortWorkspaceFree(&ws);
+ *
+ * Passing NULL selects a per-thread workspace. Its buffer is not released
+ * when the thread exits: threads that end before the process does should
+ * pass their own workspace, or call sortWorkspaceFree(sortWorkspaceThreadLocal())
+ * before they return.
+ */
+
+#ifndef SORT_WORKSPACE_H
+#define SORT_WORKSPACE_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "sort_stats.h"
+
+/**
+ * Growable scratch buffer with bump allocation.
+ */
+typedef struct {
+    unsigned char* base;  // Start of the buffer
+    size_t capacity;      // Size of the buffer in bytes
+    size_t used;          // Bytes handed out since the last reset
+    size_t grows;         // Number of times the buffer had to be reallocated
+} SortWorkspace;
+
+#define SORT_WORKSPACE_INIT {NULL, 0, 0, 0}
+
+// Every allocation is aligned to this many bytes (one cache line)
+#define SORT_WORKSPACE_ALIGN 64
+
+/**
+ * Returns the workspace of the calling thread. Nothing frees it at thread
+ * exit; see the note above.
+ */
+static inline SortWorkspace* sortWorkspaceThreadLocal(void) {
+    static _Thread_local SortWorkspace threadWorkspace = SORT_WORKSPACE_INIT;
+    return &threadWorkspace;
+}
+
+/**
+ * Releases every allocation and makes sure at least bytes are available.
+ * Must be called before the first sortWorkspaceAlloc of a sort, since
+ * growing the buffer invalidates pointers handed out earlier.
+ *
+ * @param ws Workspace, or NULL for the per-thread workspace
+ * @param bytes Total number of bytes the sort will allocate
+ * @return The workspace, or NULL if the buffer could not be grown
+ */
+static inline SortWorkspace* sortWorkspaceReserve(SortWorkspace* ws, size_t bytes) {
+    if (ws == NULL) {
+        ws = sortWorkspaceThreadLocal();
+    }
+    ws->used = 0;
+
+    if (bytes > ws->capacity) {
+        // Grow geometrically so slowly increasing sizes do not reallocate every time
+        size_t capacity = ws->capacity * 2 > bytes ? ws->capacity * 2 : bytes;
+        free(ws->base);
+        ws->base = (unsigned char*)aligned_alloc(SORT_WORKSPACE_ALIGN,
+            (capacity + SORT_WORKSPACE_ALIGN - 1) / SORT_WORKSPACE_ALIGN * SORT_WORKSPACE_ALIGN);
+        if (ws->base == NULL) {
+            ws->capacity = 0;
+            return NULL;
+        }
+        ws->capacity = capacity;
+        ws->grows++;
+        SORT_STAT_ALLOC(capacity);
+    }
+    return ws;
+}
+
+/**
+ * Returns the number of bytes to reserve for an allocation of bytes,
+ * including alignment padding. Sum this over all allocations of a sort.
+ */
+static inline size_t sortWorkspaceSize(size_t bytes) {
+    return (bytes + SORT_WORKSPACE_ALIGN - 1) / SORT_WORKSPACE_ALIGN * SORT_WORKSPACE_ALIGN;
+}
+
+/**
+ * Hands out bytes from the reserved buffer.
+ *
+ * @return Aligned pointer into the workspace
+ */
+static inline void* sortWorkspaceAlloc(SortWorkspace* ws, size_t bytes) {
+    void* ptr = ws->base + ws->used;
+    ws->used += sortWorkspaceSize(bytes);
+    return ptr;
+}
+
+/**
+ * Frees the buffer of a workspace; it can be reused afterwards.
+ */
+static inline void sortWorkspaceFree(SortWorkspace* ws) {
+    free(ws->base);
+    ws->base = NULL;
+    ws->capacity = 0;
+    ws->used = 0;
+}
+
+#endif /* SORT_WORKSPACE_H */
@@ -0,0 +1,468 @@
+/**
+ * Sorted Update - Incremental Maintenance of Sorted Arrays
+ *
+ * Time Complexity (array of n elements, batch of m elements):
+ * - Insert: O(m log m) to sort the batch + O(m log(n/m)) comparisons to merge it
+ * - Delete: O(m log m) to sort the delete set + O(m log(n/m)) comparisons to find the keys
+ * - Both move O(n) elements at worst (memmove of the shifted ranges)
+ *
+ * Space Complexity: O(m) scratch to sort the batch, beyond the array's own reserved capacity
+ *
+ * How it works:
+ * Instead of appending a batch and re-sorting everything, only the batch is
+ * sorted, then it is merged into the existing array in place:
+ * 1. Make sure the array has capacity for n + m elements (growing geometrically)
+ * 2. Merge backwards from the end: the last batch element goes to the end of
+ *    the capacity, and the array elements that belong after it are found by
+ *    galloping (exponential then binary search) back from the current
+ *    position and moved up with one memmove
+ * 3. Elements before the first insertion point are never touched
+ * Deletions work the same way forward: the delete set is sorted, each key is
+ * found by galloping from the previous one, and the ranges between removed
+ * elements are moved down.
+ *
+ * Equal keys keep insertion order: string batches are sorted with a stable
+ * merge sort, batch elements land after equal elements already in the array,
+ * and a deletion removes the first equal element.
+ */
+
+#ifndef SORTED_UPDATE_C
+#define SORTED_UPDATE_C
+
+#ifndef SORTING_NO_MAIN
+#define SORTING_NO_MAIN
+#define SORTED_UPDATE_MAIN
+#endif
+
+#include "adaptive_sort.c"
+
+#include <errno.h>
+
+/**
+ * Sorted integer array with reserved capacity for incremental inserts.
+ */
+typedef struct {
+    int* data;
+    size_t count;
+    size_t capacity;
+} SortedIntArray;
+
+/**
+ * Sorted array of string pointers; the strings themselves are not owned.
+ */
+typedef struct {
+    char** data;
+    size_t count;
+    size_t capacity;
+} SortedStringArray;
+
+#define SORTED_ARRAY_INIT {NULL, 0, 0}
+
+/**
+ * Makes sure the array can hold at least capacity elements.
+ *
+ * @return 0 on success, -1 with errno set to ENOMEM on failure
+ */
+int sortedIntArrayReserve(SortedIntArray* arr, size_t capacity) {
+    if (capacity <= arr->capacity) {
+        return 0;
+    }
+    // Grow geometrically so a stream of small batches reallocates rarely
+    if (capacity < arr->capacity * 2) {
+        capacity = arr->capacity * 2;
+    }
+    if (capacity > SIZE_MAX / sizeof(int)) {
+        errno = ENOMEM;
+        return -1;
+    }
+    int* data = (int*)realloc(arr->data, capacity * sizeof(int));
+    if (data == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    SORT_STAT_ALLOC(capacity * sizeof(int));
+    arr->data = data;
+    arr->capacity = capacity;
+    return 0;
+}
+
+/**
+ * Frees the storage of an array; it can be reused afterwards.
+ */
+void sortedIntArrayFree(SortedIntArray* arr) {
+    free(arr->data);
+    arr->data = NULL;
+    arr->count = 0;
+    arr->capacity = 0;
+}
+
+/**
+ * Gallops backwards from hi for the first element of a[0..hi) that belongs
+ * after key (strictly, so equal elements stay in front of it).
+ *
+ * @return Index p such that a[p..hi) all belong after key and a[p - 1] does not
+ */
+static size_t sortedGallopBackInt(const int a[], size_t hi, int key, bool reverse) {
+    // Exponential search: a[hi - step] is the probe
+    size_t step = 1;
+    size_t upper = hi;  // a[upper..hi) known to belong after key
+    while (step <= hi && SORT_STAT_CMP(reverse ? a[hi - step] < key : a[hi - step] > key)) {
+        upper = hi - step;
+        step *= 2;
+    }
+    size_t lower = step <= hi ? hi - step + 1 : 0;  // a[lower - 1] known not to belong after key
+
+    // Binary search in a[lower..upper)
+    while (lower < upper) {
+        size_t mid = lower + (upper - lower) / 2;
+        if (SORT_STAT_CMP(reverse ? a[mid] < key : a[mid] > key)) {
+            upper = mid;
+        } else {
+            lower = mid + 1;
+        }
+    }
+    return lower;
+}
+
+/**
+ * Gallops forward from lo for the first element of a[lo..n) that does not
+ * come before key, so equal elements are found at their first position.
+ */
+static size_t sortedGallopForwardInt(const int a[], size_t lo, size_t n, int key, bool reverse) {
+    size_t step = 1;
+    size_t lower = lo;  // a[lo..lower) known to come before key
+    while (lo + step - 1 < n && SORT_STAT_CMP(reverse ? a[lo + step - 1] > key : a[lo + step - 1] < key)) {
+        lower = lo + step;
+        step *= 2;
+    }
+    size_t upper = lo + step - 1 < n ? lo + step - 1 : n;
+
+    while (lower < upper) {
+        size_t mid = lower + (upper - lower) / 2;
+        if (SORT_STAT_CMP(reverse ? a[mid] > key : a[mid] < key)) {
+            lower = mid + 1;
+        } else {
+            upper = mid;
+        }
+    }
+    return lower;
+}
+
+/**
+ * Sorts a batch and merges it into a sorted integer array.
+ *
+ * @param arr Array sorted in the direction given by reverse
+ * @param batch Elements to insert; sorted in place by this call
+ * @param m Number of elements in the batch
+ * @param reverse If true, the array is in descending order; if false, in ascending order
+ * @return 0 on success, -1 with errno set to ENOMEM if the array could not grow
+ */
+int sortedInsertInt(SortedIntArray* arr, int batch[], size_t m, bool reverse) {
+    if (m == 0) {
+        return 0;
+    }
+    if (sortedIntArrayReserve(arr, arr->count + m) != 0) {
+        return -1;
+    }
+    sortIntWide(batch, m, reverse);
+
+    int* a = arr->data;
+    size_t i = arr->count;  // a[0..i) not yet merged
+    size_t k = arr->count + m;  // Output fills a[k..) from the back
+
+    SORT_STAT_PHASE_BEGIN(mergeStart);
+    for (size_t j = m; j-- > 0;) {
+        // Array elements that belong after batch[j] move up as one block
+        size_t p = sortedGallopBackInt(a, i, batch[j], reverse);
+        size_t block = i - p;
+        k -= block;
+        memmove(a + k, a + p, block * sizeof(int));
+        a[--k] = batch[j];
+        SORT_STAT_MOVE(block + 1);
+        i = p;
+    }
+    SORT_STAT_PHASE_END(mergeStart, SORT_PHASE_MERGE);
+
+    arr->count += m;
+    return 0;
+}
+
+/**
+ * Removes one occurrence of every key of a delete set from a sorted integer array.
+ * Keys that are not present are ignored.
+ *
+ * @param arr Array sorted in the direction given by reverse
+ * @param keys Keys to remove; sorted in place by this call
+ * @param m Number of keys
+ * @param reverse If true, the array is in descending order; if false, in ascending order
+ * @return Number of elements removed
+ */
+size_t sortedDeleteInt(SortedIntArray* arr, int keys[], size_t m, bool reverse) {
+    if (m == 0 || arr->count == 0) {
+        return 0;
+    }
+    sortIntWide(keys, m, reverse);
+
+    int* a = arr->data;
+    size_t n = arr->count;
+    size_t read = 0;   // a[read..n) not yet examined
+    size_t write = 0;  // a[0..write) is the result so far
+
+    for (size_t j = 0; j < m && read < n; j++) {
+        size_t found = sortedGallopForwardInt(a, read, n, keys[j], reverse);
+        if (found == n || a[found] != keys[j]) {
+            continue;
+        }
+
+        // Keep a[read..found), drop a[found]
+        if (write != read) {
+            memmove(a + write, a + read, (found - read) * sizeof(int));
+            SORT_STAT_MOVE(found - read);
+        }
+        write += found - read;
+        read = found + 1;
+    }
+
+    if (write != read) {
+        memmove(a + write, a + read, (n - read) * sizeof(int));
+        SORT_STAT_MOVE(n - read);
+    }
+    arr->count = write + (n - read);
+    return n - arr->count;
+}
+
+/**
+ * String version of sortedIntArrayReserve.
+ */
+int sortedStringArrayReserve(SortedStringArray* arr, size_t capacity) {
+    if (capacity <= arr->capacity) {
+        return 0;
+    }
+    if (capacity < arr->capacity * 2) {
+        capacity = arr->capacity * 2;
+    }
+    if (capacity > SIZE_MAX / sizeof(char*)) {
+        errno = ENOMEM;
+        return -1;
+    }
+    char** data = (char**)realloc(arr->data, capacity * sizeof(char*));
+    if (data == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    SORT_STAT_ALLOC(capacity * sizeof(char*));
+    arr->data = data;
+    arr->capacity = capacity;
+    return 0;
+}
+
+/**
+ * Frees the pointer array (not the strings); it can be reused afterwards.
+ */
+void sortedStringArrayFree(SortedStringArray* arr) {
+    free(arr->data);
+    arr->data = NULL;
+    arr->count = 0;
+    arr->capacity = 0;
+}
+
+/**
+ * String version of sortedGallopBackInt.
+ */
+static size_t sortedGallopBackString(char* const a[], size_t hi, const char* key, bool reverse) {
+    size_t step = 1;
+    size_t upper = hi;
+    while (step <= hi) {
+        int cmp = strcmp(a[hi - step], key);
+        SORT_STAT_COMPARE();
+        if (reverse ? cmp >= 0 : cmp <= 0) {
+            break;
+        }
+        upper = hi - step;
+        step *= 2;
+    }
+    size_t lower = step <= hi ? hi - step + 1 : 0;
+
+    while (lower < upper) {
+        size_t mid = lower + (upper - lower) / 2;
+        int cmp = strcmp(a[mid], key);
+        SORT_STAT_COMPARE();
+        if (reverse ? cmp < 0 : cmp > 0) {
+            upper = mid;
+        } else {
+            lower = mid + 1;
+        }
+    }
+    return lower;
+}
+
+/**
+ * String version of sortedGallopForwardInt.
+ */
+static size_t sortedGallopForwardString(char* const a[], size_t lo, size_t n, const char* key, bool reverse) {
+    size_t step = 1;
+    size_t lower = lo;
+    while (lo + step - 1 < n) {
+        int cmp = strcmp(a[lo + step - 1], key);
+        SORT_STAT_COMPARE();
+        if (reverse ? cmp <= 0 : cmp >= 0) {
+            break;
+        }
+        lower = lo + step;
+        step *= 2;
+    }
+    size_t upper = lo + step - 1 < n ? lo + step - 1 : n;
+
+    while (lower < upper) {
+        size_t mid = lower + (upper - lower) / 2;
+        int cmp = strcmp(a[mid], key);
+        SORT_STAT_COMPARE();
+        if (reverse ? cmp > 0 : cmp < 0) {
+            lower = mid + 1;
+        } else {
+            upper = mid;
+        }
+    }
+    return lower;
+}
+
+/**
+ * Sorts a batch of strings and merges it into a sorted string array.
+ *
+ * @param arr Array sorted in the direction given by reverse
+ * @param batch Strings to insert; sorted in place by this call
+ * @param m Number of strings in the batch
+ * @param reverse If true, the array is in descending order; if false, in ascending order
+ * @return 0 on success, -1 with errno set to ENOMEM if the array could not grow
+ */
+int sortedInsertString(SortedStringArray* arr, char* batch[], size_t m, bool reverse) {
+    if (m == 0) {
+        return 0;
+    }
+    if (sortedStringArrayReserve(arr, arr->count + m) != 0) {
+        return -1;
+    }
+    // Stable, so equal strings of the batch keep their order
+    mergeSortStringWide(batch, m, reverse);
+
+    char** a = arr->data;
+    size_t i = arr->count;
+    size_t k = arr->count + m;
+
+    SORT_STAT_PHASE_BEGIN(mergeStart);
+    for (size_t j = m; j-- > 0;) {
+        size_t p = sortedGallopBackString(a, i, batch[j], reverse);
+        size_t block = i - p;
+        k -= block;
+        memmove(a + k, a + p, block * sizeof(char*));
+        a[--k] = batch[j];
+        SORT_STAT_MOVE(block + 1);
+        i = p;
+    }
+    SORT_STAT_PHASE_END(mergeStart, SORT_PHASE_MERGE);
+
+    arr->count += m;
+    return 0;
+}
+
+/**
+ * Removes one occurrence of every key of a delete set from a sorted string array.
+ * Strings are matched by content, not by pointer.
+ *
+ * @param arr Array sorted in the direction given by reverse
+ * @param keys Keys to remove; sorted in place by this call
+ * @param m Number of keys
+ * @param reverse If true, the array is in descending order; if false, in ascending order
+ * @return Number of elements removed
+ */
+size_t sortedDeleteString(SortedStringArray* arr, char* keys[], size_t m, bool reverse) {
+    if (m == 0 || arr->count == 0) {
+        return 0;
+    }
+    sortStringWide(keys, m, reverse);
+
+    char** a = arr->data;
+    size_t n = arr->count;
+    size_t read = 0;
+    size_t write = 0;
+
+    for (size_t j = 0; j < m && read < n; j++) {
+        size_t found = sortedGallopForwardString(a, read, n, keys[j], reverse);
+        if (found == n || strcmp(a[found], keys[j]) != 0) {
+            continue;
+        }
+        if (write != read) {
+            memmove(a + write, a + read, (found - read) * sizeof(char*));
+            SORT_STAT_MOVE(found - read);
+        }
+        write += found - read;
+        read = found + 1;
+    }
+
+    if (write != read) {
+        memmove(a + write, a + read, (n - read) * sizeof(char*));
+        SORT_STAT_MOVE(n - read);
+    }
+    arr->count = write + (n - read);
+    return n - arr->count;
+}
+
+#ifdef SORTED_UPDATE_MAIN
+
+/**
+ * Function to print a sorted integer array.
+ */
+void printSortedIntArray(const SortedIntArray* arr) {
+    printf("[");
+    for (size_t i = 0; i < arr->count; i++) {
+        printf("%d", arr->data[i]);
+        if (i + 1 < arr->count) {
+            printf(", ");
+        }
+    }
+    printf("]\n");
+}
+
+/**
+ * Main function with examples.
+ */
+int main() {
+    SortedIntArray arr = SORTED_ARRAY_INIT;
+
+    int first[] = {64, 34, 25, 12, 22, 11, 90};
+    sortedInsertInt(&arr, first, sizeof(first) / sizeof(first[0]), false);
+    printf("After first batch: ");
+    printSortedIntArray(&arr);
+
+    int second[] = {50, 5, 95, 25};
+    sortedInsertInt(&arr, second, sizeof(second) / sizeof(second[0]), false);
+    printf("After second batch: ");
+    printSortedIntArray(&arr);
+
+    int deletions[] = {90, 25, 7, 5};
+    size_t removed = sortedDeleteInt(&arr, deletions, sizeof(deletions) / sizeof(deletions[0]), false);
+    printf("After deleting {90, 25, 7, 5} (%zu removed): ", removed);
+    printSortedIntArray(&arr);
+
+    sortedIntArrayFree(&arr);
+
+    // Example with strings
+    SortedStringArray words = SORTED_ARRAY_INIT;
+    char* batch[] = {"cherry", "apple", "fig"};
+    char* more[] = {"banana", "date"};
+    sortedInsertString(&words, batch, 3, false);
+    sortedInsertString(&words, more, 2, false);
+
+    printf("\nString array: [");
+    for (size_t i = 0; i < words.count; i++) {
+        printf("\"%s\"%s", words.data[i], i + 1 < words.count ? ", " : "");
+    }
+    printf("]\n");
+
+    sortedStringArrayFree(&words);
+    return 0;
+}
+
+#endif /* SORTED_UPDATE_MAIN */
+
+#endif /* SORTED_UPDATE_C */
@@ -0,0 +1,422 @@
+/**
+ * String Table Sort - Sorting Strings Stored in One Buffer
+ *
+ * Time Complexity:
+ * - O(total bytes examined) for the MSD radix passes, plus O(b log b)
+ *   comparisons within buckets of b < STRING_TABLE_MSD_MIN strings
+ *
+ * Space Complexity: O(n) - 50 bytes per string of scratch from a SortWorkspace
+ *
+ * How it works:
+ * The strings arrive Arrow-style as one byte buffer and count + 1 offsets
+ * (32-bit, or 64-bit for the Wide variants): string i is
+ * data[offsets[i]..offsets[i + 1]). Strings carry explicit lengths and may
+ * contain NUL bytes. They are ordered byte-wise as unsigned bytes, and a
+ * string that is a proper prefix of another sorts first, so the order
+ * matches strcmp for strings without NULs. Nothing is allocated or copied
+ * per string:
+ * 1. Build one (pointer, length, row) reference per string
+ * 2. MSD radix sort the references with 257 buckets per byte position: one
+ *    for the strings that end there, which are equal and finished, and one
+ *    per byte value. Each level caches the current digit of every string in
+ *    one sequential array and scatters stably into a scratch array; a level
+ *    where all strings share the byte is skipped without moving anything
+ * 3. Buckets smaller than STRING_TABLE_MSD_MIN are finished by an introsort
+ *    (sort_template.h) over the next 8 bytes, loaded once as a big-endian
+ *    integer; only strings equal in those 8 bytes call memcmp
+ * 4. Return the row permutation, or copy the strings in sorted order into a
+ *    new compacted buffer with fresh offsets, so later scans read it
+ *    sequentially. Equal strings keep their original order.
+ */
+
+#ifndef STRING_TABLE_SORT_C
+#define STRING_TABLE_SORT_C
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+
+#ifndef SORTING_NO_MAIN
+#define SORTING_NO_MAIN
+#define STRING_TABLE_SORT_MAIN
+#endif
+
+#include "sort_stats.h"
+#include "sort_workspace.h"
+
+// Buckets below this many strings are sorted by comparison
+#define STRING_TABLE_MSD_MIN 32
+// Strings ahead of the copy position whose bytes are prefetched by the compaction
+#define STRING_TABLE_PREFETCH_DISTANCE 16
+
+/**
+ * A string being sorted.
+ */
+typedef struct {
+    const unsigned char* bytes;
+    size_t length;
+    uint64_t row;
+} StringTableRef;
+
+/**
+ * A string in a small bucket: the 8 bytes after the bucket's common prefix
+ * as a big-endian integer (zero-padded past the end), and the rest.
+ */
+typedef struct {
+    uint64_t prefix;
+    const unsigned char* rest;
+    size_t restLength;
+    size_t length;  // Bytes after the common prefix, including the 8 in prefix
+    size_t position;
+} StringTableCached;
+
+/**
+ * Three-way comparison of two cached strings by their bytes alone.
+ */
+static inline int stringTableCachedCompare(const StringTableCached* a, const StringTableCached* b) {
+    if (a->prefix != b->prefix) {
+        return a->prefix < b->prefix ? -1 : 1;
+    }
+    // Equal prefixes: a string shorter than 8 bytes matched the other's next bytes with its zero padding
+    size_t common = a->restLength < b->restLength ? a->restLength : b->restLength;
+    int cmp = common > 0 ? memcmp(a->rest, b->rest, common) : 0;
+    if (cmp != 0) {
+        return cmp;
+    }
+    return (a->length > b->length) - (a->length < b->length);
+}
+
+/**
+ * Orders two cached strings ascending; equal strings keep their positions,
+ * which are in row order.
+ */
+static inline bool stringTableCachedLessAsc(const StringTableCached* a, const StringTableCached* b) {
+    int cmp = stringTableCachedCompare(a, b);
+    return cmp < 0 || (cmp == 0 && a->position < b->position);
+}
+
+/**
+ * Orders two cached strings descending; equal strings keep their positions.
+ */
+static inline bool stringTableCachedLessDesc(const StringTableCached* a, const StringTableCached* b) {
+    int cmp = stringTableCachedCompare(a, b);
+    return cmp > 0 || (cmp == 0 && a->position < b->position);
+}
+
+#define SORT_TEMPLATE_NAME stringTableCachedAsc
+#define SORT_TEMPLATE_TYPE StringTableCached
+#define SORT_TEMPLATE_LESS(a, b) stringTableCachedLessAsc(&(a), &(b))
+#include "sort_template.h"
+
+#define SORT_TEMPLATE_NAME stringTableCachedDesc
+#define SORT_TEMPLATE_TYPE StringTableCached
+#define SORT_TEMPLATE_LESS(a, b) stringTableCachedLessDesc(&(a), &(b))
+#include "sort_template.h"
+
+/**
+ * Returns offsets[i] of a 32-bit or 64-bit offsets array.
+ */
+static inline size_t stringTableOffsetAt(const void* offsets, bool wide, size_t i) {
+    return wide ? (size_t)((const uint64_t*)offsets)[i] : ((const uint32_t*)offsets)[i];
+}
+
+/**
+ * Sorts a bucket of fewer than STRING_TABLE_MSD_MIN strings that share
+ * their first depth bytes.
+ */
+static void stringTableSmallSort(StringTableRef refs[], size_t n, size_t depth, bool reverse) {
+    StringTableCached cached[STRING_TABLE_MSD_MIN];
+    for (size_t i = 0; i < n; i++) {
+        const unsigned char* bytes = refs[i].bytes + depth;
+        size_t remaining = refs[i].length - depth;
+        size_t take = remaining < 8 ? remaining : 8;
+        uint64_t prefix = 0;
+        for (size_t b = 0; b < take; b++) {
+            prefix |= (uint64_t)bytes[b] << (56 - 8 * b);
+        }
+        cached[i].prefix = prefix;
+        cached[i].rest = bytes + take;
+        cached[i].restLength = remaining - take;
+        cached[i].length = remaining;
+        cached[i].position = i;
+    }
+    if (reverse) {
+        stringTableCachedDescSort(cached, n);
+    } else {
+        stringTableCachedAscSort(cached, n);
+    }
+
+    StringTableRef sorted[STRING_TABLE_MSD_MIN];
+    for (size_t i = 0; i < n; i++) {
+        sorted[i] = refs[cached[i].position];
+    }
+    memcpy(refs, sorted, n * sizeof(StringTableRef));
+    SORT_STAT_MOVE(n);
+}
+
+/**
+ * MSD radix sort of strings that share their first depth bytes.
+ *
+ * @param refs Strings to sort, in row order among equal strings
+ * @param scratch Scratch of n refs
+ * @param cache Scratch of n digits
+ * @param n Number of strings
+ * @param depth Length of the common prefix
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ */
+static void stringTableMsd(StringTableRef refs[], StringTableRef scratch[], uint16_t cache[], size_t n, size_t depth,
+                           bool reverse) {
+    // Digit of the strings that end at depth: first ascending, last descending
+    uint16_t end = reverse ? 256 : 0;
+
+    while (n >= STRING_TABLE_MSD_MIN) {
+        size_t count[257] = {0};
+        for (size_t i = 0; i < n; i++) {
+            if (refs[i].length == depth) {
+                cache[i] = end;
+            } else {
+                unsigned char byte = refs[i].bytes[depth];
+                cache[i] = reverse ? (uint16_t)(255 - byte) : (uint16_t)(byte + 1);
+            }
+            count[cache[i]]++;
+        }
+        if (count[cache[0]] == n) {
+            if (cache[0] == end) {
+                return;  // All strings are equal and already in row order
+            }
+            depth++;
+            continue;
+        }
+
+        SORT_STAT_PHASE_BEGIN(distributeStart);
+        size_t pos[257];
+        size_t sum = 0;
+        for (int d = 0; d < 257; d++) {
+            pos[d] = sum;
+            sum += count[d];
+        }
+        for (size_t i = 0; i < n; i++) {
+            scratch[pos[cache[i]]++] = refs[i];
+        }
+        memcpy(refs, scratch, n * sizeof(StringTableRef));
+        SORT_STAT_MOVE(2 * n);
+        SORT_STAT_PHASE_END(distributeStart, SORT_PHASE_DISTRIBUTE);
+
+        // Recurse into every bucket but the largest and continue with that one
+        // in this frame, so nested prefixes cannot run the stack out. The
+        // strings that end here are equal and stay in row order
+        int largest = end == 0 ? 1 : 0;
+        for (int d = 0; d < 257; d++) {
+            largest = d != end && count[d] > count[largest] ? d : largest;
+        }
+        size_t start = 0, largestStart = 0;
+        for (int d = 0; d < 257; d++) {
+            if (d == largest) {
+                largestStart = start;
+            } else if (count[d] > 1 && d != end) {
+                stringTableMsd(refs + start, scratch + start, cache + start, count[d], depth + 1, reverse);
+            }
+            start += count[d];
+        }
+        refs += largestStart;
+        scratch += largestStart;
+        cache += largestStart;
+        n = count[largest];
+        depth++;
+    }
+    if (n > 1) {
+        stringTableSmallSort(refs, n, depth, reverse);
+    }
+}
+
+/**
+ * Checks that the offsets are non-decreasing.
+ *
+ * @return 0 if they are, -1 with errno set to EINVAL otherwise
+ */
+static int stringTableCheckOffsets(const void* offsets, bool wide, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (stringTableOffsetAt(offsets, wide, i + 1) < stringTableOffsetAt(offsets, wide, i)) {
+            errno = EINVAL;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Shared implementation of the sort functions. Writes the permutation to
+ * perm if it is not NULL, and the compacted strings to outData and
+ * outOffsets if they are not NULL.
+ */
+static int stringTableSortImpl(const unsigned char* data, const void* offsets, bool wide, size_t count,
+                               bool reverse, void* perm, unsigned char* outData, void* outOffsets,
+                               SortWorkspace* ws) {
+    if (!wide && count > (size_t)UINT32_MAX + 1) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (stringTableCheckOffsets(offsets, wide, count) != 0) {
+        return -1;
+    }
+
+    size_t refBytes = count * sizeof(StringTableRef);
+    ws = sortWorkspaceReserve(ws, 2 * sortWorkspaceSize(refBytes) + sortWorkspaceSize(count * sizeof(uint16_t)));
+    if (ws == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    StringTableRef* refs = (StringTableRef*)sortWorkspaceAlloc(ws, refBytes);
+    StringTableRef* scratch = (StringTableRef*)sortWorkspaceAlloc(ws, refBytes);
+    uint16_t* cache = (uint16_t*)sortWorkspaceAlloc(ws, count * sizeof(uint16_t));
+
+    for (size_t i = 0; i < count; i++) {
+        size_t start = stringTableOffsetAt(offsets, wide, i);
+        refs[i].bytes = data + start;
+        refs[i].length = stringTableOffsetAt(offsets, wide, i + 1) - start;
+        refs[i].row = i;
+    }
+    stringTableMsd(refs, scratch, cache, count, 0, reverse);
+
+    if (perm != NULL) {
+        for (size_t i = 0; i < count; i++) {
+            if (wide) {
+                ((uint64_t*)perm)[i] = refs[i].row;
+            } else {
+                ((uint32_t*)perm)[i] = (uint32_t)refs[i].row;
+            }
+        }
+    }
+
+    if (outData != NULL) {
+        SORT_STAT_PHASE_BEGIN(copyStart);
+        size_t position = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (i + STRING_TABLE_PREFETCH_DISTANCE < count) {
+                __builtin_prefetch(refs[i + STRING_TABLE_PREFETCH_DISTANCE].bytes);
+            }
+            if (wide) {
+                ((uint64_t*)outOffsets)[i] = position;
+            } else {
+                ((uint32_t*)outOffsets)[i] = (uint32_t)position;
+            }
+            memcpy(outData + position, refs[i].bytes, refs[i].length);
+            position += refs[i].length;
+        }
+        if (wide) {
+            ((uint64_t*)outOffsets)[count] = position;
+        } else {
+            ((uint32_t*)outOffsets)[count] = (uint32_t)position;
+        }
+        SORT_STAT_MOVE(count);
+        SORT_STAT_PHASE_END(copyStart, SORT_PHASE_COPY);
+    }
+    return 0;
+}
+
+/**
+ * Sorts a table of strings and returns the row permutation: the i-th string
+ * in sorted order is data[offsets[perm[i]]..offsets[perm[i] + 1]).
+ *
+ * @param data Bytes of all strings
+ * @param offsets count + 1 non-decreasing offsets into data
+ * @param count Number of strings
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ * @param perm Receives the rows in sorted order; equal strings keep ascending rows
+ * @param ws Workspace to take scratch memory from, or NULL for the per-thread workspace
+ * @return 0 on success, -1 with errno set to EINVAL for decreasing offsets
+ *         or more than 2^32 strings, or to ENOMEM
+ */
+int stringTableSort(const unsigned char* data, const uint32_t offsets[], size_t count, bool reverse,
+                    uint32_t perm[], SortWorkspace* ws) {
+    return stringTableSortImpl(data, offsets, false, count, reverse, perm, NULL, NULL, ws);
+}
+
+/**
+ * stringTableSort with 64-bit offsets and permutation.
+ */
+int stringTableSortWide(const unsigned char* data, const uint64_t offsets[], size_t count, bool reverse,
+                        uint64_t perm[], SortWorkspace* ws) {
+    return stringTableSortImpl(data, offsets, true, count, reverse, perm, NULL, NULL, ws);
+}
+
+/**
+ * Sorts a table of strings into a new, compacted table: outData holds the
+ * strings back to back in sorted order and string i of the result is
+ * outData[outOffsets[i]..outOffsets[i + 1]).
+ *
+ * @param data Bytes of all strings
+ * @param offsets count + 1 non-decreasing offsets into data
+ * @param count Number of strings
+ * @param reverse If true, sorts in descending order; if false, in ascending order
+ * @param outData Receives the strings; offsets[count] - offsets[0] bytes at
+ *                most, must not overlap data
+ * @param outOffsets Receives count + 1 offsets into outData, starting at 0
+ * @param ws Workspace to take scratch memory from, or NULL for the per-thread workspace
+ * @return 0 on success, -1 with errno set as for stringTableSort
+ */
+int stringTableSortCompact(const unsigned char* data, const uint32_t offsets[], size_t count, bool reverse,
+                           unsigned char outData[], uint32_t outOffsets[], SortWorkspace* ws) {
+    return stringTableSortImpl(data, offsets, false, count, reverse, NULL, outData, outOffsets, ws);
+}
+
+/**
+ * stringTableSortCompact with 64-bit offsets.
+ */
+int stringTableSortCompactWide(const unsigned char* data, const uint64_t offsets[], size_t count, bool reverse,
+                               unsigned char outData[], uint64_t outOffsets[], SortWorkspace* ws) {
+    return stringTableSortImpl(data, offsets, true, count, reverse, NULL, outData, outOffsets, ws);
+}
+
+#ifdef STRING_TABLE_SORT_MAIN
+
+/**
+ * Prints string i of a table, with embedded NULs shown as \0.
+ */
+static void printTableString(const unsigned char* data, const uint32_t offsets[], size_t i) {
+    putchar('"');
+    for (uint32_t b = offsets[i]; b < offsets[i + 1]; b++) {
+        if (data[b] == 0) {
+            printf("\\0");
+        } else {
+            putchar(data[b]);
+        }
+    }
+    putchar('"');
+}
+
+/**
+ * Main function with examples.
+ */
+int main() {
+    // "pear", "fig", "apple", "fig\0tree", "", "fig", "app"
+    const unsigned char data[] = "pearfigapplefig\0treefigapp";
+    const uint32_t offsets[] = {0, 4, 7, 12, 20, 20, 23, 26};
+    size_t count = 7;
+
+    uint32_t perm[7];
+    stringTableSort(data, offsets, count, false, perm, NULL);
+    printf("Permutation:");
+    for (size_t i = 0; i < count; i++) {
+        printf(" %u", perm[i]);
+    }
+    printf("\n");
+
+    unsigned char sorted[26];
+    uint32_t sortedOffsets[8];
+    stringTableSortCompact(data, offsets, count, true, sorted, sortedOffsets, NULL);
+    printf("Compacted, descending:");
+    for (size_t i = 0; i < count; i++) {
+        printf(" ");
+        printTableString(sorted, sortedOffsets, i);
+    }
+    printf("\n");
+    return 0;
+}
+
+#endif /* STRING_TABLE_SORT_MAIN */
+
+#endif /* STRING_TABLE_SORT_C */